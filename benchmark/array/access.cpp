@@ -0,0 +1,25 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/vector/access.hpp"
+
+#include <immer/array.hpp>
+
+#include <vector>
+
+// clang-format off
+NONIUS_BENCHMARK("std::vector",        benchmark_access_iter_std<std::vector<unsigned>>())
+NONIUS_BENCHMARK("std::vector/idx",    benchmark_access_idx_std<std::vector<unsigned>>())
+NONIUS_BENCHMARK("std::vector/random", benchmark_access_random_std<std::vector<unsigned>>())
+
+NONIUS_BENCHMARK("array",        benchmark_access_iter<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/idx",    benchmark_access_idx<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/random", benchmark_access_random<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/reduce", benchmark_access_reduce<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/UN/idx", benchmark_access_idx<immer::array<unsigned,unsafe_memory>>())
+// clang-format on
@@ -0,0 +1,38 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/vector/assoc.hpp"
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+
+#include <vector>
+
+// clang-format off
+NONIUS_BENCHMARK("std::vector",        benchmark_assoc_std<std::vector<unsigned>>())
+NONIUS_BENCHMARK("std::vector/random", benchmark_assoc_random_std<std::vector<unsigned>>())
+
+NONIUS_BENCHMARK("array",      benchmark_assoc<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/NO",   benchmark_assoc<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("array/UN",   benchmark_assoc<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("array/random",    benchmark_assoc_random<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/NO/random", benchmark_assoc_random<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("array/UN/random", benchmark_assoc_random<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("m/array",    benchmark_assoc_move<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("m/array/NO", benchmark_assoc_move<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("m/array/UN", benchmark_assoc_move<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("t/array",    benchmark_assoc_mut<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("t/array/NO", benchmark_assoc_mut<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("t/array/UN", benchmark_assoc_mut<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("t/array/random",    benchmark_assoc_mut_random<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("t/array/UN/random", benchmark_assoc_mut_random<immer::array<unsigned,unsafe_memory>>())
+// clang-format on
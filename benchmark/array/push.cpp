@@ -0,0 +1,36 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/vector/push.hpp"
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+
+#include <vector>
+
+// clang-format off
+NONIUS_BENCHMARK("std::vector", benchmark_push_mut_std<std::vector<unsigned>>())
+
+NONIUS_BENCHMARK("array",      benchmark_push<immer::array<unsigned,def_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("array/GC",   benchmark_push<immer::array<unsigned,gc_memory>>())
+#endif
+NONIUS_BENCHMARK("array/NO",   benchmark_push<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("array/UN",   benchmark_push<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("m/array",    benchmark_push_move<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("m/array/NO", benchmark_push_move<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("m/array/UN", benchmark_push_move<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("t/array",    benchmark_push_mut<immer::array<unsigned,def_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("t/array/GC", benchmark_push_mut<immer::array<unsigned,gc_memory>>())
+#endif
+NONIUS_BENCHMARK("t/array/NO", benchmark_push_mut<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("t/array/UN", benchmark_push_mut<immer::array<unsigned,unsafe_memory>>())
+// clang-format on
@@ -0,0 +1,122 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/vector/common.hpp"
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+
+#include <vector>
+
+namespace {
+
+struct inc_fn
+{
+    unsigned operator()(unsigned x) const { return x + 1; }
+};
+
+template <typename Vektor>
+auto make_array(std::size_t n)
+{
+    auto v = Vektor{}.transient();
+    for (auto i = 0u; i < n; ++i)
+        v.push_back(i);
+    return v.persistent();
+}
+
+template <typename Vektor>
+auto benchmark_update_std()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = make_generator(n);
+        auto v_ = Vektor(n, 0u);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v[g[i]] = inc_fn{}(v[g[i]]);
+            return v;
+        });
+    };
+}
+
+template <typename Vektor>
+auto benchmark_update()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        if (n > get_limit<Vektor>{})
+            nonius::skip();
+
+        auto g  = make_generator(n);
+        auto v_ = make_array<Vektor>(n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = v.update(g[i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Vektor>
+auto benchmark_update_move()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        if (n > get_limit<Vektor>{})
+            nonius::skip();
+
+        auto g  = make_generator(n);
+        auto v_ = make_array<Vektor>(n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = std::move(v).update(g[i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Vektor>
+auto benchmark_update_mut()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = make_generator(n);
+        auto v_ = make_array<Vektor>(n);
+
+        measure(meter, [&] {
+            auto v = v_.transient();
+            for (auto i = 0u; i < n; ++i)
+                v.update(g[i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("std::vector", benchmark_update_std<std::vector<unsigned>>())
+
+NONIUS_BENCHMARK("array",      benchmark_update<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("array/NO",   benchmark_update<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("array/UN",   benchmark_update<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("m/array",    benchmark_update_move<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("m/array/NO", benchmark_update_move<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("m/array/UN", benchmark_update_move<immer::array<unsigned,unsafe_memory>>())
+
+NONIUS_BENCHMARK("t/array",    benchmark_update_mut<immer::array<unsigned,def_memory>>())
+NONIUS_BENCHMARK("t/array/NO", benchmark_update_mut<immer::array<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("t/array/UN", benchmark_update_mut<immer::array<unsigned,unsafe_memory>>())
+// clang-format on
@@ -0,0 +1,90 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/box/common.hpp"
+
+#include <immer/atom.hpp>
+
+namespace {
+
+template <typename Atom>
+auto benchmark_load()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Atom::value_type;
+        auto n        = meter.param<N>();
+        Atom a{make_value<value_t>{}(42)};
+
+        measure(meter, [&] {
+            auto r = typename Atom::box_type{};
+            for (auto i = 0u; i < n; ++i)
+                r = a.load();
+            return r;
+        });
+    };
+}
+
+template <typename Atom>
+auto benchmark_store()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Atom::value_type;
+        auto n        = meter.param<N>();
+        auto b        = typename Atom::box_type{make_value<value_t>{}(42)};
+        Atom a;
+
+        measure(meter, [&] {
+            for (auto i = 0u; i < n; ++i)
+                a.store(b);
+        });
+    };
+}
+
+template <typename Atom>
+auto benchmark_update()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Atom::value_type;
+        auto n        = meter.param<N>();
+        Atom a{make_value<value_t>{}(42)};
+
+        measure(meter, [&] {
+            for (auto i = 0u; i < n; ++i)
+                a.update(inc_fn{});
+        });
+    };
+}
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("load/atom",      benchmark_load<immer::atom<unsigned,def_memory>>())
+NONIUS_BENCHMARK("load/atom/NO",   benchmark_load<immer::atom<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("load/atom/UN",   benchmark_load<immer::atom<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("load/atom/IN",   benchmark_load<immer::atom<unsigned,inline_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("load/atom/GC",   benchmark_load<immer::atom<unsigned,gc_memory>>())
+#endif
+
+NONIUS_BENCHMARK("store/atom",     benchmark_store<immer::atom<unsigned,def_memory>>())
+NONIUS_BENCHMARK("store/atom/NO",  benchmark_store<immer::atom<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("store/atom/UN",  benchmark_store<immer::atom<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("store/atom/IN",  benchmark_store<immer::atom<unsigned,inline_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("store/atom/GC",  benchmark_store<immer::atom<unsigned,gc_memory>>())
+#endif
+
+NONIUS_BENCHMARK("update/atom",    benchmark_update<immer::atom<unsigned,def_memory>>())
+NONIUS_BENCHMARK("update/atom/NO", benchmark_update<immer::atom<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("update/atom/UN", benchmark_update<immer::atom<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("update/atom/IN", benchmark_update<immer::atom<unsigned,inline_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("update/atom/GC", benchmark_update<immer::atom<unsigned,gc_memory>>())
+#endif
+NONIUS_BENCHMARK("update/atom_s",  benchmark_update<immer::atom<std::string,def_memory>>())
+// clang-format on
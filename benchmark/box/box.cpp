@@ -0,0 +1,109 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/box/common.hpp"
+
+#include <vector>
+
+namespace {
+
+template <typename Box>
+auto benchmark_make()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Box::value_type;
+        auto n        = meter.param<N>();
+        auto vs       = std::vector<Box>(n);
+
+        measure(meter, [&] {
+            for (auto i = 0u; i < n; ++i)
+                vs[i] = Box{make_value<value_t>{}(i)};
+            return vs.back();
+        });
+    };
+}
+
+template <typename Box>
+auto benchmark_copy()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Box::value_type;
+        auto n        = meter.param<N>();
+        auto v        = Box{make_value<value_t>{}(42)};
+        auto vs       = std::vector<Box>(n);
+
+        measure(meter, [&] {
+            for (auto i = 0u; i < n; ++i)
+                vs[i] = v;
+            return vs.back();
+        });
+    };
+}
+
+template <typename Box>
+auto benchmark_update()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Box::value_type;
+        auto n        = meter.param<N>();
+        auto v_       = Box{make_value<value_t>{}(42)};
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = v.update(inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Box>
+auto benchmark_update_move()
+{
+    return [](nonius::chronometer meter) {
+        using value_t = typename Box::value_type;
+        auto n        = meter.param<N>();
+        auto v_       = Box{make_value<value_t>{}(42)};
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = std::move(v).update(inc_fn{});
+            return v;
+        });
+    };
+}
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("make/box",        benchmark_make<immer::box<unsigned,def_memory>>())
+NONIUS_BENCHMARK("make/box/NO",     benchmark_make<immer::box<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("make/box/UN",     benchmark_make<immer::box<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("make/box/IN",     benchmark_make<immer::box<unsigned,inline_memory>>())
+NONIUS_BENCHMARK("make/box_s",      benchmark_make<immer::box<std::string,def_memory>>())
+NONIUS_BENCHMARK("make/box_s/UN",   benchmark_make<immer::box<std::string,unsafe_memory>>())
+
+NONIUS_BENCHMARK("copy/box",        benchmark_copy<immer::box<unsigned,def_memory>>())
+NONIUS_BENCHMARK("copy/box/NO",     benchmark_copy<immer::box<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("copy/box/UN",     benchmark_copy<immer::box<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("copy/box/IN",     benchmark_copy<immer::box<unsigned,inline_memory>>())
+
+NONIUS_BENCHMARK("update/box",      benchmark_update<immer::box<unsigned,def_memory>>())
+NONIUS_BENCHMARK("update/box/NO",   benchmark_update<immer::box<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("update/box/UN",   benchmark_update<immer::box<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("update/box/IN",   benchmark_update<immer::box<unsigned,inline_memory>>())
+NONIUS_BENCHMARK("update/box_s",    benchmark_update<immer::box<std::string,def_memory>>())
+NONIUS_BENCHMARK("update/box_s/UN", benchmark_update<immer::box<std::string,unsafe_memory>>())
+
+NONIUS_BENCHMARK("m/update/box",      benchmark_update_move<immer::box<unsigned,def_memory>>())
+NONIUS_BENCHMARK("m/update/box/NO",   benchmark_update_move<immer::box<unsigned,basic_memory>>())
+NONIUS_BENCHMARK("m/update/box/UN",   benchmark_update_move<immer::box<unsigned,unsafe_memory>>())
+NONIUS_BENCHMARK("m/update/box_s",    benchmark_update_move<immer::box<std::string,def_memory>>())
+NONIUS_BENCHMARK("m/update/box_s/UN", benchmark_update_move<immer::box<std::string,unsafe_memory>>())
+// clang-format on
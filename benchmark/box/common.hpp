@@ -0,0 +1,57 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/config.hpp"
+
+#include <immer/box.hpp>
+
+#include <string>
+
+namespace {
+
+using inline_memory = immer::memory_policy<
+    immer::default_heap_policy,
+    immer::default_refcount_policy,
+    immer::default_lock_policy,
+    immer::get_transience_policy_t<immer::default_refcount_policy>,
+    immer::get_prefer_fewer_bigger_objects_v<immer::default_heap_policy>,
+    immer::get_use_transient_rvalues_v<immer::default_refcount_policy>,
+    true>;
+
+struct inc_fn
+{
+    unsigned operator()(unsigned x) const { return x + 1; }
+    std::string operator()(std::string x) const
+    {
+        x.back() = x.back() == 'z' ? 'a' : x.back() + 1;
+        return x;
+    }
+};
+
+template <typename T>
+struct make_value;
+
+template <>
+struct make_value<unsigned>
+{
+    unsigned operator()(unsigned i) const { return i; }
+};
+
+template <>
+struct make_value<std::string>
+{
+    std::string operator()(unsigned i) const
+    {
+        return "a somewhat long string, so it is not inlined " +
+               std::to_string(i);
+    }
+};
+
+} // namespace
@@ -0,0 +1,118 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/concurrent/common.hpp"
+
+#include <immer/atom.hpp>
+#include <immer/vector.hpp>
+
+namespace {
+
+template <typename T>
+struct value_traits
+{
+    static T make(std::size_t) { return T{}; }
+    static T update(T x, std::size_t) { return x + 1; }
+    static std::size_t read(const T& x) { return x; }
+};
+
+template <typename T, typename MP>
+struct value_traits<immer::vector<T, MP>>
+{
+    using vector_t = immer::vector<T, MP>;
+
+    static vector_t make(std::size_t n) { return vector_t(n, T{}); }
+
+    static vector_t update(vector_t v, std::size_t i)
+    {
+        return std::move(v).update(i % v.size(), [](auto x) { return x + 1; });
+    }
+
+    static std::size_t read(const vector_t& v) { return v[v.size() / 2]; }
+};
+
+template <typename Atom>
+auto benchmark_load()
+{
+    return [](nonius::chronometer meter) {
+        using traits = value_traits<typename Atom::value_type>;
+        auto n       = meter.param<N>();
+        Atom a{traits::make(n)};
+
+        measure_concurrent(meter, [&](std::size_t, std::size_t) {
+            auto r = std::size_t{};
+            for (auto i = 0u; i < n; ++i)
+                r += traits::read(a.load().get());
+            nonius::keep_memory(&r);
+        });
+    };
+}
+
+template <typename Atom>
+auto benchmark_update()
+{
+    return [](nonius::chronometer meter) {
+        using traits = value_traits<typename Atom::value_type>;
+        auto n       = meter.param<N>();
+        Atom a{traits::make(n)};
+
+        measure_concurrent(meter, [&](std::size_t, std::size_t) {
+            for (auto i = 0u; i < n; ++i)
+                a.update([&](auto x) { return traits::update(x, i); });
+        });
+    };
+}
+
+// Thread 0 writes while all the others read, the typical usage of an
+// atom holding the state of an application.
+template <typename Atom>
+auto benchmark_mixed()
+{
+    return [](nonius::chronometer meter) {
+        using traits = value_traits<typename Atom::value_type>;
+        auto n       = meter.param<N>();
+        Atom a{traits::make(n)};
+
+        measure_concurrent(meter, [&](std::size_t t, std::size_t) {
+            if (t == 0) {
+                for (auto i = 0u; i < n; ++i)
+                    a.update([&](auto x) { return traits::update(x, i); });
+            } else {
+                auto r = std::size_t{};
+                for (auto i = 0u; i < n; ++i)
+                    r += traits::read(a.load().get());
+                nonius::keep_memory(&r);
+            }
+        });
+    };
+}
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("load/atom",             benchmark_load<immer::atom<unsigned, safe_memory>>())
+NONIUS_BENCHMARK("load/atom/NO",          benchmark_load<immer::atom<unsigned, basic_memory>>())
+NONIUS_BENCHMARK("load/atom/vector",      benchmark_load<immer::atom<immer::vector<unsigned, safe_memory>, safe_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("load/atom/GC",          benchmark_load<immer::atom<unsigned, gc_memory>>())
+#endif
+
+NONIUS_BENCHMARK("update/atom",           benchmark_update<immer::atom<unsigned, safe_memory>>())
+NONIUS_BENCHMARK("update/atom/NO",        benchmark_update<immer::atom<unsigned, basic_memory>>())
+NONIUS_BENCHMARK("update/atom/vector",    benchmark_update<immer::atom<immer::vector<unsigned, safe_memory>, safe_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("update/atom/GC",        benchmark_update<immer::atom<unsigned, gc_memory>>())
+#endif
+
+NONIUS_BENCHMARK("mixed/atom",            benchmark_mixed<immer::atom<unsigned, safe_memory>>())
+NONIUS_BENCHMARK("mixed/atom/NO",         benchmark_mixed<immer::atom<unsigned, basic_memory>>())
+NONIUS_BENCHMARK("mixed/atom/vector",     benchmark_mixed<immer::atom<immer::vector<unsigned, safe_memory>, safe_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("mixed/atom/GC",         benchmark_mixed<immer::atom<unsigned, gc_memory>>())
+#endif
+// clang-format on
@@ -0,0 +1,114 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/*!
+ * Number of threads that run the benchmark concurrently.  Scale it
+ * with nonius' parameter runs, for example `-p T:*:1:2:7` measures
+ * with 1, 2, 4, ... 64 threads.  Every thread performs `N` operations
+ * per iteration, so the throughput of a run is `T * N / mean`.
+ */
+NONIUS_PARAM(T, std::size_t{1})
+
+/*!
+ * Runs a function concurrently on a fixed set of threads.  The
+ * threads are created once and wait spinning between iterations, such
+ * that thread creation and wake-up latency stays out of the
+ * measurement.  The calling thread takes part as thread number 0.
+ */
+class thread_team
+{
+public:
+    using work_t = std::function<void(std::size_t thread, std::size_t iter)>;
+
+    explicit thread_team(std::size_t n)
+        : size_{n == 0 ? 1 : n}
+    {
+        for (auto i = std::size_t{1}; i < size_; ++i)
+            threads_.emplace_back([this, i] { worker(i); });
+    }
+
+    ~thread_team()
+    {
+        stop_.store(true, std::memory_order_release);
+        generation_.fetch_add(1, std::memory_order_release);
+        for (auto& t : threads_)
+            t.join();
+    }
+
+    thread_team(const thread_team&) = delete;
+    thread_team& operator=(const thread_team&) = delete;
+
+    std::size_t size() const { return size_; }
+
+    /*!
+     * Runs `fn(thread, iter)` on every thread of the team and returns
+     * when all of them are done.  `iter` counts the calls to `run`.
+     */
+    void run(const work_t& fn)
+    {
+        work_    = &fn;
+        pending_.store(size_ - 1, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);
+        fn(0, iter_);
+        while (pending_.load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+        ++iter_;
+    }
+
+private:
+    void worker(std::size_t i)
+    {
+        auto seen = std::size_t{};
+        while (true) {
+            auto g = generation_.load(std::memory_order_acquire);
+            if (g == seen) {
+                std::this_thread::yield();
+                continue;
+            }
+            seen = g;
+            if (stop_.load(std::memory_order_acquire))
+                return;
+            (*work_)(i, iter_);
+            pending_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    std::size_t size_;
+    std::size_t iter_ = 0;
+    const work_t* work_ = nullptr;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> generation_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<bool> stop_{false};
+};
+
+/*!
+ * Measures `fn(thread, iter)` running on `meter.param<T>()` threads.
+ * Each sample is the time it takes for the slowest thread to finish.
+ */
+template <typename Fn>
+void measure_concurrent(nonius::chronometer& meter, Fn&& fn)
+{
+    thread_team team{meter.param<T>()};
+    auto work = thread_team::work_t{std::forward<Fn>(fn)};
+    measure(meter, [&] { team.run(work); });
+}
+
+} // namespace
@@ -0,0 +1,103 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/concurrent/common.hpp"
+
+#include <immer/heap/free_list_heap.hpp>
+#include <immer/heap/split_heap.hpp>
+#include <immer/vector.hpp>
+
+#include <array>
+
+namespace {
+
+// Like immer::free_list_heap_policy but without the thread_local free
+// list in front, such that every allocation and deallocation hits the
+// compare-and-swap on the head of the global free list.
+template <typename Heap, std::size_t Limit = immer::default_free_list_size>
+struct global_free_list_heap_policy
+{
+    using type = immer::debug_size_heap<Heap>;
+
+    template <std::size_t Size>
+    struct optimized
+    {
+        using type = immer::split_heap<
+            Size,
+            immer::with_free_list_node<immer::free_list_heap<
+                Size,
+                Limit,
+                immer::debug_size_heap<Heap>>>,
+            immer::debug_size_heap<Heap>>;
+    };
+};
+
+using global_memory =
+    immer::memory_policy<global_free_list_heap_policy<immer::cpp_heap>,
+                         immer::refcount_policy,
+                         immer::default_lock_policy>;
+
+template <typename Vector>
+Vector make_vector(std::size_t n)
+{
+    auto v = Vector{};
+    for (auto i = 0u; i < n; ++i)
+        v = std::move(v).push_back(i);
+    return v;
+}
+
+// Every thread builds and drops its own vectors.
+template <typename Vector>
+auto benchmark_alloc_local()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+
+        measure_concurrent(meter, [&](std::size_t, std::size_t) {
+            auto v = make_vector<Vector>(n);
+            nonius::keep_memory(&v);
+        });
+    };
+}
+
+// Every thread drops the vector that its neighbour built on the
+// previous iteration and then builds a new one, such that nodes are
+// always freed on a different thread than the one that allocated them.
+template <typename Vector>
+auto benchmark_alloc_remote()
+{
+    return [](nonius::chronometer meter) {
+        auto n     = meter.param<N>();
+        auto t     = meter.param<T>();
+        auto slots = std::array<std::vector<Vector>, 2>{
+            {std::vector<Vector>(t), std::vector<Vector>(t)}};
+
+        measure_concurrent(meter, [&](std::size_t i, std::size_t iter) {
+            slots[(iter + 1) % 2][(i + 1) % t] = Vector{};
+            slots[iter % 2][i]                 = make_vector<Vector>(n);
+        });
+    };
+}
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("local/free-list",   benchmark_alloc_local<immer::vector<unsigned, safe_memory>>())
+NONIUS_BENCHMARK("local/global-list", benchmark_alloc_local<immer::vector<unsigned, global_memory>>())
+NONIUS_BENCHMARK("local/malloc",      benchmark_alloc_local<immer::vector<unsigned, basic_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("local/GC",          benchmark_alloc_local<immer::vector<unsigned, gc_memory>>())
+#endif
+
+NONIUS_BENCHMARK("remote/free-list",   benchmark_alloc_remote<immer::vector<unsigned, safe_memory>>())
+NONIUS_BENCHMARK("remote/global-list", benchmark_alloc_remote<immer::vector<unsigned, global_memory>>())
+NONIUS_BENCHMARK("remote/malloc",      benchmark_alloc_remote<immer::vector<unsigned, basic_memory>>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("remote/GC",          benchmark_alloc_remote<immer::vector<unsigned, gc_memory>>())
+#endif
+// clang-format on
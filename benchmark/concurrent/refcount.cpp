@@ -0,0 +1,136 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/concurrent/common.hpp"
+
+#include <immer/box.hpp>
+#include <immer/map.hpp>
+#include <immer/vector.hpp>
+
+namespace {
+
+template <typename T>
+struct make_container;
+
+template <typename T, typename MP, immer::detail::rbts::bits_t B,
+          immer::detail::rbts::bits_t BL>
+struct make_container<immer::vector<T, MP, B, BL>>
+{
+    auto operator()(std::size_t n) const
+    {
+        auto v = immer::vector<T, MP, B, BL>{};
+        for (auto i = 0u; i < n; ++i)
+            v = std::move(v).push_back(i);
+        return v;
+    }
+};
+
+template <typename K, typename V, typename H, typename E, typename MP,
+          immer::detail::hamts::bits_t B>
+struct make_container<immer::map<K, V, H, E, MP, B>>
+{
+    auto operator()(std::size_t n) const
+    {
+        auto v = immer::map<K, V, H, E, MP, B>{};
+        for (auto i = 0u; i < n; ++i)
+            v = std::move(v).set(i, i);
+        return v;
+    }
+};
+
+template <typename T, typename MP>
+struct make_container<immer::box<T, MP>>
+{
+    auto operator()(std::size_t n) const { return immer::box<T, MP>{n}; }
+};
+
+// All threads copy and drop the same container, such that the
+// reference count of its root bounces between the cores.
+template <typename Container>
+auto benchmark_copy_shared()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        auto v = make_container<Container>{}(n);
+
+        measure_concurrent(meter, [&](std::size_t, std::size_t) {
+            for (auto i = 0u; i < n; ++i) {
+                auto c = v;
+                nonius::keep_memory(&c);
+            }
+        });
+    };
+}
+
+// Every thread copies and drops its own container, as a baseline
+// without contention.
+template <typename Container>
+auto benchmark_copy_private()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto vs = std::vector<Container>{};
+        for (auto t = 0u; t < meter.param<T>(); ++t)
+            vs.push_back(make_container<Container>{}(n));
+
+        measure_concurrent(meter, [&](std::size_t t, std::size_t) {
+            auto& v = vs[t];
+            for (auto i = 0u; i < n; ++i) {
+                auto c = v;
+                nonius::keep_memory(&c);
+            }
+        });
+    };
+}
+
+// All threads take turns updating copies of the same container, which
+// contends on the reference counts of every inner node on the path.
+template <typename Container>
+auto benchmark_update_shared()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        auto v = make_container<Container>{}(n);
+
+        measure_concurrent(meter, [&](std::size_t t, std::size_t) {
+            for (auto i = 0u; i < n; ++i) {
+                auto c = v.set((i + t) % n, i);
+                nonius::keep_memory(&c);
+            }
+        });
+    };
+}
+
+using def_vector = immer::vector<unsigned, safe_memory>;
+using basic_vector = immer::vector<unsigned, basic_memory>;
+using def_map = immer::map<unsigned, unsigned, std::hash<unsigned>,
+                           std::equal_to<unsigned>, safe_memory>;
+using basic_map = immer::map<unsigned, unsigned, std::hash<unsigned>,
+                             std::equal_to<unsigned>, basic_memory>;
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("copy/shared/box",         benchmark_copy_shared<immer::box<std::size_t, safe_memory>>())
+NONIUS_BENCHMARK("copy/private/box",        benchmark_copy_private<immer::box<std::size_t, safe_memory>>())
+NONIUS_BENCHMARK("copy/shared/vector",      benchmark_copy_shared<def_vector>())
+NONIUS_BENCHMARK("copy/private/vector",     benchmark_copy_private<def_vector>())
+NONIUS_BENCHMARK("copy/shared/map",         benchmark_copy_shared<def_map>())
+NONIUS_BENCHMARK("copy/private/map",        benchmark_copy_private<def_map>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("copy/shared/vector/GC",   benchmark_copy_shared<immer::vector<unsigned, gc_memory>>())
+#endif
+
+NONIUS_BENCHMARK("update/shared/vector",    benchmark_update_shared<def_vector>())
+NONIUS_BENCHMARK("update/shared/vector/NO", benchmark_update_shared<basic_vector>())
+NONIUS_BENCHMARK("update/shared/map",       benchmark_update_shared<def_map>())
+NONIUS_BENCHMARK("update/shared/map/NO",    benchmark_update_shared<basic_map>())
+#if IMMER_BENCHMARK_GC
+NONIUS_BENCHMARK("update/shared/vector/GC", benchmark_update_shared<immer::vector<unsigned, gc_memory>>())
+#endif
+// clang-format on
@@ -10,9 +10,20 @@
 
 #include <nonius.h++>
 
-#include <immer/heap/gc_heap.hpp>
+#include "benchmark/json_reporter.hpp"
+#include "benchmark/metrics.hpp"
+
+#include <immer/heap/counting_heap.hpp>
 #include <immer/memory_policy.hpp>
 
+#include <algorithm>
+
+#if IMMER_BENCHMARK_GC
+#include <immer/heap/gc_heap.hpp>
+#elif !defined(DISABLE_GC_BENCHMARKS)
+#define DISABLE_GC_BENCHMARKS
+#endif
+
 namespace {
 
 NONIUS_PARAM(N, std::size_t{1000})
@@ -21,15 +32,17 @@ struct gc_disable
 {
     gc_disable()
     {
+#if IMMER_BENCHMARK_GC
 #if IMMER_BENCHMARK_DISABLE_GC
         GC_disable();
 #else
         GC_gcollect();
+#endif
 #endif
     }
     ~gc_disable()
     {
-#if IMMER_BENCHMARK_DISABLE_GC
+#if IMMER_BENCHMARK_GC && IMMER_BENCHMARK_DISABLE_GC
         GC_enable();
         GC_gcollect();
 #endif
@@ -38,32 +51,180 @@ struct gc_disable
     gc_disable(gc_disable&&)      = delete;
 };
 
+// Every node requested by the containers that use the memory policies
+// below is counted with this tag, including the ones that are served
+// by a free list.  `measure()` reports them for every result.
+struct node_count_tag
+{};
+
+using node_counter_t = immer::counting_heap<immer::cpp_heap, node_count_tag>;
+
+template <typename HeapPolicy>
+struct node_counting_heap_policy
+{
+    using type =
+        immer::counting_heap<typename HeapPolicy::type, node_count_tag>;
+
+    template <std::size_t Size>
+    struct optimized
+    {
+        using type = immer::counting_heap<
+            typename HeapPolicy::template optimized<Size>::type,
+            node_count_tag>;
+    };
+};
+
+template <typename Fn>
+auto invoke_run(Fn& fn, int run, int) -> decltype(fn(run))
+{
+    return fn(run);
+}
+
+template <typename Fn>
+auto invoke_run(Fn& fn, int, long) -> decltype(fn())
+{
+    return fn();
+}
+
+// Measures the live bytes allocated from its construction until its
+// destruction, such that it also sees the result of the run when it
+// is declared before the return statement.
+struct retained_meter
+{
+    bool active;
+    std::size_t& retained;
+    immer::heap_counters before =
+        active ? node_counter_t::counters() : immer::heap_counters{};
+
+    ~retained_meter()
+    {
+        if (active)
+            retained = (node_counter_t::counters() - before).live_bytes();
+    }
+};
+
+/*!
+ * Measures the time of `fn`, reporting also the nodes allocated per
+ * element, as `allocs/op` and `bytes/op`, and the bytes retained by
+ * the result of a run per element, as `bytes/element`.  Only the
+ * containers that use the memory policies defined here are counted,
+ * those from other libraries always report zero.
+ */
 template <typename Meter, typename Fn>
 void measure(Meter& m, Fn&& fn)
+{
+    gc_disable guard;
+    auto runs     = std::size_t{};
+    auto retained = std::size_t{};
+    auto before   = node_counter_t::counters();
+    m.measure([&](int run) {
+        auto r = retained_meter{runs++ == 0, retained};
+        return invoke_run(fn, run, 0);
+    });
+    auto c   = node_counter_t::counters() - before;
+    auto n   = std::max(m.template param<N>(), std::size_t{1});
+    auto ops = static_cast<double>(std::max(runs, std::size_t{1}) * n);
+    report_metric("allocs/op", c.allocations / ops);
+    report_metric("bytes/op", c.bytes_allocated / ops);
+    report_metric("bytes/element", retained / static_cast<double>(n));
+}
+
+/*!
+ * Like `measure()`, but it only measures the time.
+ */
+template <typename Meter, typename Fn>
+void measure_time(Meter& m, Fn&& fn)
 {
     gc_disable guard;
     return m.measure(std::forward<Fn>(fn));
 }
 
-using def_memory   = immer::default_memory_policy;
-using gc_memory    = immer::memory_policy<immer::heap_policy<immer::gc_heap>,
-                                       immer::no_refcount_policy,
-                                       immer::default_lock_policy>;
-using gcf_memory   = immer::memory_policy<immer::heap_policy<immer::gc_heap>,
-                                        immer::no_refcount_policy,
-                                        immer::default_lock_policy,
-                                        immer::gc_transience_policy,
-                                        false>;
-using basic_memory = immer::memory_policy<immer::heap_policy<immer::cpp_heap>,
-                                          immer::refcount_policy,
-                                          immer::default_lock_policy>;
-using safe_memory =
-    immer::memory_policy<immer::free_list_heap_policy<immer::cpp_heap>,
+using def_memory = immer::memory_policy<
+    node_counting_heap_policy<immer::default_heap_policy>,
+    immer::default_refcount_policy,
+    immer::default_lock_policy>;
+
+#if IMMER_BENCHMARK_GC
+using gc_memory =
+    immer::memory_policy<node_counting_heap_policy<
+                             immer::heap_policy<immer::gc_heap>>,
+                         immer::no_refcount_policy,
+                         immer::default_lock_policy>;
+using gcf_memory =
+    immer::memory_policy<node_counting_heap_policy<
+                             immer::heap_policy<immer::gc_heap>>,
+                         immer::no_refcount_policy,
+                         immer::default_lock_policy,
+                         immer::gc_transience_policy,
+                         false>;
+#endif
+
+using basic_memory = immer::memory_policy<
+    node_counting_heap_policy<immer::heap_policy<immer::cpp_heap>>,
+    immer::refcount_policy,
+    immer::default_lock_policy>;
+using safe_memory = immer::memory_policy<
+    node_counting_heap_policy<immer::free_list_heap_policy<immer::cpp_heap>>,
+    immer::refcount_policy,
+    immer::default_lock_policy>;
+using unsafe_memory = immer::memory_policy<
+    node_counting_heap_policy<
+        immer::unsafe_free_list_heap_policy<immer::cpp_heap>>,
+    immer::unsafe_refcount_policy,
+    immer::default_lock_policy>;
+
+// The counting policies have the same structure as the ones above, but
+// count the allocations that reach the C++ heap.  Use them together
+// with `measure_counting()` and `report_footprint()`.
+using counting_heap_t = immer::counting_heap<immer::cpp_heap>;
+using counting_basic_memory =
+    immer::memory_policy<immer::heap_policy<counting_heap_t>,
                          immer::refcount_policy,
                          immer::default_lock_policy>;
-using unsafe_memory =
-    immer::memory_policy<immer::unsafe_free_list_heap_policy<immer::cpp_heap>,
+using counting_safe_memory =
+    immer::memory_policy<immer::free_list_heap_policy<counting_heap_t>,
+                         immer::refcount_policy,
+                         immer::default_lock_policy>;
+using counting_unsafe_memory =
+    immer::memory_policy<immer::unsafe_free_list_heap_policy<counting_heap_t>,
                          immer::unsafe_refcount_policy,
                          immer::default_lock_policy>;
 
+/*!
+ * Like `measure()`, but also reports the allocations per operation and
+ * the bytes allocated per operation, given that every call to `fn`
+ * performs `ops` operations.
+ */
+template <typename Heap = counting_heap_t, typename Meter, typename Fn>
+void measure_counting(Meter& m, std::size_t ops, Fn&& fn)
+{
+    auto runs   = std::size_t{};
+    auto before = Heap::counters();
+    measure_time(m, [&] {
+        ++runs;
+        return fn();
+    });
+    auto c     = Heap::counters() - before;
+    auto total = static_cast<double>(std::max(runs * ops, std::size_t{1}));
+    report_metric("allocs/op", c.allocations / total);
+    report_metric("bytes/op", c.bytes_allocated / total);
+}
+
+/*!
+ * Reports the bytes and allocations retained per element by the
+ * container of `n` elements returned by `make`.  Nodes served from a
+ * free list are not seen by the heap, so use a policy without free
+ * lists, like `counting_basic_memory`, to get accurate results.
+ */
+template <typename Heap = counting_heap_t, typename Fn>
+void report_footprint(std::size_t n, Fn&& make)
+{
+    auto before = Heap::counters();
+    auto v      = make();
+    auto c      = Heap::counters() - before;
+    auto total  = static_cast<double>(std::max(n, std::size_t{1}));
+    report_metric("bytes/element", c.live_bytes() / total);
+    report_metric("allocs/element", c.live_allocations() / total);
+}
+
 } // anonymous namespace
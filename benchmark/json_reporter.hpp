@@ -0,0 +1,273 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/metrics.hpp"
+
+#include <nonius.h++>
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*!
+ * Nonius reporter that writes the results as a JSON document, such
+ * that they can be processed by scripts that compare benchmark runs.
+ * The document looks like:
+ *
+ *     { "title": "...", "samples": 20, "confidence_interval": 0.95,
+ *       "runs": [ { "params": { "N": "1000" },
+ *                   "benchmarks": [ { "name": "...",
+ *                                     "mean": { "point": ...,
+ *                                               "lower_bound": ...,
+ *                                               "upper_bound": ... },
+ *                                     "standard_deviation": { ... },
+ *                                     "outlier_variance": ...,
+ *                                     "percentiles": { "50": ...,
+ *                                                      "90": ...,
+ *                                                      "99": ...,
+ *                                                      "max": ... },
+ *                                     "samples": [ ... ],
+ *                                     "metrics": { ... } } ] } ] }
+ *
+ * All durations are in seconds.  The percentiles describe the tail of
+ * the distribution of samples, which the mean hides.  Benchmarks that
+ * failed have an `"error"` member instead of the results.  The
+ * `"metrics"` are only present when the benchmark reported some via
+ * `report_metric()`, like the allocation counts of `measure_counting()`.
+ */
+struct json_reporter : nonius::reporter
+{
+private:
+    struct result
+    {
+        std::string name;
+        nonius::sample_analysis<nonius::fp_seconds> analysis;
+        std::string error;
+        bool failed = false;
+        std::map<std::string, double> metrics;
+    };
+
+    struct run
+    {
+        std::map<std::string, std::string> params;
+        std::vector<result> results;
+    };
+
+    std::string description() override
+    {
+        return "outputs results to a JSON file";
+    }
+
+    void do_configure(nonius::configuration& cfg) override
+    {
+        n_samples           = cfg.samples;
+        confidence_interval = cfg.confidence_interval;
+        resamples           = cfg.resamples;
+        verbose             = cfg.verbose;
+        title               = cfg.title;
+    }
+
+    void do_warmup_start() override
+    {
+        if (verbose)
+            progress_stream() << "warming up\n";
+    }
+
+    void do_params_start(nonius::parameters const& params) override
+    {
+        if (verbose)
+            progress_stream() << "\n\nnew parameter round\n" << params;
+        runs.emplace_back();
+        for (auto&& p : params) {
+            auto ss = std::ostringstream{};
+            ss << p.second;
+            runs.back().params[p.first] = ss.str();
+        }
+    }
+
+    void do_benchmark_start(std::string const& name) override
+    {
+        if (verbose)
+            progress_stream() << "\nbenchmarking " << name << "\n";
+        runs.back().results.push_back({name, {}, {}, false, {}});
+        benchmark_metrics().clear();
+    }
+
+    void do_analysis_complete(
+        nonius::sample_analysis<nonius::fp_seconds> const& analysis) override
+    {
+        runs.back().results.back().analysis = analysis;
+        runs.back().results.back().metrics  = benchmark_metrics();
+    }
+
+    void do_benchmark_failure(std::exception_ptr e) override
+    {
+        auto& r  = runs.back().results.back();
+        r.failed = true;
+        try {
+            std::rethrow_exception(e);
+        } catch (std::exception const& ex) {
+            r.error = ex.what();
+        } catch (...) {
+            r.error = "unknown error";
+        }
+        error_stream() << r.name << " failed to run successfully\n";
+    }
+
+    void do_suite_complete() override
+    {
+        if (verbose)
+            progress_stream() << "\ngenerating JSON report\n";
+
+        auto& os = report_stream();
+        os.precision(std::numeric_limits<double>::digits10);
+        os << "{\n"
+           << "  \"title\": " << quote(title) << ",\n"
+           << "  \"samples\": " << n_samples << ",\n"
+           << "  \"confidence_interval\": " << confidence_interval << ",\n"
+           << "  \"resamples\": " << resamples << ",\n"
+           << "  \"runs\": [";
+        auto first_run = true;
+        for (auto&& run : runs) {
+            os << (first_run ? "\n" : ",\n") << "    {\n"
+               << "      \"params\": {";
+            auto first_param = true;
+            for (auto&& p : run.params) {
+                os << (first_param ? "" : ", ") << quote(p.first) << ": "
+                   << quote(p.second);
+                first_param = false;
+            }
+            os << "},\n"
+               << "      \"benchmarks\": [";
+            auto first_result = true;
+            for (auto&& r : run.results) {
+                os << (first_result ? "\n" : ",\n") << "        {"
+                   << "\"name\": " << quote(r.name);
+                if (r.failed)
+                    os << ", \"error\": " << quote(r.error);
+                else {
+                    write_analysis(os, r.analysis);
+                    write_metrics(os, r.metrics);
+                }
+                os << "}";
+                first_result = false;
+            }
+            os << "\n      ]\n"
+               << "    }";
+            first_run = false;
+        }
+        os << "\n  ]\n"
+           << "}\n"
+           << std::flush;
+
+        if (verbose)
+            progress_stream() << "done\n";
+    }
+
+    static void
+    write_analysis(std::ostream& os,
+                   nonius::sample_analysis<nonius::fp_seconds> const& a)
+    {
+        auto write_estimate =
+            [&](const char* name,
+                nonius::estimate<nonius::fp_seconds> const& e) {
+                os << ", " << quote(name) << ": {"
+                   << "\"point\": " << e.point.count() << ", "
+                   << "\"lower_bound\": " << e.lower_bound.count() << ", "
+                   << "\"upper_bound\": " << e.upper_bound.count() << "}";
+            };
+        write_estimate("mean", a.mean);
+        write_estimate("standard_deviation", a.standard_deviation);
+        os << ", \"outlier_variance\": " << a.outlier_variance;
+        if (!a.samples.empty()) {
+            auto sorted = std::vector<double>{};
+            for (auto&& s : a.samples)
+                sorted.push_back(s.count());
+            std::sort(sorted.begin(), sorted.end());
+            auto percentile = [&](double p) {
+                auto idx = static_cast<std::size_t>(p * (sorted.size() - 1));
+                return sorted[idx];
+            };
+            os << ", \"percentiles\": {"
+               << "\"50\": " << percentile(0.5) << ", "
+               << "\"90\": " << percentile(0.9) << ", "
+               << "\"99\": " << percentile(0.99) << ", "
+               << "\"max\": " << sorted.back() << "}";
+        }
+        os << ", \"samples\": [";
+        auto first = true;
+        for (auto&& s : a.samples) {
+            os << (first ? "" : ", ") << s.count();
+            first = false;
+        }
+        os << "]";
+    }
+
+    static void write_metrics(std::ostream& os,
+                              std::map<std::string, double> const& metrics)
+    {
+        if (metrics.empty())
+            return;
+        os << ", \"metrics\": {";
+        auto first = true;
+        for (auto&& m : metrics) {
+            os << (first ? "" : ", ") << quote(m.first) << ": " << m.second;
+            first = false;
+        }
+        os << "}";
+    }
+
+    static std::string quote(std::string const& s)
+    {
+        auto r = std::string{"\""};
+        for (auto c : s) {
+            switch (c) {
+            case '"':
+                r += "\\\"";
+                break;
+            case '\\':
+                r += "\\\\";
+                break;
+            case '\n':
+                r += "\\n";
+                break;
+            case '\t':
+                r += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    r += buf;
+                } else
+                    r += c;
+            }
+        }
+        return r + "\"";
+    }
+
+    int n_samples              = 0;
+    double confidence_interval = 0;
+    int resamples              = 0;
+    bool verbose               = false;
+    std::string title;
+    std::vector<run> runs;
+};
+
+} // anonymous namespace
+
+NONIUS_REPORTER("json", json_reporter);
@@ -0,0 +1,65 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/config.hpp"
+
+#include <immer/map_transient.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+template <typename T = unsigned>
+auto make_generator_ranged(std::size_t runs)
+{
+    assert(runs > 0);
+    auto engine = std::default_random_engine{13};
+    auto dist   = std::uniform_int_distribution<T>{0, (T) runs - 1};
+    auto r      = std::vector<T>(runs);
+    std::generate_n(r.begin(), runs, std::bind(dist, engine));
+    return r;
+}
+
+// Builds a standard map-like container associating the first `n` keys
+// in `g` to their index.
+template <typename Map, typename Keys>
+auto make_map_std(const Keys& g, std::size_t n)
+{
+    auto v = Map{};
+    for (auto i = 0u; i < n; ++i)
+        v[g[i]] = i;
+    return v;
+}
+
+// Builds an immer map-like container associating the first `n` keys in
+// `g` to their index.
+template <typename Map, typename Keys>
+auto make_map(const Keys& g, std::size_t n)
+{
+    auto v = Map{}.transient();
+    for (auto i = 0u; i < n; ++i)
+        v.set(g[i], i);
+    return v.persistent();
+}
+
+struct inc_fn
+{
+    template <typename T>
+    T operator()(T x) const
+    {
+        return x + 1;
+    }
+};
+
+} // namespace
@@ -0,0 +1,78 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/map/common.hpp"
+
+#include <immer/algorithm.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+
+namespace {
+
+template <typename Map>
+auto count_diff(const Map& a, const Map& b)
+{
+    auto c = 0u;
+    immer::diff(
+        a,
+        b,
+        [&](auto&&) { ++c; },
+        [&](auto&&) { ++c; },
+        [&](auto&&, auto&&) { ++c; });
+    return c;
+}
+
+// Diffs a map against a version of it where one in `Ratio` of the keys
+// were updated, one in `Ratio` removed and as many added, such that the
+// diff is computed between two maps that share most of their structure.
+template <typename Generator, typename Map, std::size_t Ratio>
+auto benchmark_diff()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        auto k = std::max(n / Ratio, std::size_t{1});
+        auto g = Generator{}(n + k);
+        auto a = make_map<Map>(g, n);
+        auto b = [&] {
+            auto v = a.transient();
+            for (auto i = 0u; i < k; ++i) {
+                v.update(g[i], inc_fn{});
+                v.erase(g[n - 1 - i]);
+                v.set(g[n + i], i);
+            }
+            return v.persistent();
+        }();
+
+        measure(meter, [&] {
+            volatile auto r = count_diff(a, b);
+            return r;
+        });
+    };
+}
+
+// Diffs two maps with the same contents that were built independently,
+// such that no structure is shared.
+template <typename Generator, typename Map>
+auto benchmark_diff_unshared()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        auto g = Generator{}(n);
+        auto a = make_map<Map>(g, n);
+        auto b = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            volatile auto r = count_diff(a, b);
+            return r;
+        });
+    };
+}
+
+} // namespace
@@ -0,0 +1,27 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "diff.hpp"
+
+#ifndef GENERATOR_T
+#error "you must define a GENERATOR_T"
+#endif
+
+using generator__ = GENERATOR_T;
+using t__         = typename decltype(generator__{}(0))::value_type;
+
+// clang-format off
+NONIUS_BENCHMARK("immer::map/1%/5B", benchmark_diff<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,5>, 100>())
+NONIUS_BENCHMARK("immer::map/1%/NO", benchmark_diff<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,basic_memory,5>, 100>())
+NONIUS_BENCHMARK("immer::map/1%/UN", benchmark_diff<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,unsafe_memory,5>, 100>())
+NONIUS_BENCHMARK("immer::map/10%/5B", benchmark_diff<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,5>, 10>())
+NONIUS_BENCHMARK("immer::map/10%/NO", benchmark_diff<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,basic_memory,5>, 10>())
+NONIUS_BENCHMARK("immer::map/10%/UN", benchmark_diff<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,unsafe_memory,5>, 10>())
+NONIUS_BENCHMARK("immer::map/unshared/5B", benchmark_diff_unshared<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,5>>())
+NONIUS_BENCHMARK("immer::map/unshared/4B", benchmark_diff_unshared<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,4>>())
+// clang-format on
@@ -0,0 +1,26 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "iter.hpp"
+
+#ifndef GENERATOR_T
+#error "you must define a GENERATOR_T"
+#endif
+
+using generator__ = GENERATOR_T;
+using t__         = typename decltype(generator__{}(0))::value_type;
+
+// clang-format off
+NONIUS_BENCHMARK("iter/std::map", benchmark_access_std_iter<generator__, std::map<t__, unsigned>>())
+NONIUS_BENCHMARK("iter/std::unordered_map", benchmark_access_std_iter<generator__, std::unordered_map<t__, unsigned>>())
+NONIUS_BENCHMARK("iter/boost::flat_map", benchmark_access_std_iter<generator__, boost::container::flat_map<t__, unsigned>>())
+NONIUS_BENCHMARK("iter/immer::map/5B", benchmark_access_iter<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,5>>())
+NONIUS_BENCHMARK("iter/immer::map/4B", benchmark_access_iter<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,4>>())
+NONIUS_BENCHMARK("reduce/immer::map/5B", benchmark_access_reduce<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,5>>())
+NONIUS_BENCHMARK("reduce/immer::map/4B", benchmark_access_reduce<generator__, immer::map<t__, unsigned, std::hash<t__>,std::equal_to<t__>,def_memory,4>>())
+// clang-format on
@@ -0,0 +1,104 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/map/common.hpp"
+
+#include <immer/flex_vector.hpp>
+#include <immer/flex_vector_transient.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <immer/nested_batch.hpp>
+
+namespace {
+
+// Updates `n` elements of the inner vectors of a map of `keys`
+// vectors of `levels` elements each, as an order book would do.
+constexpr auto keys   = 64u;
+constexpr auto levels = 256u;
+
+template <typename MP>
+using book_t =
+    immer::map<unsigned,
+               immer::flex_vector<unsigned, MP>,
+               std::hash<unsigned>,
+               std::equal_to<unsigned>,
+               MP>;
+
+template <typename Book>
+Book make_book()
+{
+    auto b = Book{}.transient();
+    for (auto k = 0u; k < keys; ++k)
+        b.set(k, typename Book::mapped_type(levels, k));
+    return b.persistent();
+}
+
+template <typename Book>
+auto benchmark_nested_update()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = make_generator_ranged(n);
+        auto b_ = make_book<Book>();
+
+        measure(meter, [&] {
+            auto b = b_;
+            for (auto i = 0u; i < n; ++i)
+                b = b.update(g[i] % keys, [&](auto v) {
+                    return v.update(g[i] % levels, inc_fn{});
+                });
+            return b;
+        });
+    };
+}
+
+template <typename Book>
+auto benchmark_nested_update_move()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = make_generator_ranged(n);
+        auto b_ = make_book<Book>();
+
+        measure(meter, [&] {
+            auto b = b_;
+            for (auto i = 0u; i < n; ++i)
+                b = std::move(b).update(g[i] % keys, [&](auto v) {
+                    return std::move(v).update(g[i] % levels, inc_fn{});
+                });
+            return b;
+        });
+    };
+}
+
+template <typename Book>
+auto benchmark_nested_batch()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = make_generator_ranged(n);
+        auto b_ = make_book<Book>();
+
+        measure(meter, [&] {
+            auto b = immer::nested_batch<Book>{b_};
+            for (auto i = 0u; i < n; ++i)
+                b.update(g[i] % keys, g[i] % levels, inc_fn{});
+            return std::move(b).persistent();
+        });
+    };
+}
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("update/5B",  benchmark_nested_update<book_t<def_memory>>())
+NONIUS_BENCHMARK("update/NO",  benchmark_nested_update<book_t<basic_memory>>())
+NONIUS_BENCHMARK("move/5B",    benchmark_nested_update_move<book_t<def_memory>>())
+NONIUS_BENCHMARK("batch/5B",   benchmark_nested_batch<book_t<def_memory>>())
+NONIUS_BENCHMARK("batch/NO",   benchmark_nested_batch<book_t<basic_memory>>())
+// clang-format on
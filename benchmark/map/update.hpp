@@ -0,0 +1,160 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/map/common.hpp"
+
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+template <typename Generator, typename Map>
+auto benchmark_update_mut_std()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n);
+        auto v_ = make_map_std<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                ++v[g[i]];
+            return v;
+        });
+    };
+}
+
+template <typename Generator, typename Map>
+auto benchmark_update_mut()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n);
+        auto v_ = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_.transient();
+            for (auto i = 0u; i < n; ++i)
+                v.update(g[i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Generator, typename Map>
+auto benchmark_update()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n);
+        auto v_ = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = v.update(g[i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Generator, typename Map>
+auto benchmark_update_move()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n);
+        auto v_ = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = std::move(v).update(g[i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+// Only half of the keys that are updated are in the map.
+template <typename Generator, typename Map>
+auto benchmark_update_if_exists_mut_std()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n * 2);
+        auto v_ = make_map_std<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i) {
+                auto it = v.find(g[n / 2 + i]);
+                if (it != v.end())
+                    ++it->second;
+            }
+            return v;
+        });
+    };
+}
+
+template <typename Generator, typename Map>
+auto benchmark_update_if_exists_mut()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n * 2);
+        auto v_ = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_.transient();
+            for (auto i = 0u; i < n; ++i)
+                v.update_if_exists(g[n / 2 + i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Generator, typename Map>
+auto benchmark_update_if_exists()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n * 2);
+        auto v_ = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = v.update_if_exists(g[n / 2 + i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+template <typename Generator, typename Map>
+auto benchmark_update_if_exists_move()
+{
+    return [](nonius::chronometer meter) {
+        auto n  = meter.param<N>();
+        auto g  = Generator{}(n * 2);
+        auto v_ = make_map<Map>(g, n);
+
+        measure(meter, [&] {
+            auto v = v_;
+            for (auto i = 0u; i < n; ++i)
+                v = std::move(v).update_if_exists(g[n / 2 + i], inc_fn{});
+            return v;
+        });
+    };
+}
+
+} // namespace
@@ -0,0 +1,29 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/config.hpp"
+
+namespace {
+
+// Every benchmark in this suite measures building a container of N
+// elements one by one, and reports the allocations per insertion
+// along with the footprint of the result.  `Make` is a function object
+// that builds the container of the given size.
+template <typename Make>
+auto benchmark_build()
+{
+    return [](nonius::chronometer meter) {
+        auto n = meter.param<N>();
+        report_footprint(n, [&] { return Make{}(n); });
+        measure_counting(meter, n, [&] { return Make{}(n); });
+    };
+}
+
+} // namespace
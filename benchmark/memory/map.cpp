@@ -0,0 +1,94 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/memory/common.hpp"
+
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <immer/set.hpp>
+#include <immer/set_transient.hpp>
+
+namespace {
+
+template <typename Map>
+struct make_map
+{
+    Map operator()(std::size_t n) const
+    {
+        auto v = Map{};
+        for (auto i = 0u; i < n; ++i)
+            v = v.set(i, i);
+        return v;
+    }
+};
+
+template <typename Map>
+struct make_map_move
+{
+    Map operator()(std::size_t n) const
+    {
+        auto v = Map{};
+        for (auto i = 0u; i < n; ++i)
+            v = std::move(v).set(i, i);
+        return v;
+    }
+};
+
+template <typename Map>
+struct make_map_mut
+{
+    Map operator()(std::size_t n) const
+    {
+        auto v = Map{}.transient();
+        for (auto i = 0u; i < n; ++i)
+            v.set(i, i);
+        return v.persistent();
+    }
+};
+
+template <typename Set>
+struct make_set
+{
+    Set operator()(std::size_t n) const
+    {
+        auto v = Set{};
+        for (auto i = 0u; i < n; ++i)
+            v = v.insert(i);
+        return v;
+    }
+};
+
+template <typename MP, immer::detail::hamts::bits_t B = 5>
+using map_t = immer::map<unsigned,
+                         unsigned,
+                         std::hash<unsigned>,
+                         std::equal_to<unsigned>,
+                         MP,
+                         B>;
+
+template <typename MP, immer::detail::hamts::bits_t B = 5>
+using set_t =
+    immer::set<unsigned, std::hash<unsigned>, std::equal_to<unsigned>, MP, B>;
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("map/NO",      benchmark_build<make_map<map_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("map/FL",      benchmark_build<make_map<map_t<counting_safe_memory>>>())
+NONIUS_BENCHMARK("map/UN",      benchmark_build<make_map<map_t<counting_unsafe_memory>>>())
+NONIUS_BENCHMARK("map/NO/B4",   benchmark_build<make_map<map_t<counting_basic_memory, 4>>>())
+NONIUS_BENCHMARK("map/NO/B3",   benchmark_build<make_map<map_t<counting_basic_memory, 3>>>())
+NONIUS_BENCHMARK("map/move/NO", benchmark_build<make_map_move<map_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("map/move/FL", benchmark_build<make_map_move<map_t<counting_safe_memory>>>())
+NONIUS_BENCHMARK("map/tran/NO", benchmark_build<make_map_mut<map_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("map/tran/FL", benchmark_build<make_map_mut<map_t<counting_safe_memory>>>())
+
+NONIUS_BENCHMARK("set/NO",      benchmark_build<make_set<set_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("set/FL",      benchmark_build<make_set<set_t<counting_safe_memory>>>())
+NONIUS_BENCHMARK("set/NO/B4",   benchmark_build<make_set<set_t<counting_basic_memory, 4>>>())
+// clang-format on
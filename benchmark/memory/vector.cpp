@@ -0,0 +1,79 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/memory/common.hpp"
+
+#include <immer/flex_vector.hpp>
+#include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
+
+namespace {
+
+template <typename Vector>
+struct make_vector
+{
+    Vector operator()(std::size_t n) const
+    {
+        auto v = Vector{};
+        for (auto i = 0u; i < n; ++i)
+            v = v.push_back(i);
+        return v;
+    }
+};
+
+template <typename Vector>
+struct make_vector_move
+{
+    Vector operator()(std::size_t n) const
+    {
+        auto v = Vector{};
+        for (auto i = 0u; i < n; ++i)
+            v = std::move(v).push_back(i);
+        return v;
+    }
+};
+
+template <typename Vector>
+struct make_vector_mut
+{
+    Vector operator()(std::size_t n) const
+    {
+        auto v = Vector{}.transient();
+        for (auto i = 0u; i < n; ++i)
+            v.push_back(i);
+        return v.persistent();
+    }
+};
+
+template <typename MP, immer::detail::rbts::bits_t B = 5,
+          immer::detail::rbts::bits_t BL = 5>
+using vector_t = immer::vector<unsigned, MP, B, BL>;
+
+template <typename MP, immer::detail::rbts::bits_t B = 5,
+          immer::detail::rbts::bits_t BL = 5>
+using flex_vector_t = immer::flex_vector<unsigned, MP, B, BL>;
+
+} // namespace
+
+// clang-format off
+NONIUS_BENCHMARK("vector/NO",            benchmark_build<make_vector<vector_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("vector/FL",            benchmark_build<make_vector<vector_t<counting_safe_memory>>>())
+NONIUS_BENCHMARK("vector/UN",            benchmark_build<make_vector<vector_t<counting_unsafe_memory>>>())
+NONIUS_BENCHMARK("vector/NO/B4",         benchmark_build<make_vector<vector_t<counting_basic_memory, 4, 4>>>())
+NONIUS_BENCHMARK("vector/NO/B6",         benchmark_build<make_vector<vector_t<counting_basic_memory, 6, 6>>>())
+NONIUS_BENCHMARK("vector/NO/B5BL3",      benchmark_build<make_vector<vector_t<counting_basic_memory, 5, 3>>>())
+NONIUS_BENCHMARK("vector/NO/B5BL7",      benchmark_build<make_vector<vector_t<counting_basic_memory, 5, 7>>>())
+NONIUS_BENCHMARK("vector/move/NO",       benchmark_build<make_vector_move<vector_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("vector/move/FL",       benchmark_build<make_vector_move<vector_t<counting_safe_memory>>>())
+NONIUS_BENCHMARK("vector/tran/NO",       benchmark_build<make_vector_mut<vector_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("vector/tran/FL",       benchmark_build<make_vector_mut<vector_t<counting_safe_memory>>>())
+
+NONIUS_BENCHMARK("flex_vector/NO",       benchmark_build<make_vector<flex_vector_t<counting_basic_memory>>>())
+NONIUS_BENCHMARK("flex_vector/FL",       benchmark_build<make_vector<flex_vector_t<counting_safe_memory>>>())
+NONIUS_BENCHMARK("flex_vector/move/NO",  benchmark_build<make_vector_move<flex_vector_t<counting_basic_memory>>>())
+// clang-format on
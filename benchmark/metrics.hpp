@@ -0,0 +1,32 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace {
+
+/*!
+ * Extra measurements of the benchmark that is currently running, other
+ * than time.  The reporter attaches them to the result of the
+ * benchmark and clears them before the next one starts.
+ */
+std::map<std::string, double>& benchmark_metrics()
+{
+    static std::map<std::string, double> metrics;
+    return metrics;
+}
+
+void report_metric(const std::string& name, double value)
+{
+    benchmark_metrics()[name] = value;
+}
+
+} // anonymous namespace
@@ -11,11 +11,14 @@
 #include "benchmark/config.hpp"
 
 #include <immer/set.hpp>
-#include <hash_trie.hpp> // Phil Nash
 #include <boost/container/flat_set.hpp>
 #include <set>
 #include <unordered_set>
 
+#if IMMER_BENCHMARK_HASH_TRIE
+#include <hash_trie.hpp> // Phil Nash
+#endif
+
 namespace {
 
 template <typename T=unsigned>
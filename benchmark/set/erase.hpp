@@ -11,12 +11,15 @@
 #include "benchmark/config.hpp"
 
 #include <boost/container/flat_set.hpp>
-#include <hash_trie.hpp> // Phil Nash
 #include <immer/set.hpp>
 #include <immer/set_transient.hpp>
 #include <set>
 #include <unordered_set>
 
+#if IMMER_BENCHMARK_HASH_TRIE
+#include <hash_trie.hpp> // Phil Nash
+#endif
+
 namespace {
 
 template <typename Generator, typename Set>
@@ -12,13 +12,17 @@
 
 #include <immer/set.hpp>
 #include <immer/box.hpp>
+#include <immer/hashed_box.hpp>
 #include <immer/algorithm.hpp>
-#include <hash_trie.hpp> // Phil Nash
 #include <boost/container/flat_set.hpp>
 #include <set>
 #include <unordered_set>
 #include <numeric>
 
+#if IMMER_BENCHMARK_HASH_TRIE
+#include <hash_trie.hpp> // Phil Nash
+#endif
+
 namespace {
 
 template <typename T>
@@ -48,6 +52,16 @@ struct iter_step<immer::box<std::string>>
     }
 };
 
+template <>
+struct iter_step<immer::hashed_box<std::string>>
+{
+    unsigned operator() (unsigned x,
+                         const immer::hashed_box<std::string>& y) const
+    {
+        return x + (unsigned) y->size();
+    }
+};
+
 template <typename Generator, typename Set>
 auto benchmark_access_std_iter()
 {
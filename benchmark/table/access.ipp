@@ -0,0 +1,25 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "access.hpp"
+
+#ifndef GENERATOR_T
+#error "you must define a GENERATOR_T"
+#endif
+
+using generator__ = GENERATOR_T;
+using t__         = typename decltype(generator__{}(0))::value_type;
+
+// clang-format off
+NONIUS_BENCHMARK("std::unordered_map", benchmark_access_std<generator__, std::unordered_map<t__, row<t__>>>())
+NONIUS_BENCHMARK("immer::table/5B", benchmark_access<generator__, table_t<t__, def_memory>>())
+NONIUS_BENCHMARK("immer::table/4B", benchmark_access<generator__, table_t<t__, def_memory, 4>>())
+NONIUS_BENCHMARK("immer::table/NO", benchmark_access<generator__, table_t<t__, basic_memory>>())
+NONIUS_BENCHMARK("immer::table/UN", benchmark_access<generator__, table_t<t__, unsafe_memory>>())
+NONIUS_BENCHMARK("bad/immer::table/5B", benchmark_bad_access<generator__, table_t<t__, def_memory>>())
+// clang-format on
@@ -0,0 +1,76 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include "benchmark/config.hpp"
+
+#include <immer/table.hpp>
+#include <immer/table_transient.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+template <typename K>
+struct row
+{
+    K id;
+    unsigned value;
+};
+
+template <typename K, typename MP, immer::detail::hamts::bits_t B = 5>
+using table_t = immer::
+    table<row<K>, immer::table_key_fn, std::hash<K>, std::equal_to<K>, MP, B>;
+
+template <typename T = unsigned>
+auto make_generator_ranged(std::size_t runs)
+{
+    assert(runs > 0);
+    auto engine = std::default_random_engine{13};
+    auto dist   = std::uniform_int_distribution<T>{0, (T) runs - 1};
+    auto r      = std::vector<T>(runs);
+    std::generate_n(r.begin(), runs, std::bind(dist, engine));
+    return r;
+}
+
+// Builds a table with a row for each of the first `n` keys in `g`.
+template <typename Table, typename Keys>
+auto make_table(const Keys& g, std::size_t n)
+{
+    auto v = Table{}.transient();
+    for (auto i = 0u; i < n; ++i)
+        v.insert({g[i], i});
+    return v.persistent();
+}
+
+// Builds a standard map from the same keys to rows like `make_table`.
+template <typename Map, typename Keys>
+auto make_table_std(const Keys& g, std::size_t n)
+{
+    auto v = Map{};
+    for (auto i = 0u; i < n; ++i)
+        v[g[i]] = {g[i], i};
+    return v;
+}
+
+struct inc_row_fn
+{
+    template <typename Row>
+    Row operator()(Row x) const
+    {
+        ++x.value;
+        return x;
+    }
+};
+
+} // namespace
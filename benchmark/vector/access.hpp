@@ -221,6 +221,7 @@ auto benchmark_access_random()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 template <typename Fn>
 auto benchmark_access_librrb(Fn maker)
 {
@@ -257,5 +258,6 @@ auto benchmark_access_random_librrb(Fn maker)
                 };
         };
 }
+#endif
 
 } // anonymous namespace
@@ -170,6 +170,7 @@ auto benchmark_assoc_mut_random()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 template <typename Fn>
 auto benchmark_assoc_librrb(Fn maker)
 {
@@ -241,5 +242,6 @@ auto benchmark_assoc_mut_random_librrb(Fn maker)
                 });
         };
 }
+#endif
 
 } // anonymous namespace
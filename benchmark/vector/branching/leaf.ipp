@@ -0,0 +1,88 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include "benchmark/vector/access.hpp"
+#include "benchmark/vector/assoc.hpp"
+#include "benchmark/vector/push.hpp"
+#include <immer/flex_vector.hpp>
+
+#include <array>
+#include <cstdint>
+
+#ifndef MEMORY_T
+#error "define the MEMORY_T"
+#endif
+
+namespace {
+
+template <typename T, std::size_t Bytes>
+using leaf_flex_t = immer::flex_vector<T,
+                                       MEMORY_T,
+                                       immer::default_bits,
+                                       immer::bits_leaf_for_bytes<T, Bytes>>;
+
+// A big trivially copyable element, like the row of a table, which is
+// where sizing the leaves in bytes makes the biggest difference.
+struct row_t
+{
+    std::array<std::uint64_t, 12> fields;
+
+    row_t(std::size_t x = 0)
+        : fields{}
+    {
+        fields[0] = x;
+    }
+};
+
+static_assert(sizeof(row_t) == 96, "");
+
+unsigned operator+(unsigned acc, const row_t& r)
+{
+    return acc + static_cast<unsigned>(r.fields[0]);
+}
+
+} // anonymous namespace
+
+NONIUS_BENCHMARK("access/size_t/64B",  benchmark_access_reduce<leaf_flex_t<std::size_t, 64>>())
+NONIUS_BENCHMARK("access/size_t/256B", benchmark_access_reduce<leaf_flex_t<std::size_t, 256>>())
+NONIUS_BENCHMARK("access/size_t/1K",   benchmark_access_reduce<leaf_flex_t<std::size_t, 1024>>())
+NONIUS_BENCHMARK("access/size_t/4K",   benchmark_access_reduce<leaf_flex_t<std::size_t, 4096>>())
+NONIUS_BENCHMARK("access/char/64B",    benchmark_access_reduce<leaf_flex_t<char, 64>>())
+NONIUS_BENCHMARK("access/char/256B",   benchmark_access_reduce<leaf_flex_t<char, 256>>())
+NONIUS_BENCHMARK("access/char/1K",     benchmark_access_reduce<leaf_flex_t<char, 1024>>())
+NONIUS_BENCHMARK("access/char/4K",     benchmark_access_reduce<leaf_flex_t<char, 4096>>())
+NONIUS_BENCHMARK("access/row/256B",    benchmark_access_reduce<leaf_flex_t<row_t, 256>>())
+NONIUS_BENCHMARK("access/row/1K",      benchmark_access_reduce<leaf_flex_t<row_t, 1024>>())
+NONIUS_BENCHMARK("access/row/4K",      benchmark_access_reduce<leaf_flex_t<row_t, 4096>>())
+NONIUS_BENCHMARK("access/row/16K",     benchmark_access_reduce<leaf_flex_t<row_t, 16384>>())
+
+NONIUS_BENCHMARK("assoc/size_t/64B",   benchmark_assoc<leaf_flex_t<std::size_t, 64>>())
+NONIUS_BENCHMARK("assoc/size_t/256B",  benchmark_assoc<leaf_flex_t<std::size_t, 256>>())
+NONIUS_BENCHMARK("assoc/size_t/1K",    benchmark_assoc<leaf_flex_t<std::size_t, 1024>>())
+NONIUS_BENCHMARK("assoc/size_t/4K",    benchmark_assoc<leaf_flex_t<std::size_t, 4096>>())
+NONIUS_BENCHMARK("assoc/char/64B",     benchmark_assoc<leaf_flex_t<char, 64>>())
+NONIUS_BENCHMARK("assoc/char/256B",    benchmark_assoc<leaf_flex_t<char, 256>>())
+NONIUS_BENCHMARK("assoc/char/1K",      benchmark_assoc<leaf_flex_t<char, 1024>>())
+NONIUS_BENCHMARK("assoc/char/4K",      benchmark_assoc<leaf_flex_t<char, 4096>>())
+NONIUS_BENCHMARK("assoc/row/256B",     benchmark_assoc<leaf_flex_t<row_t, 256>>())
+NONIUS_BENCHMARK("assoc/row/1K",       benchmark_assoc<leaf_flex_t<row_t, 1024>>())
+NONIUS_BENCHMARK("assoc/row/4K",       benchmark_assoc<leaf_flex_t<row_t, 4096>>())
+NONIUS_BENCHMARK("assoc/row/16K",      benchmark_assoc<leaf_flex_t<row_t, 16384>>())
+
+NONIUS_BENCHMARK("push/size_t/64B",    benchmark_push<leaf_flex_t<std::size_t, 64>>())
+NONIUS_BENCHMARK("push/size_t/256B",   benchmark_push<leaf_flex_t<std::size_t, 256>>())
+NONIUS_BENCHMARK("push/size_t/1K",     benchmark_push<leaf_flex_t<std::size_t, 1024>>())
+NONIUS_BENCHMARK("push/size_t/4K",     benchmark_push<leaf_flex_t<std::size_t, 4096>>())
+NONIUS_BENCHMARK("push/char/64B",      benchmark_push<leaf_flex_t<char, 64>>())
+NONIUS_BENCHMARK("push/char/256B",     benchmark_push<leaf_flex_t<char, 256>>())
+NONIUS_BENCHMARK("push/char/1K",       benchmark_push<leaf_flex_t<char, 1024>>())
+NONIUS_BENCHMARK("push/char/4K",       benchmark_push<leaf_flex_t<char, 4096>>())
+NONIUS_BENCHMARK("push/row/256B",      benchmark_push<leaf_flex_t<row_t, 256>>())
+NONIUS_BENCHMARK("push/row/1K",        benchmark_push<leaf_flex_t<row_t, 1024>>())
+NONIUS_BENCHMARK("push/row/4K",        benchmark_push<leaf_flex_t<row_t, 4096>>())
+NONIUS_BENCHMARK("push/row/16K",       benchmark_push<leaf_flex_t<row_t, 16384>>())
@@ -75,6 +75,7 @@ template <typename T, typename MP>
 struct get_limit<immer::array<T, MP>> : std::integral_constant<
     std::size_t, 10000> {};
 
+#if IMMER_BENCHMARK_LIBRRB
 auto make_librrb_vector(std::size_t n)
 {
     auto v = rrb_create();
@@ -94,8 +95,9 @@ auto make_librrb_vector_f(std::size_t n)
     }
     return v;
 }
+#endif
 
-
+#if IMMER_BENCHMARK_GC
 // copied from:
 // https://github.com/ivmai/bdwgc/blob/master/include/gc_allocator.h
 
@@ -208,5 +210,6 @@ inline bool operator==(const gc_allocator<T1>&, const gc_allocator<T2>&)
 template <class T1, class T2>
 inline bool operator!=(const gc_allocator<T1>&, const gc_allocator<T2>&)
 { return false; }
+#endif // IMMER_BENCHMARK_GC
 
 } // anonymous namespace
@@ -32,6 +32,7 @@ auto benchmark_concat()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 template <typename Fn>
 auto benchmark_concat_librrb(Fn maker)
 {
@@ -44,6 +45,7 @@ auto benchmark_concat_librrb(Fn maker)
                 });
         };
 }
+#endif
 
 template <typename Vektor,
           typename PushFn=push_back_fn>
@@ -88,6 +90,7 @@ auto benchmark_concat_incr_mut()
         };
 }
 
+#if IMMER_BENCHMARK_GC
 template <typename Vektor>
 auto benchmark_concat_incr_mut2()
 {
@@ -118,6 +121,7 @@ auto benchmark_concat_incr_mut2()
             });
         };
 }
+#endif
 
 template <typename Vektor>
 auto benchmark_concat_incr_chunkedseq()
@@ -147,6 +151,7 @@ auto benchmark_concat_incr_chunkedseq()
         };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 template <typename Fn>
 auto benchmark_concat_incr_librrb(Fn maker)
 {
@@ -162,5 +167,6 @@ auto benchmark_concat_incr_librrb(Fn maker)
                 });
         };
 }
+#endif
 
 } // anonymous namespace
@@ -93,6 +93,7 @@ auto benchmark_drop_mut()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 template <typename Fn>
 auto benchmark_drop_librrb(Fn make)
 {
@@ -138,5 +139,6 @@ auto benchmark_drop_mut_librrb(Fn make)
             });
     };
 }
+#endif
 
 } // anonymous namespace
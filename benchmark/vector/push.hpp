@@ -84,6 +84,7 @@ auto benchmark_push()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 auto benchmark_push_librrb(nonius::chronometer meter)
 {
     auto n = meter.param<N>();
@@ -107,5 +108,6 @@ auto benchmark_push_mut_librrb(nonius::chronometer meter)
         return v;
     });
 }
+#endif
 
 } // anonymous namespace
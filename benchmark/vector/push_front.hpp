@@ -28,6 +28,7 @@ auto bechmark_push_front()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 auto benchmark_push_front_librrb(nonius::chronometer meter)
 {
     auto n = meter.param<N>();
@@ -42,5 +43,6 @@ auto benchmark_push_front_librrb(nonius::chronometer meter)
         return v;
     });
 }
+#endif
 
 } // anonymous namespace
@@ -93,6 +93,7 @@ auto benchmark_take_mut()
     };
 }
 
+#if IMMER_BENCHMARK_LIBRRB
 template <typename Fn>
 auto benchmark_take_librrb(Fn make)
 {
@@ -140,5 +141,6 @@ auto benchmark_take_mut_librrb(Fn make)
             });
     };
 }
+#endif
 
 } // anonymous namespace
@@ -69,6 +69,28 @@
 (benchmark (apply u32vector (iota bench-size)))
 (benchmark (list->vlist (iota bench-size)))
 (benchmark (apply fector (iota bench-size)))
+(benchmark (list->ivector (iota bench-size)))
+(benchmark (list->ivector-u32 (iota bench-size)))
+(benchmark (list->vector (iota bench-size)))
+(benchmark (ivector-fill bench-size (lambda (i) i)))
+(benchmark (vector-unfold (lambda (i) i) bench-size))
+
+(display ";;;; benchmarking creation by pushing...") (newline)
+
+(benchmark (let iter ((i 0) (v (ivector)))
+             (if (< i bench-size)
+                 (iter (+ i 1) (ivector-push v i))
+                 v)))
+(benchmark (let ((t (ivector-transient (ivector))))
+             (let iter ((i 0))
+               (when (< i bench-size)
+                 (ivector-transient-push! t i)
+                 (iter (+ i 1))))
+             (ivector-transient-persistent t)))
+(benchmark (let iter ((i 0) (v (transient-fector)))
+             (if (< i bench-size)
+                 (iter (+ i 1) (fector-push! v i))
+                 (persistent-fector v))))
 
 (display ";;;; benchmarking iteration...") (newline)
 
@@ -166,3 +188,61 @@
 (benchmark (append bench-list bench-list))
 (benchmark (vector-append bench-vector bench-vector))
 (benchmark (vlist-append bench-vlist bench-vlist))
+
+(display ";;;; benchmarking map insertion...") (newline)
+
+(benchmark (let iter ((i 0) (m (imap)))
+             (if (< i bench-size)
+                 (iter (+ i 1) (imap-set m i i))
+                 m)))
+(benchmark (let ((t (imap-transient (imap))))
+             (let iter ((i 0))
+               (when (< i bench-size)
+                 (imap-transient-set! t i i)
+                 (iter (+ i 1))))
+             (imap-transient-persistent t)))
+(benchmark (let ((h (make-hash-table)))
+             (let iter ((i 0))
+               (when (< i bench-size)
+                 (hash-set! h i i)
+                 (iter (+ i 1))))
+             h))
+(benchmark (let iter ((i 0) (h vlist-null))
+             (if (< i bench-size)
+                 (iter (+ i 1) (vhash-cons i i h))
+                 h)))
+
+(display ";;;; benchmarking map lookup...") (newline)
+
+(display-eval (define bench-imap (alist->imap (map cons
+                                                   (iota bench-size)
+                                                   (iota bench-size)))))
+(display-eval (define bench-hash-table
+                (let ((h (make-hash-table)))
+                  (for-each (lambda (i) (hash-set! h i i))
+                            (iota bench-size))
+                  h)))
+(display-eval (define bench-vhash (fold (lambda (i h) (vhash-cons i i h))
+                                        vlist-null
+                                        (iota bench-size))))
+
+(benchmark (let iter ((i 0) (acc 0))
+             (if (< i bench-size)
+                 (iter (+ i 1) (+ acc (imap-ref bench-imap i)))
+                 acc)))
+(benchmark (let iter ((i 0) (acc 0))
+             (if (< i bench-size)
+                 (iter (+ i 1) (+ acc (hash-ref bench-hash-table i)))
+                 acc)))
+(benchmark (let iter ((i 0) (acc 0))
+             (if (< i bench-size)
+                 (iter (+ i 1) (+ acc (cdr (vhash-assoc i bench-vhash))))
+                 acc)))
+
+(display ";;;; benchmarking set insertion...") (newline)
+
+(benchmark (list->iset (iota bench-size)))
+(benchmark (let iter ((i 0) (s (iset)))
+             (if (< i bench-size)
+                 (iter (+ i 1) (iset-insert s i))
+                 s)))
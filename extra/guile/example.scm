@@ -37,6 +37,44 @@
   (assert (eq? (ivector-ref v2 2) ":)")))
 ;; include:intro/end
 
+;; include:bulk/start
+(let* ((t (ivector-transient (ivector)))
+       (v (begin
+            (for-each (lambda (x) (ivector-transient-push! t x))
+                      (iota 100))
+            (ivector-transient-persistent t))))
+  (assert (eq? (ivector-length v) 100))
+  (assert (eq? (ivector-ref v 42) 42))
+  (assert (equal? (ivector->list (list->ivector '(1 2 3))) '(1 2 3)))
+  (assert (eq? (ivector-ref (ivector-fill 10 (lambda (i) (* i i))) 3) 9))
+  (assert (eq? (ivector-u32-ref (vector->ivector-u32 #(1 2 3)) 2) 3)))
+;; include:bulk/end
+
+;; include:map/start
+(let* ((m1 (imap "one" 1 "two" 2))
+       (m2 (imap-set m1 "three" 3))
+       (m3 (imap-update m2 "one" (lambda (x) (+ x 10)))))
+  (assert (eq? (imap-size m1) 2))
+  (assert (eq? (imap-size m2) 3))
+  (assert (eq? (imap-ref m1 "three") #f))
+  (assert (eq? (imap-ref m1 "three" 'none) 'none))
+  (assert (eq? (imap-ref m3 "one") 11))
+  (assert (imap-contains? (imap-erase m3 "two") "one"))
+  (assert (not (imap-contains? (imap-erase m3 "two") "two")))
+  (assert (eq? (imap-fold (lambda (k v acc) (+ v acc)) 0 m3) 16))
+  (assert (equal? (imap->alist (alist->imap '((a . 1)))) '((a . 1)))))
+
+(let* ((s1 (list->iset '(1 2 3 2 1)))
+       (s2 (iset-insert s1 4))
+       (t  (iset-transient s2)))
+  (assert (eq? (iset-size s1) 3))
+  (assert (iset-contains? s2 4))
+  (assert (not (iset-contains? s1 4)))
+  (iset-transient-erase! t 1)
+  (assert (eq? (iset-size (iset-transient-persistent t)) 3))
+  (assert (eq? (iset-size s2) 4)))
+;; include:map/end
+
 ;; Experiments
 
 (let ((d (dummy)))
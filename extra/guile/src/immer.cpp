@@ -9,7 +9,12 @@
 #include <immer/algorithm.hpp>
 #include <immer/flex_vector.hpp>
 #include <immer/flex_vector_transient.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <immer/set.hpp>
+#include <immer/set_transient.hpp>
 #include <iostream>
+#include <limits>
 #include <scm/scm.hpp>
 
 namespace {
@@ -42,6 +47,42 @@ using guile_memory = immer::memory_policy<immer::heap_policy<guile_heap>,
 template <typename T>
 using guile_ivector = immer::flex_vector<T, guile_memory>;
 
+// Hashes and compares like `hash` and `equal?` do, such that the keys
+// behave as in a Guile hash table created with `make-hash-table`.
+struct guile_hash
+{
+    std::size_t operator()(scm::val v) const
+    {
+        return scm_ihash(v, std::numeric_limits<unsigned long>::max());
+    }
+};
+
+struct guile_equal
+{
+    bool operator()(scm::val a, scm::val b) const
+    {
+        return scm_is_true(scm_equal_p(a, b));
+    }
+};
+
+// The nodes are allocated with `scm_gc_malloc`, which Guile's
+// collector scans for pointers, so the `SCM` keys and values stored
+// in them are kept alive for as long as the containers are.
+using guile_imap =
+    immer::map<scm::val, scm::val, guile_hash, guile_equal, guile_memory>;
+using guile_iset = immer::set<scm::val, guile_hash, guile_equal, guile_memory>;
+
+scm::val to_scm_bool(bool x) { return scm::val{scm_from_bool(x)}; }
+
+template <typename Vector>
+Vector list_to_ivector(scm::list l)
+{
+    auto t = typename Vector::transient_type{};
+    for (auto x : l)
+        t.push_back(x);
+    return std::move(t).persistent();
+}
+
 struct dummy
 {
     SCM port_ = scm_current_warning_port();
@@ -78,14 +119,15 @@ void init_ivector(std::string type_name = "")
 {
     using namespace std::string_literals;
 
-    using self_t = guile_ivector<T>;
-    using size_t = typename self_t::size_type;
+    using self_t      = guile_ivector<T>;
+    using transient_t = typename self_t::transient_type;
+    using size_t      = typename self_t::size_type;
 
     auto name = "ivector"s + (type_name.empty() ? ""s : "-" + type_name);
 
     scm::type<self_t>(name)
         .constructor(
-            [](scm::args rest) { return self_t(rest.begin(), rest.end()); })
+            [](scm::args rest) { return list_to_ivector<self_t>(rest); })
         .maker([](size_t n, scm::args rest) {
             return self_t(n, rest ? *rest : scm::val{});
         })
@@ -108,8 +150,184 @@ void init_ivector(std::string type_name = "")
                         v = v + x;
                     return v;
                 })
-        .define("fold", [](scm::val fn, scm::val first, const self_t& v) {
-            return immer::accumulate(v, first, fn);
+        .define("fold",
+                [](scm::val fn, scm::val first, const self_t& v) {
+                    return immer::accumulate(v, first, fn);
+                })
+        .define("fill",
+                [](size_t n, scm::val fn) {
+                    auto t = transient_t{};
+                    for (auto i = size_t{}; i < n; ++i)
+                        t.push_back(fn(scm::val{i}));
+                    return std::move(t).persistent();
+                })
+        .define("transient", [](const self_t& v) { return v.transient(); });
+
+    scm::type<transient_t>(name + "-transient")
+        .define("ref", &transient_t::operator[])
+        .define("length", &transient_t::size)
+        .define("set!",
+                [](transient_t& t, size_t i, scm::val x) { t.set(i, x); })
+        .define("update!",
+                [](transient_t& t, size_t i, scm::val fn) { t.update(i, fn); })
+        .define("push!", [](transient_t& t, scm::val x) { t.push_back(x); })
+        .define("take!", [](transient_t& t, size_t s) { t.take(s); })
+        .define("drop!", [](transient_t& t, size_t s) { t.drop(s); })
+        .define("persistent", [](transient_t& t) { return t.persistent(); });
+
+    scm::group<self_t>()
+        .define("list->" + name,
+                [](scm::list l) { return list_to_ivector<self_t>(l); })
+        .define("vector->" + name,
+                [](scm::val v) {
+                    auto t = transient_t{};
+                    auto n = scm_c_vector_length(v);
+                    for (auto i = std::size_t{}; i < n; ++i)
+                        t.push_back(scm::val{scm_c_vector_ref(v, i)});
+                    return std::move(t).persistent();
+                })
+        .define(name + "->list", [](const self_t& v) {
+            auto r = SCM_EOL;
+            for (auto it = v.rbegin(); it != v.rend(); ++it)
+                r = scm_cons(scm::val{*it}, r);
+            return scm::val{r};
+        });
+}
+
+void init_imap()
+{
+    using self_t      = guile_imap;
+    using transient_t = self_t::transient_type;
+
+    scm::type<self_t>("imap")
+        .constructor([](scm::args rest) {
+            auto t = transient_t{};
+            for (auto it = rest.begin(); it; ++it) {
+                auto k = *it;
+                if (!++it)
+                    scm_misc_error("imap", "missing value for key ~S",
+                                   scm_list_1(k));
+                t.set(k, *it);
+            }
+            return std::move(t).persistent();
+        })
+        .define("ref",
+                [](const self_t& m, scm::val k, scm::args rest) {
+                    auto v = m.find(k);
+                    return v ? *v : rest ? *rest : scm::val{SCM_BOOL_F};
+                })
+        .define("contains?",
+                [](const self_t& m, scm::val k) {
+                    return to_scm_bool(m.count(k));
+                })
+        .define("size", &self_t::size)
+        .define("set",
+                [](const self_t& m, scm::val k, scm::val v) {
+                    return m.set(k, v);
+                })
+        .define("update",
+                [](const self_t& m, scm::val k, scm::val fn) {
+                    return m.update(k, fn);
+                })
+        .define("erase",
+                [](const self_t& m, scm::val k) { return m.erase(k); })
+        .define("fold",
+                [](scm::val fn, scm::val first, const self_t& m) {
+                    return immer::accumulate(
+                        m, first, [&](scm::val acc, auto&& kv) {
+                            return fn(kv.first, kv.second, acc);
+                        });
+                })
+        .define("transient", [](const self_t& m) { return m.transient(); });
+
+    scm::type<transient_t>("imap-transient")
+        .define("ref",
+                [](const transient_t& t, scm::val k, scm::args rest) {
+                    auto v = t.find(k);
+                    return v ? *v : rest ? *rest : scm::val{SCM_BOOL_F};
+                })
+        .define("contains?",
+                [](const transient_t& t, scm::val k) {
+                    return to_scm_bool(t.count(k));
+                })
+        .define("size", &transient_t::size)
+        .define("set!",
+                [](transient_t& t, scm::val k, scm::val v) { t.set(k, v); })
+        .define("update!",
+                [](transient_t& t, scm::val k, scm::val fn) {
+                    t.update(k, fn);
+                })
+        .define("erase!", [](transient_t& t, scm::val k) { t.erase(k); })
+        .define("persistent", [](transient_t& t) { return t.persistent(); });
+
+    scm::group<self_t>()
+        .define("alist->imap",
+                [](scm::list l) {
+                    auto t = transient_t{};
+                    for (auto kv : l)
+                        t.set(scm::val{scm_car(kv)}, scm::val{scm_cdr(kv)});
+                    return std::move(t).persistent();
+                })
+        .define("imap->alist", [](const self_t& m) {
+            auto r = SCM_EOL;
+            for (auto&& kv : m)
+                r = scm_acons(kv.first, kv.second, r);
+            return scm::val{r};
+        });
+}
+
+void init_iset()
+{
+    using self_t      = guile_iset;
+    using transient_t = self_t::transient_type;
+
+    scm::type<self_t>("iset")
+        .constructor([](scm::args rest) {
+            auto t = transient_t{};
+            for (auto x : rest)
+                t.insert(x);
+            return std::move(t).persistent();
+        })
+        .define("contains?",
+                [](const self_t& s, scm::val x) {
+                    return to_scm_bool(s.count(x));
+                })
+        .define("size", &self_t::size)
+        .define("insert",
+                [](const self_t& s, scm::val x) { return s.insert(x); })
+        .define("erase", [](const self_t& s, scm::val x) { return s.erase(x); })
+        .define("fold",
+                [](scm::val fn, scm::val first, const self_t& s) {
+                    return immer::accumulate(
+                        s, first, [&](scm::val acc, scm::val x) {
+                            return fn(x, acc);
+                        });
+                })
+        .define("transient", [](const self_t& s) { return s.transient(); });
+
+    scm::type<transient_t>("iset-transient")
+        .define("contains?",
+                [](const transient_t& t, scm::val x) {
+                    return to_scm_bool(t.count(x));
+                })
+        .define("size", &transient_t::size)
+        .define("insert!", [](transient_t& t, scm::val x) { t.insert(x); })
+        .define("erase!", [](transient_t& t, scm::val x) { t.erase(x); })
+        .define("persistent", [](transient_t& t) { return t.persistent(); });
+
+    scm::group<self_t>()
+        .define("list->iset",
+                [](scm::list l) {
+                    auto t = transient_t{};
+                    for (auto x : l)
+                        t.insert(x);
+                    return std::move(t).persistent();
+                })
+        .define("iset->list", [](const self_t& s) {
+            auto r = SCM_EOL;
+            for (auto&& x : s)
+                r = scm_cons(x, r);
+            return scm::val{r};
         });
 }
 
@@ -145,4 +363,7 @@ extern "C" void init_immer()
     init_ivector<std::int64_t>("s64");
     init_ivector<float>("f32");
     init_ivector<double>("f64");
+
+    init_imap();
+    init_iset();
 }
@@ -10,6 +10,11 @@
 import immer
 import pyrsistent
 
+try:
+    xrange
+except NameError:
+    xrange = range
+
 BENCHMARK_SIZE = 1000
 
 def push(v, n=BENCHMARK_SIZE):
@@ -26,20 +31,95 @@ def index(v):
     for i in xrange(len(v)):
         v[i]
 
+def map_set(m, n=BENCHMARK_SIZE):
+    for x in xrange(n):
+        m = m.set(x, x)
+    return m
+
+def map_get(m):
+    for x in xrange(len(m)):
+        m[x]
+
+def set_add(s, n=BENCHMARK_SIZE):
+    for x in xrange(n):
+        s = s.add(x)
+    return s
+
+def set_insert(s, n=BENCHMARK_SIZE):
+    for x in xrange(n):
+        s = s.insert(x)
+    return s
+
 def test_push_immer(benchmark):
     benchmark(push, immer.Vector())
 
+def test_push_immer_flex(benchmark):
+    benchmark(push, immer.FlexVector())
+
+def test_push_immer_int(benchmark):
+    benchmark(push, immer.IntVector())
+
 def test_push_pyrsistent(benchmark):
     benchmark(push, pyrsistent.pvector())
 
 def test_assoc_immer(benchmark):
     benchmark(assoc, push(immer.Vector()))
 
+def test_assoc_immer_flex(benchmark):
+    benchmark(assoc, push(immer.FlexVector()))
+
 def test_assoc_pyrsistent(benchmark):
     benchmark(assoc, push(pyrsistent.pvector()))
 
 def test_index_immer(benchmark):
     benchmark(index, push(immer.Vector()))
 
+def test_index_immer_flex(benchmark):
+    benchmark(index, push(immer.FlexVector()))
+
 def test_index_pyrsistent(benchmark):
     benchmark(index, push(pyrsistent.pvector()))
+
+def test_from_iterable_immer(benchmark):
+    benchmark(immer.Vector.from_iterable, xrange(BENCHMARK_SIZE))
+
+def test_from_iterable_immer_flex(benchmark):
+    benchmark(immer.FlexVector.from_iterable, xrange(BENCHMARK_SIZE))
+
+def test_from_iterable_immer_int(benchmark):
+    benchmark(immer.IntVector.from_iterable, xrange(BENCHMARK_SIZE))
+
+def test_from_iterable_pyrsistent(benchmark):
+    benchmark(pyrsistent.pvector, xrange(BENCHMARK_SIZE))
+
+def test_to_list_immer(benchmark):
+    benchmark(immer.Vector.to_list, push(immer.Vector()))
+
+def test_to_list_pyrsistent(benchmark):
+    benchmark(pyrsistent.PVector.tolist, push(pyrsistent.pvector()))
+
+def test_map_set_immer(benchmark):
+    benchmark(map_set, immer.Map())
+
+def test_map_set_pyrsistent(benchmark):
+    benchmark(map_set, pyrsistent.pmap())
+
+def test_map_get_immer(benchmark):
+    benchmark(map_get, map_set(immer.Map()))
+
+def test_map_get_pyrsistent(benchmark):
+    benchmark(map_get, map_set(pyrsistent.pmap()))
+
+def test_map_from_dict_immer(benchmark):
+    d = dict((x, x) for x in xrange(BENCHMARK_SIZE))
+    benchmark(immer.Map.from_iterable, d)
+
+def test_map_from_dict_pyrsistent(benchmark):
+    d = dict((x, x) for x in xrange(BENCHMARK_SIZE))
+    benchmark(pyrsistent.pmap, d)
+
+def test_set_insert_immer(benchmark):
+    benchmark(set_insert, immer.Set())
+
+def test_set_add_pyrsistent(benchmark):
+    benchmark(set_add, pyrsistent.pset())
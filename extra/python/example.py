@@ -19,3 +19,24 @@ v1 = v0.set(0, 12)
 assert v0.tolist() == [13, 42]
 assert v1.tolist() == [12, 42]
 # include:intro/end
+
+# include:bulk/start
+f0 = immer.FlexVector.from_iterable(range(1000))
+f1 = f0.drop(10) + f0.take(10)
+assert f1[-1] == 9
+assert f1.to_list()[:3] == [10, 11, 12]
+
+m0 = immer.Map({'a': 1, 'b': 2})
+m1 = m0.set('c', 3)
+assert 'c' not in m0
+assert m1.to_dict() == {'a': 1, 'b': 2, 'c': 3}
+
+s0 = immer.Set.from_iterable('hello')
+assert len(s0) == 4
+# include:bulk/end
+
+# include:buffer/start
+i0 = immer.IntVector.from_iterable(range(10000))
+total = sum(sum(memoryview(chunk).tolist()) for chunk in i0.chunks())
+assert total == sum(range(10000))
+# include:buffer/end
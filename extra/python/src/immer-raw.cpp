@@ -13,10 +13,29 @@ extern "C"
 }
 
 #include <immer/algorithm.hpp>
+#include <immer/flex_vector.hpp>
+#include <immer/flex_vector_transient.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
 #include <immer/refcount/unsafe_refcount_policy.hpp>
+#include <immer/set.hpp>
+#include <immer/set_transient.hpp>
 #include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
 
-#include <iostream>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if PY_VERSION_HEX >= 0x03080000
+#define IMMER_PY_TRASHCAN_BEGIN(op, dealloc) Py_TRASHCAN_BEGIN(op, dealloc)
+#define IMMER_PY_TRASHCAN_END(op) Py_TRASHCAN_END
+#else
+#define IMMER_PY_TRASHCAN_BEGIN(op, dealloc) Py_TRASHCAN_SAFE_BEGIN(op)
+#define IMMER_PY_TRASHCAN_END(op) Py_TRASHCAN_SAFE_END(op)
+#endif
 
 namespace {
 
@@ -90,105 +109,455 @@ struct object_t
     PyObject* get() const { return ptr_; }
 };
 
+// Thrown when a Python exception has been set, to unwind back into the
+// Python interpreter, see `guard()`.
+struct python_error
+{};
+
+PyObject* check(PyObject* p)
+{
+    if (!p)
+        throw python_error{};
+    return p;
+}
+
+template <typename Fn>
+PyObject* guard(Fn&& fn)
+{
+    try {
+        return fn();
+    } catch (const python_error&) {
+        return nullptr;
+    } catch (const std::bad_alloc&) {
+        return PyErr_NoMemory();
+    } catch (const std::exception& err) {
+        PyErr_SetString(PyExc_RuntimeError, err.what());
+        return nullptr;
+    }
+}
+
+// Casts a function to the generic signature of a slot or method,
+// which is how CPython expects to receive them.
+template <typename To, typename Fn>
+To slot(Fn* fn)
+{
+    return reinterpret_cast<To>(reinterpret_cast<void (*)()>(fn));
+}
+
+template <typename Fn>
+PyCFunction method(Fn* fn)
+{
+    return slot<PyCFunction>(fn);
+}
+
+struct object_hash
+{
+    std::size_t operator()(const object_t& x) const
+    {
+        auto h = PyObject_Hash(x.get());
+        if (h == -1 && PyErr_Occurred())
+            throw python_error{};
+        return static_cast<std::size_t>(h);
+    }
+};
+
+struct object_equal
+{
+    bool operator()(const object_t& a, const object_t& b) const
+    {
+        auto r = PyObject_RichCompareBool(a.get(), b.get(), Py_EQ);
+        if (r < 0)
+            throw python_error{};
+        return r;
+    }
+};
+
 using memory_t =
     immer::memory_policy<immer::unsafe_free_list_heap_policy<heap_t>,
                          immer::unsafe_refcount_policy,
                          immer::no_lock_policy>;
 
-using vector_impl_t = immer::vector<object_t, memory_t>;
+using vector_impl_t      = immer::vector<object_t, memory_t>;
+using flex_vector_impl_t = immer::flex_vector<object_t, memory_t>;
+using int_vector_impl_t  = immer::flex_vector<std::int64_t, memory_t>;
+using float_vector_impl_t = immer::flex_vector<double, memory_t>;
+using map_impl_t =
+    immer::map<object_t, object_t, object_hash, object_equal, memory_t>;
+using set_impl_t = immer::set<object_t, object_hash, object_equal, memory_t>;
+
+/*
+ * Conversion of the elements from and to Python objects.
+ */
+
+template <typename T>
+struct element;
+
+template <>
+struct element<object_t>
+{
+    static constexpr bool gc = true;
+
+    static PyObject* to_python(const object_t& x)
+    {
+        auto p = x.get();
+        Py_INCREF(p);
+        return p;
+    }
+
+    static object_t from_python(PyObject* p) { return object_t::adopt(p); }
+};
+
+template <>
+struct element<std::int64_t>
+{
+    static constexpr bool gc = false;
+
+    static const char* format() { return "q"; }
+    static bool native_format(char c)
+    {
+        return c == 'q' || (c == 'l' && sizeof(long) == sizeof(std::int64_t));
+    }
+
+    static PyObject* to_python(std::int64_t x)
+    {
+        return check(PyLong_FromLongLong(x));
+    }
+
+    static std::int64_t from_python(PyObject* p)
+    {
+        auto r = PyLong_AsLongLong(p);
+        if (r == -1 && PyErr_Occurred())
+            throw python_error{};
+        return r;
+    }
+};
+
+template <>
+struct element<double>
+{
+    static constexpr bool gc = false;
+
+    static const char* format() { return "d"; }
+    static bool native_format(char c) { return c == 'd'; }
+
+    static PyObject* to_python(double x) { return check(PyFloat_FromDouble(x)); }
+
+    static double from_python(PyObject* p)
+    {
+        auto r = PyFloat_AsDouble(p);
+        if (r == -1.0 && PyErr_Occurred())
+            throw python_error{};
+        return r;
+    }
+};
+
+template <>
+struct element<std::pair<object_t, object_t>>
+{
+    static constexpr bool gc = true;
+};
+
+int visit_element(const object_t& x, visitproc visit, void* arg)
+{
+    Py_VISIT(x.get());
+    return 0;
+}
+
+int visit_element(const std::pair<object_t, object_t>& x,
+                  visitproc visit,
+                  void* arg)
+{
+    Py_VISIT(x.first.get());
+    Py_VISIT(x.second.get());
+    return 0;
+}
+
+template <typename T>
+int visit_element(const T&, visitproc, void*)
+{
+    return 0;
+}
+
+template <typename Impl>
+struct is_flex : std::false_type
+{};
+
+template <typename T, typename MP, immer::detail::rbts::bits_t B,
+          immer::detail::rbts::bits_t BL>
+struct is_flex<immer::flex_vector<T, MP, B, BL>> : std::true_type
+{};
+
+/*
+ * Python object wrapping an immutable container.  The same layout is
+ * used for all the containers exposed by the module.
+ */
+
+PyTypeObject empty_type()
+{
+    auto t    = PyTypeObject{};
+    t.ob_base = PyVarObject{PyObject_HEAD_INIT(nullptr) 0};
+    return t;
+}
 
-struct vector_t
+template <typename Impl>
+struct container_t
 {
-    PyObject_HEAD vector_impl_t impl;
+    using impl_t    = Impl;
+    using element_t = element<typename Impl::value_type>;
+
+    PyObject_HEAD impl_t impl;
     PyObject* in_weakreflist;
 
     static PyTypeObject type;
 };
 
-vector_t* empty_vector = nullptr;
+template <typename Impl>
+PyTypeObject container_t<Impl>::type = empty_type();
+
+using vector_t       = container_t<vector_impl_t>;
+using flex_vector_t  = container_t<flex_vector_impl_t>;
+using int_vector_t   = container_t<int_vector_impl_t>;
+using float_vector_t = container_t<float_vector_impl_t>;
+using map_t          = container_t<map_impl_t>;
+using set_t          = container_t<set_impl_t>;
 
-vector_t* make_vector()
+template <typename W>
+W* as(PyObject* self)
 {
-    auto* v = PyObject_GC_New(vector_t, &vector_t::type);
-    new (&v->impl) vector_impl_t{};
-    v->in_weakreflist = nullptr;
-    PyObject_GC_Track((PyObject*) v);
-    return v;
+    return reinterpret_cast<W*>(self);
 }
 
-vector_t* make_vector(vector_impl_t&& impl)
+template <typename W>
+PyObject* make(typename W::impl_t impl)
 {
-    auto v = PyObject_GC_New(vector_t, &vector_t::type);
-    new (&v->impl) vector_impl_t{std::move(impl)};
+    auto gc = W::element_t::gc;
+    auto v  = gc ? PyObject_GC_New(W, &W::type) : PyObject_New(W, &W::type);
+    if (!v)
+        throw python_error{};
+    new (&v->impl) typename W::impl_t{std::move(impl)};
     v->in_weakreflist = nullptr;
-    PyObject_GC_Track((PyObject*) v);
-    return v;
+    if (gc)
+        PyObject_GC_Track((PyObject*) v);
+    return (PyObject*) v;
 }
 
-auto todo()
+template <typename W>
+void container_dealloc(W* self)
 {
-    PyErr_SetString(PyExc_RuntimeError, "immer: todo!");
-    return nullptr;
-}
+    using impl_t = typename W::impl_t;
 
-void vector_dealloc(vector_t* self)
-{
     if (self->in_weakreflist != nullptr)
         PyObject_ClearWeakRefs((PyObject*) self);
 
-    PyObject_GC_UnTrack((PyObject*) self);
-    Py_TRASHCAN_SAFE_BEGIN(self);
-
-    self->impl.~vector_impl_t();
-
-    PyObject_GC_Del(self);
-    Py_TRASHCAN_SAFE_END(self);
+    if (W::element_t::gc) {
+        PyObject_GC_UnTrack((PyObject*) self);
+        IMMER_PY_TRASHCAN_BEGIN(self, container_dealloc<W>);
+        self->impl.~impl_t();
+        PyObject_GC_Del(self);
+        IMMER_PY_TRASHCAN_END(self);
+    } else {
+        self->impl.~impl_t();
+        PyObject_Del(self);
+    }
 }
 
-PyObject* vector_to_list(vector_t* self)
+template <typename W>
+int container_traverse(W* self, visitproc visit, void* arg)
 {
-    auto list = PyList_New(self->impl.size());
-    auto idx  = 0;
-    immer::for_each(self->impl, [&](auto&& obj) {
-        auto o = obj.get();
-        Py_INCREF(o);
-        PyList_SET_ITEM(list, idx, o);
-        ++idx;
+    auto result = 0;
+    immer::for_each(self->impl, [&](auto&& x) {
+        if (!result)
+            result = visit_element(x, visit, arg);
     });
-    return list;
+    return result;
 }
 
-PyObject* vector_repr(vector_t* self)
+template <typename W>
+Py_ssize_t container_len(W* self)
 {
-    auto list      = vector_to_list(self);
-    auto list_repr = PyObject_Repr(list);
-    Py_DECREF(list);
+    return self->impl.size();
+}
 
-    if (!list_repr)
+PyObject* repr_of(PyObject* self, PyObject* contents)
+{
+    if (!contents)
+        return nullptr;
+    auto contents_repr = PyObject_Repr(contents);
+    Py_DECREF(contents);
+    if (!contents_repr)
         return nullptr;
 
 #if PY_MAJOR_VERSION >= 3
-    auto s = PyUnicode_FromFormat("%s%U%s", "immer.vector(", list_repr, ")");
-    Py_DECREF(list_repr);
+    auto s = PyUnicode_FromFormat(
+        "%s%s%U%s", Py_TYPE(self)->tp_name, "(", contents_repr, ")");
+    Py_DECREF(contents_repr);
 #else
-    auto s = PyString_FromString("immer.vector(");
-    PyString_ConcatAndDel(&s, list_repr);
+    auto s = PyString_FromFormat("%s(", Py_TYPE(self)->tp_name);
+    PyString_ConcatAndDel(&s, contents_repr);
     PyString_ConcatAndDel(&s, PyString_FromString(")"));
 #endif
     return s;
 }
 
-Py_ssize_t vector_len(vector_t* self) { return self->impl.size(); }
+// Calls `fn(item)` for every item of `iterable`, borrowing them.  Lists
+// and tuples are traversed directly, other iterables are converted to
+// a list first.
+template <typename Fn>
+void for_each_item(PyObject* iterable, Fn&& fn)
+{
+    auto seq = check(PySequence_Fast(iterable, "expected an iterable"));
+    try {
+        auto items = PySequence_Fast_ITEMS(seq);
+        auto size  = PySequence_Fast_GET_SIZE(seq);
+        for (auto i = Py_ssize_t{}; i < size; ++i)
+            fn(items[i]);
+    } catch (...) {
+        Py_DECREF(seq);
+        throw;
+    }
+    Py_DECREF(seq);
+}
 
-PyObject* vector_extend(vector_t* self, PyObject* iterable) { return todo(); }
+/*
+ * Sequences: Vector, FlexVector, IntVector and FloatVector.
+ */
 
-vector_t* vector_append(vector_t* self, PyObject* obj)
+template <typename W>
+std::size_t seq_index(W* self, Py_ssize_t pos)
 {
-    assert(obj != nullptr);
-    return make_vector(self->impl.push_back(object_t::adopt(obj)));
+    auto size = static_cast<Py_ssize_t>(self->impl.size());
+    if (pos < 0)
+        pos += size;
+    if (pos < 0 || pos >= size) {
+        PyErr_Format(PyExc_IndexError, "Index out of range: %zi", pos);
+        throw python_error{};
+    }
+    return pos;
 }
 
-vector_t* vector_set(vector_t* self, PyObject* args)
+// Appends the elements of `iterable` to `t`.  When the elements are
+// numbers and `iterable` provides a contiguous buffer of the same type,
+// like a `numpy` array, they are copied without creating any Python
+// object.
+template <typename Transient>
+void extend_transient(Transient& t, PyObject* iterable, std::false_type)
+{
+    using value_t = typename Transient::value_type;
+    using elem_t  = element<value_t>;
+    for_each_item(iterable,
+                  [&](PyObject* x) { t.push_back(elem_t::from_python(x)); });
+}
+
+template <typename Transient>
+void extend_transient(Transient& t, PyObject* iterable, std::true_type)
+{
+    using value_t = typename Transient::value_type;
+    using elem_t  = element<value_t>;
+    if (PyObject_CheckBuffer(iterable)) {
+        auto view = Py_buffer{};
+        if (PyObject_GetBuffer(
+                iterable, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+            throw python_error{};
+        auto fmt = view.format ? view.format : "B";
+        if (*fmt == '@' || *fmt == '=')
+            ++fmt;
+        if (view.itemsize == sizeof(value_t) && elem_t::native_format(*fmt) &&
+            !fmt[1]) {
+            auto data = static_cast<const value_t*>(view.buf);
+            auto size = view.len / view.itemsize;
+            for (auto i = Py_ssize_t{}; i < size; ++i)
+                t.push_back(data[i]);
+            PyBuffer_Release(&view);
+            return;
+        }
+        PyBuffer_Release(&view);
+    }
+    extend_transient(t, iterable, std::false_type{});
+}
+
+template <typename Transient>
+void extend_transient(Transient& t, PyObject* iterable)
+{
+    using value_t = typename Transient::value_type;
+    extend_transient(t, iterable, std::is_arithmetic<value_t>{});
+}
+
+template <typename W>
+PyObject* seq_from_iterable(PyObject* cls, PyObject* iterable)
+{
+    return guard([&] {
+        auto t = typename W::impl_t{}.transient();
+        extend_transient(t, iterable);
+        return make<W>(t.persistent());
+    });
+}
+
+template <typename W>
+PyObject* seq_new(PyTypeObject* subtype, PyObject* args, PyObject* kwds)
+{
+    PyObject* iterable = nullptr;
+    if (!PyArg_ParseTuple(args, "|O", &iterable))
+        return nullptr;
+    return iterable ? seq_from_iterable<W>(nullptr, iterable)
+                    : guard([] { return make<W>({}); });
+}
+
+template <typename W>
+PyObject* seq_to_list(W* self)
+{
+    return guard([&] {
+        auto list = check(PyList_New(self->impl.size()));
+        auto idx  = Py_ssize_t{};
+        try {
+            immer::for_each(self->impl, [&](auto&& x) {
+                PyList_SET_ITEM(list, idx, W::element_t::to_python(x));
+                ++idx;
+            });
+        } catch (...) {
+            Py_DECREF(list);
+            throw;
+        }
+        return list;
+    });
+}
+
+template <typename W>
+PyObject* seq_repr(W* self)
+{
+    return repr_of((PyObject*) self, seq_to_list(self));
+}
+
+template <typename W>
+PyObject* seq_iter(W* self)
+{
+    auto list = seq_to_list(self);
+    if (!list)
+        return nullptr;
+    auto it = PyObject_GetIter(list);
+    Py_DECREF(list);
+    return it;
+}
+
+template <typename W>
+PyObject* seq_extend(W* self, PyObject* iterable)
+{
+    return guard([&] {
+        auto t = self->impl.transient();
+        extend_transient(t, iterable);
+        return make<W>(t.persistent());
+    });
+}
+
+template <typename W>
+PyObject* seq_append(W* self, PyObject* obj)
+{
+    return guard([&] {
+        return make<W>(self->impl.push_back(W::element_t::from_python(obj)));
+    });
+}
+
+template <typename W>
+PyObject* seq_set(W* self, PyObject* args)
 {
     PyObject* obj = nullptr;
     Py_ssize_t pos;
@@ -196,154 +565,625 @@ vector_t* vector_set(vector_t* self, PyObject* args)
     if (!PyArg_ParseTuple(args, "nO", &pos, &obj)) {
         return nullptr;
     }
-    if (pos < 0)
-        pos += self->impl.size();
-    if (pos < 0 || pos > (Py_ssize_t) self->impl.size()) {
-        PyErr_Format(PyExc_IndexError, "Index out of range: %zi", pos);
-        return nullptr;
-    }
-    return make_vector(self->impl.set(pos, object_t::adopt(obj)));
+    return guard([&] {
+        auto idx = seq_index(self, pos);
+        return make<W>(self->impl.set(idx, W::element_t::from_python(obj)));
+    });
 }
 
-PyObject* vector_new(PyTypeObject* subtype, PyObject* args, PyObject* kwds)
+template <typename W>
+PyObject* seq_get_item(W* self, Py_ssize_t pos)
 {
-    Py_INCREF(empty_vector);
-    return (PyObject*) empty_vector;
+    return guard([&] {
+        return W::element_t::to_python(self->impl[seq_index(self, pos)]);
+    });
 }
 
-long vector_hash(vector_t* self)
+template <typename W>
+PyObject* seq_slice(W* self, Py_ssize_t start, Py_ssize_t stop, std::true_type)
 {
-    todo();
-    return 0;
+    return make<W>(self->impl.take(stop).drop(start));
 }
 
-PyObject* vector_get_item(vector_t* self, Py_ssize_t pos)
+template <typename W>
+PyObject*
+seq_slice(W* self, Py_ssize_t start, Py_ssize_t stop, std::false_type)
 {
-    if (pos < 0)
-        pos += self->impl.size();
-    if (pos < 0 || pos >= (Py_ssize_t) self->impl.size()) {
-        PyErr_Format(PyExc_IndexError, "Index out of range: %zi", pos);
-        return nullptr;
-    }
-    auto r = self->impl[pos];
-    return r.release();
+    auto t = typename W::impl_t{}.transient();
+    for (auto i = start; i < stop; ++i)
+        t.push_back(self->impl[i]);
+    return make<W>(t.persistent());
 }
 
-PyObject* vector_subscript(vector_t* self, PyObject* item)
+template <typename W>
+PyObject* seq_subscript(W* self, PyObject* item)
 {
     if (PyIndex_Check(item)) {
         auto i = PyNumber_AsSsize_t(item, PyExc_IndexError);
         if (i == -1 && PyErr_Occurred())
             return nullptr;
-        return vector_get_item(self, i);
+        return seq_get_item(self, i);
     } else if (PySlice_Check(item)) {
-        return todo();
+        Py_ssize_t start, stop, step;
+        if (PySlice_Unpack(item, &start, &stop, &step) < 0)
+            return nullptr;
+        auto n = PySlice_AdjustIndices(self->impl.size(), &start, &stop, step);
+        return guard([&] {
+            if (step == 1)
+                return seq_slice(self, start, stop, is_flex<typename W::impl_t>{});
+            auto t = typename W::impl_t{}.transient();
+            for (auto i = Py_ssize_t{}; i < n; ++i)
+                t.push_back(self->impl[start + i * step]);
+            return make<W>(t.persistent());
+        });
     } else {
         PyErr_Format(PyExc_TypeError,
-                     "vector indices must be integers, not %.200s",
+                     "%.200s indices must be integers, not %.200s",
+                     Py_TYPE(self)->tp_name,
                      Py_TYPE(item)->tp_name);
         return nullptr;
     }
 }
 
-PyObject* vector_repeat(vector_t* self, Py_ssize_t n) { return todo(); }
+template <typename W>
+PyObject* seq_concat_impl(W* self, PyObject* other, std::true_type)
+{
+    if (Py_TYPE(other) == &W::type)
+        return guard(
+            [&] { return make<W>(self->impl + as<W>(other)->impl); });
+    return seq_extend(self, other);
+}
 
-int vector_traverse(vector_t* self, visitproc visit, void* arg)
+template <typename W>
+PyObject* seq_concat_impl(W* self, PyObject* other, std::false_type)
 {
-    auto result = 0;
-    immer::all_of(self->impl, [&](auto&& o) {
-        return 0 == (result = [&] {
-                   Py_VISIT(o.get());
-                   return 0;
-               }());
+    return seq_extend(self, other);
+}
+
+template <typename W>
+PyObject* seq_concat(W* self, PyObject* other)
+{
+    return seq_concat_impl(self, other, is_flex<typename W::impl_t>{});
+}
+
+template <typename W>
+PyObject* seq_push_front(W* self, PyObject* obj)
+{
+    return guard([&] {
+        return make<W>(
+            self->impl.push_front(W::element_t::from_python(obj)));
+    });
+}
+
+template <typename W>
+PyObject* seq_insert(W* self, PyObject* args)
+{
+    PyObject* obj = nullptr;
+    Py_ssize_t pos;
+    if (!PyArg_ParseTuple(args, "nO", &pos, &obj))
+        return nullptr;
+    return guard([&] {
+        auto size = static_cast<Py_ssize_t>(self->impl.size());
+        auto idx  = pos < 0 ? std::max(pos + size, Py_ssize_t{})
+                            : std::min(pos, size);
+        return make<W>(
+            self->impl.insert(idx, W::element_t::from_python(obj)));
     });
-    return result;
 }
 
-PyObject* vector_richcompare(PyObject* v, PyObject* w, int op)
+template <typename W>
+PyObject* seq_erase(W* self, PyObject* arg)
 {
-    return todo();
+    auto pos = PyNumber_AsSsize_t(arg, PyExc_IndexError);
+    if (pos == -1 && PyErr_Occurred())
+        return nullptr;
+    return guard(
+        [&] { return make<W>(self->impl.erase(seq_index(self, pos))); });
 }
 
-PyObject* vector_iter(PyObject* self) { return todo(); }
+template <typename W>
+PyObject* seq_take(W* self, PyObject* arg)
+{
+    auto n = PyNumber_AsSsize_t(arg, PyExc_OverflowError);
+    if (n == -1 && PyErr_Occurred())
+        return nullptr;
+    return guard(
+        [&] { return make<W>(self->impl.take(std::max(n, Py_ssize_t{}))); });
+}
 
-PyMethodDef vector_methods[] = {
-    {"append", (PyCFunction) vector_append, METH_O, "Appends an element"},
-    {"set",
-     (PyCFunction) vector_set,
-     METH_VARARGS,
-     "Inserts an element at the specified position"},
-    {"extend", (PyCFunction) vector_extend, METH_O | METH_COEXIST, "Extend"},
-    {"tolist", (PyCFunction) vector_to_list, METH_NOARGS, "Convert to list"},
-    {0}};
+template <typename W>
+PyObject* seq_drop(W* self, PyObject* arg)
+{
+    auto n = PyNumber_AsSsize_t(arg, PyExc_OverflowError);
+    if (n == -1 && PyErr_Occurred())
+        return nullptr;
+    return guard(
+        [&] { return make<W>(self->impl.drop(std::max(n, Py_ssize_t{}))); });
+}
 
-PyMemberDef vector_members[] = {
-    {0} /* sentinel */
-};
+/*
+ * Read-only view of the contiguous elements of one leaf of a typed
+ * vector, exposed through the buffer protocol.  It keeps the vector
+ * alive.
+ */
 
-PySequenceMethods vector_sequence_methods = {
-    (lenfunc) vector_len,           /* sq_length */
-    (binaryfunc) vector_extend,     /* sq_concat */
-    (ssizeargfunc) vector_repeat,   /* sq_repeat */
-    (ssizeargfunc) vector_get_item, /* sq_item */
-    0,                              /* sq_slice */
-    0,                              /* sq_ass_item */
-    0,                              /* sq_ass_slice */
-    0,                              /* sq_contains */
-    0,                              /* sq_inplace_concat */
-    0,                              /* sq_inplace_repeat */
+struct chunk_t
+{
+    PyObject_HEAD PyObject* owner;
+    void* data;
+    const char* format;
+    Py_ssize_t size;
+    Py_ssize_t itemsize;
+
+    static PyTypeObject type;
 };
 
-PyMappingMethods vector_mapping_methods = {
-    (lenfunc) vector_len, (binaryfunc) vector_subscript, 0};
-
-PyTypeObject vector_t::type = {
-    PyVarObject_HEAD_INIT(NULL, 0) "immer.Vector", /* tp_name        */
-    sizeof(vector_t),                              /* tp_basicsize   */
-    0,                                             /* tp_itemsize    */
-    (destructor) vector_dealloc,                   /* tp_dealloc     */
-    0,                                             /* tp_print       */
-    0,                                             /* tp_getattr     */
-    0,                                             /* tp_setattr     */
-    0,                                             /* tp_compare     */
-    (reprfunc) vector_repr,                        /* tp_repr        */
-    0,                                             /* tp_as_number   */
-    &vector_sequence_methods,                      /* tp_as_sequence */
-    &vector_mapping_methods,                       /* tp_as_mapping  */
-    (hashfunc) vector_hash,                        /* tp_hash        */
-    0,                                             /* tp_call        */
-    0,                                             /* tp_str         */
-    0,                                             /* tp_getattro    */
-    0,                                             /* tp_setattro    */
-    0,                                             /* tp_as_buffer   */
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,       /* tp_flags       */
-    "",                                            /* tp_doc         */
-    (traverseproc) vector_traverse,                /* tp_traverse       */
-    0,                                             /* tp_clear          */
-    vector_richcompare,                            /* tp_richcompare    */
-    offsetof(vector_t, in_weakreflist),            /* tp_weaklistoffset */
-    vector_iter,                                   /* tp_iter           */
-    0,                                             /* tp_iternext       */
-    vector_methods,                                /* tp_methods        */
-    vector_members,                                /* tp_members        */
-    0,                                             /* tp_getset         */
-    0,                                             /* tp_base           */
-    0,                                             /* tp_dict           */
-    0,                                             /* tp_descr_get      */
-    0,                                             /* tp_descr_set      */
-    0,                                             /* tp_dictoffset     */
-    0,                                             /* tp_init           */
-    0,                                             /* tp_alloc */
-    vector_new,                                    /* tp_new   */
+PyTypeObject chunk_t::type = empty_type();
+
+void chunk_dealloc(chunk_t* self)
+{
+    Py_DECREF(self->owner);
+    PyObject_Del(self);
+}
+
+Py_ssize_t chunk_len(chunk_t* self) { return self->size; }
+
+int chunk_getbuffer(chunk_t* self, Py_buffer* view, int flags)
+{
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "immer chunks are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    view->obj = (PyObject*) self;
+    Py_INCREF(self);
+    view->buf        = self->data;
+    view->len        = self->size * self->itemsize;
+    view->readonly   = 1;
+    view->itemsize   = self->itemsize;
+    view->format     = (flags & PyBUF_FORMAT) ? (char*) self->format : nullptr;
+    view->ndim       = 1;
+    view->shape      = (flags & PyBUF_ND) ? &self->size : nullptr;
+    view->strides    = (flags & PyBUF_STRIDES) ? &self->itemsize : nullptr;
+    view->suboffsets = nullptr;
+    view->internal   = nullptr;
+    return 0;
+}
+
+PyBufferProcs chunk_buffer_methods = {
+    slot<getbufferproc>(chunk_getbuffer), /* bf_getbuffer */
+    0,                               /* bf_releasebuffer */
 };
 
+template <typename W>
+PyObject* seq_chunks(W* self)
+{
+    using value_t = typename W::impl_t::value_type;
+    return guard([&] {
+        auto list = check(PyList_New(0));
+        try {
+            immer::for_each_chunk(self->impl, [&](auto first, auto last) {
+                auto c = PyObject_New(chunk_t, &chunk_t::type);
+                if (!c)
+                    throw python_error{};
+                Py_INCREF(self);
+                c->owner    = (PyObject*) self;
+                c->data     = const_cast<value_t*>(first);
+                c->format   = W::element_t::format();
+                c->size     = last - first;
+                c->itemsize = sizeof(value_t);
+                auto r      = PyList_Append(list, (PyObject*) c);
+                Py_DECREF(c);
+                if (r < 0)
+                    throw python_error{};
+            });
+        } catch (...) {
+            Py_DECREF(list);
+            throw;
+        }
+        return list;
+    });
+}
+
+/*
+ * Map and Set
+ */
+
+template <typename W>
+PyObject* map_from_iterable(PyObject* cls, PyObject* iterable)
+{
+    return guard([&] {
+        auto t = typename W::impl_t{}.transient();
+        if (PyDict_Check(iterable)) {
+            PyObject *key, *value;
+            auto pos = Py_ssize_t{};
+            while (PyDict_Next(iterable, &pos, &key, &value))
+                t.set(object_t::adopt(key), object_t::adopt(value));
+        } else {
+            for_each_item(iterable, [&](PyObject* item) {
+                PyObject *key, *value;
+                if (!PyArg_ParseTuple(item, "OO", &key, &value))
+                    throw python_error{};
+                t.set(object_t::adopt(key), object_t::adopt(value));
+            });
+        }
+        return make<W>(t.persistent());
+    });
+}
+
+template <typename W>
+PyObject* map_new(PyTypeObject* subtype, PyObject* args, PyObject* kwds)
+{
+    PyObject* iterable = nullptr;
+    if (!PyArg_ParseTuple(args, "|O", &iterable))
+        return nullptr;
+    return iterable ? map_from_iterable<W>(nullptr, iterable)
+                    : guard([] { return make<W>({}); });
+}
+
+template <typename W>
+PyObject* map_to_dict(W* self)
+{
+    return guard([&] {
+        auto dict = check(PyDict_New());
+        for (auto&& kv : self->impl) {
+            if (PyDict_SetItem(dict, kv.first.get(), kv.second.get()) < 0) {
+                Py_DECREF(dict);
+                throw python_error{};
+            }
+        }
+        return dict;
+    });
+}
+
+template <typename W, typename Fn>
+PyObject* map_list(W* self, Fn&& fn)
+{
+    return guard([&] {
+        auto list = check(PyList_New(self->impl.size()));
+        auto idx  = Py_ssize_t{};
+        for (auto&& kv : self->impl) {
+            auto x = fn(kv);
+            if (!x) {
+                Py_DECREF(list);
+                throw python_error{};
+            }
+            PyList_SET_ITEM(list, idx++, x);
+        }
+        return list;
+    });
+}
+
+template <typename W>
+PyObject* map_keys(W* self)
+{
+    return map_list(self, [](auto&& kv) {
+        Py_INCREF(kv.first.get());
+        return kv.first.get();
+    });
+}
+
+template <typename W>
+PyObject* map_values(W* self)
+{
+    return map_list(self, [](auto&& kv) {
+        Py_INCREF(kv.second.get());
+        return kv.second.get();
+    });
+}
+
+template <typename W>
+PyObject* map_items(W* self)
+{
+    return map_list(self, [](auto&& kv) {
+        return PyTuple_Pack(2, kv.first.get(), kv.second.get());
+    });
+}
+
+template <typename W>
+PyObject* map_repr(W* self)
+{
+    return repr_of((PyObject*) self, map_to_dict(self));
+}
+
+template <typename W>
+PyObject* map_iter(W* self)
+{
+    auto keys = map_keys(self);
+    if (!keys)
+        return nullptr;
+    auto it = PyObject_GetIter(keys);
+    Py_DECREF(keys);
+    return it;
+}
+
+template <typename W>
+PyObject* map_subscript(W* self, PyObject* key)
+{
+    return guard([&] {
+        auto p = self->impl.find(object_t::adopt(key));
+        if (!p) {
+            PyErr_SetObject(PyExc_KeyError, key);
+            throw python_error{};
+        }
+        return element<object_t>::to_python(*p);
+    });
+}
+
+template <typename W>
+PyObject* map_get(W* self, PyObject* args)
+{
+    PyObject* key = nullptr;
+    PyObject* def = Py_None;
+    if (!PyArg_ParseTuple(args, "O|O", &key, &def))
+        return nullptr;
+    return guard([&] {
+        auto p = self->impl.find(object_t::adopt(key));
+        auto r = p ? p->get() : def;
+        Py_INCREF(r);
+        return r;
+    });
+}
+
+template <typename W>
+int container_contains(W* self, PyObject* key)
+{
+    auto r = 0;
+    auto ok = guard([&] {
+        r = self->impl.count(object_t::adopt(key));
+        return Py_None;
+    });
+    return ok ? r : -1;
+}
+
+template <typename W>
+PyObject* map_set(W* self, PyObject* args)
+{
+    PyObject* key   = nullptr;
+    PyObject* value = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &key, &value))
+        return nullptr;
+    return guard([&] {
+        return make<W>(
+            self->impl.set(object_t::adopt(key), object_t::adopt(value)));
+    });
+}
+
+template <typename W>
+PyObject* container_erase(W* self, PyObject* key)
+{
+    return guard(
+        [&] { return make<W>(self->impl.erase(object_t::adopt(key))); });
+}
+
+template <typename W>
+PyObject* set_from_iterable(PyObject* cls, PyObject* iterable)
+{
+    return guard([&] {
+        auto t = typename W::impl_t{}.transient();
+        for_each_item(iterable,
+                      [&](PyObject* x) { t.insert(object_t::adopt(x)); });
+        return make<W>(t.persistent());
+    });
+}
+
+template <typename W>
+PyObject* set_new(PyTypeObject* subtype, PyObject* args, PyObject* kwds)
+{
+    PyObject* iterable = nullptr;
+    if (!PyArg_ParseTuple(args, "|O", &iterable))
+        return nullptr;
+    return iterable ? set_from_iterable<W>(nullptr, iterable)
+                    : guard([] { return make<W>({}); });
+}
+
+template <typename W>
+PyObject* set_insert(W* self, PyObject* obj)
+{
+    return guard(
+        [&] { return make<W>(self->impl.insert(object_t::adopt(obj))); });
+}
+
+/*
+ * Types
+ */
+
+#define IMMER_PY_SEQ_METHODS(W)                                                \
+    {"append", method(seq_append<W>), METH_O, "Appends an element"},     \
+        {"set",                                                                \
+         method(seq_set<W>),                                             \
+         METH_VARARGS,                                                         \
+         "Replaces the element at the specified position"},                    \
+        {"extend",                                                             \
+         method(seq_extend<W>),                                          \
+         METH_O,                                                               \
+         "Appends all the elements of an iterable"},                           \
+        {"tolist",                                                             \
+         method(seq_to_list<W>),                                         \
+         METH_NOARGS,                                                          \
+         "Convert to list"},                                                   \
+        {"to_list",                                                            \
+         method(seq_to_list<W>),                                         \
+         METH_NOARGS,                                                          \
+         "Convert to list"},                                                   \
+        {"from_iterable",                                                      \
+         method(seq_from_iterable<W>),                                   \
+         METH_O | METH_CLASS,                                                  \
+         "Creates a sequence with the elements of an iterable"}
+
+#define IMMER_PY_FLEX_METHODS(W)                                               \
+    {"push_front",                                                             \
+     method(seq_push_front<W>),                                          \
+     METH_O,                                                                   \
+     "Prepends an element"},                                                   \
+        {"insert",                                                             \
+         method(seq_insert<W>),                                          \
+         METH_VARARGS,                                                         \
+         "Inserts an element at the specified position"},                      \
+        {"erase",                                                              \
+         method(seq_erase<W>),                                           \
+         METH_O,                                                               \
+         "Removes the element at the specified position"},                     \
+        {"take",                                                               \
+         method(seq_take<W>),                                            \
+         METH_O,                                                               \
+         "Keeps only the first n elements"},                                   \
+        {"drop",                                                               \
+         method(seq_drop<W>),                                            \
+         METH_O,                                                               \
+         "Removes the first n elements"}
+
+PyMethodDef vector_methods[] = {IMMER_PY_SEQ_METHODS(vector_t), {nullptr, nullptr, 0, nullptr}};
+
+PyMethodDef flex_vector_methods[] = {IMMER_PY_SEQ_METHODS(flex_vector_t),
+                                     IMMER_PY_FLEX_METHODS(flex_vector_t),
+                                     {nullptr, nullptr, 0, nullptr}};
+
+PyMethodDef int_vector_methods[] = {
+    IMMER_PY_SEQ_METHODS(int_vector_t),
+    IMMER_PY_FLEX_METHODS(int_vector_t),
+    {"chunks",
+     method(seq_chunks<int_vector_t>),
+     METH_NOARGS,
+     "Returns buffers viewing the contiguous chunks of elements"},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyMethodDef float_vector_methods[] = {
+    IMMER_PY_SEQ_METHODS(float_vector_t),
+    IMMER_PY_FLEX_METHODS(float_vector_t),
+    {"chunks",
+     method(seq_chunks<float_vector_t>),
+     METH_NOARGS,
+     "Returns buffers viewing the contiguous chunks of elements"},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyMethodDef map_methods[] = {
+    {"set",
+     method(map_set<map_t>),
+     METH_VARARGS,
+     "Associates a value to a key"},
+    {"get",
+     method(map_get<map_t>),
+     METH_VARARGS,
+     "Returns the value of a key, or a default when missing"},
+    {"erase", method(container_erase<map_t>), METH_O, "Removes a key"},
+    {"keys", method(map_keys<map_t>), METH_NOARGS, "List of keys"},
+    {"values", method(map_values<map_t>), METH_NOARGS, "List of values"},
+    {"items",
+     method(map_items<map_t>),
+     METH_NOARGS,
+     "List of (key, value) tuples"},
+    {"to_dict", method(map_to_dict<map_t>), METH_NOARGS, "Convert to dict"},
+    {"from_iterable",
+     method(map_from_iterable<map_t>),
+     METH_O | METH_CLASS,
+     "Creates a map from a dict or an iterable of pairs"},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyMethodDef set_methods[] = {
+    {"insert", method(set_insert<set_t>), METH_O, "Adds an element"},
+    {"erase",
+     method(container_erase<set_t>),
+     METH_O,
+     "Removes an element"},
+    {"tolist", method(seq_to_list<set_t>), METH_NOARGS, "Convert to list"},
+    {"to_list",
+     method(seq_to_list<set_t>),
+     METH_NOARGS,
+     "Convert to list"},
+    {"from_iterable",
+     method(set_from_iterable<set_t>),
+     METH_O | METH_CLASS,
+     "Creates a set with the elements of an iterable"},
+    {nullptr, nullptr, 0, nullptr}};
+
+template <typename W>
+PySequenceMethods* seq_sequence_methods()
+{
+    static auto m  = PySequenceMethods{};
+    m.sq_length    = slot<lenfunc>(container_len<W>);
+    m.sq_concat    = slot<binaryfunc>(seq_concat<W>);
+    m.sq_item      = slot<ssizeargfunc>(seq_get_item<W>);
+    return &m;
+}
+
+template <typename W>
+PyMappingMethods seq_mapping_methods = {
+    slot<lenfunc>(container_len<W>), slot<binaryfunc>(seq_subscript<W>), 0};
+
+template <typename W>
+PySequenceMethods* contains_sequence_methods()
+{
+    static auto m = PySequenceMethods{};
+    m.sq_length   = slot<lenfunc>(container_len<W>);
+    m.sq_contains = slot<objobjproc>(container_contains<W>);
+    return &m;
+}
+
+PyMappingMethods map_mapping_methods = {
+    slot<lenfunc>(container_len<map_t>), slot<binaryfunc>(map_subscript<map_t>), 0};
+
+template <typename W>
+int init_type(const char* name,
+              PyMethodDef* methods,
+              newfunc new_fn,
+              reprfunc repr,
+              getiterfunc iter)
+{
+    auto& t         = W::type;
+    t.tp_name       = name;
+    t.tp_basicsize  = sizeof(W);
+    t.tp_dealloc    = slot<destructor>(container_dealloc<W>);
+    t.tp_repr       = repr;
+    t.tp_hash       = PyObject_HashNotImplemented;
+    t.tp_flags      = Py_TPFLAGS_DEFAULT;
+    t.tp_weaklistoffset = offsetof(W, in_weakreflist);
+    t.tp_iter       = iter;
+    t.tp_methods    = methods;
+    t.tp_new        = new_fn;
+    if (W::element_t::gc) {
+        t.tp_flags |= Py_TPFLAGS_HAVE_GC;
+        t.tp_traverse = slot<traverseproc>(container_traverse<W>);
+    }
+    return PyType_Ready(&t);
+}
+
+template <typename W>
+int init_seq_type(const char* name, PyMethodDef* methods)
+{
+    W::type.tp_as_sequence = seq_sequence_methods<W>();
+    W::type.tp_as_mapping  = &seq_mapping_methods<W>;
+    return init_type<W>(name,
+                        methods,
+                        seq_new<W>,
+                        slot<reprfunc>(seq_repr<W>),
+                        slot<getiterfunc>(seq_iter<W>));
+}
+
+int init_chunk_type()
+{
+    static auto sequence_methods = PySequenceMethods{};
+    sequence_methods.sq_length   = slot<lenfunc>(chunk_len);
+    auto& t          = chunk_t::type;
+    t.tp_name        = "immer.Chunk";
+    t.tp_basicsize   = sizeof(chunk_t);
+    t.tp_dealloc     = slot<destructor>(chunk_dealloc);
+    t.tp_as_sequence = &sequence_methods;
+    t.tp_as_buffer   = &chunk_buffer_methods;
+    t.tp_flags       = Py_TPFLAGS_DEFAULT;
+    t.tp_doc         = "Read-only buffer viewing a chunk of a typed vector";
+    return PyType_Ready(&t);
+}
+
+PyMethodDef module_methods[] = {{nullptr, nullptr, 0, nullptr}};
+
 #if PY_MAJOR_VERSION >= 3
 struct PyModuleDef module_def = {
     PyModuleDef_HEAD_INIT,
     "immer_python_module", /* m_name */
     "",                    /* m_doc */
     -1,                    /* m_size */
-    / module_methods,      /* m_methods */
+    module_methods,        /* m_methods */
     0,                     /* m_reload */
     0,                     /* m_traverse */
     0,                     /* m_clear */
@@ -351,11 +1191,36 @@ struct PyModuleDef module_def = {
 };
 #endif
 
-PyMethodDef module_methods[] = {{0, 0, 0, 0}};
+int add_type(PyObject* m, const char* name, PyTypeObject* type)
+{
+    Py_INCREF(type);
+    return PyModule_AddObject(m, name, (PyObject*) type);
+}
 
 PyObject* module_init()
 {
-    if (PyType_Ready(&vector_t::type) < 0)
+    map_t::type.tp_as_sequence = contains_sequence_methods<map_t>();
+    map_t::type.tp_as_mapping  = &map_mapping_methods;
+    set_t::type.tp_as_sequence = contains_sequence_methods<set_t>();
+
+    if (init_seq_type<vector_t>("immer.Vector", vector_methods) < 0 ||
+        init_seq_type<flex_vector_t>("immer.FlexVector",
+                                     flex_vector_methods) < 0 ||
+        init_seq_type<int_vector_t>("immer.IntVector", int_vector_methods) <
+            0 ||
+        init_seq_type<float_vector_t>("immer.FloatVector",
+                                      float_vector_methods) < 0 ||
+        init_type<map_t>("immer.Map",
+                         map_methods,
+                         map_new<map_t>,
+                         slot<reprfunc>(map_repr<map_t>),
+                         slot<getiterfunc>(map_iter<map_t>)) < 0 ||
+        init_type<set_t>("immer.Set",
+                         set_methods,
+                         set_new<set_t>,
+                         slot<reprfunc>(seq_repr<set_t>),
+                         slot<getiterfunc>(seq_iter<set_t>)) < 0 ||
+        init_chunk_type() < 0)
         return nullptr;
 
 #if PY_MAJOR_VERSION >= 3
@@ -366,11 +1231,14 @@ PyObject* module_init()
     if (!m)
         return nullptr;
 
-    if (!empty_vector)
-        empty_vector = make_vector();
-
-    Py_INCREF(&vector_t::type);
-    PyModule_AddObject(m, "Vector", (PyObject*) &vector_t::type);
+    if (add_type(m, "Vector", &vector_t::type) < 0 ||
+        add_type(m, "FlexVector", &flex_vector_t::type) < 0 ||
+        add_type(m, "IntVector", &int_vector_t::type) < 0 ||
+        add_type(m, "FloatVector", &float_vector_t::type) < 0 ||
+        add_type(m, "Map", &map_t::type) < 0 ||
+        add_type(m, "Set", &set_t::type) < 0 ||
+        add_type(m, "Chunk", &chunk_t::type) < 0)
+        return nullptr;
     return m;
 }
 
@@ -0,0 +1,344 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/arrays/adaptive.hpp>
+#include <immer/detail/arrays/adaptive_iterator.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <cstddef>
+
+namespace immer {
+
+/*!
+ * Number of elements up to which an `adaptive_array` uses contiguous
+ * storage by default.
+ */
+constexpr std::size_t default_adaptive_threshold = 64;
+
+/*!
+ * Immutable sequential container that behaves like an `array` while
+ * it is small and like a `vector` when it grows big.
+ *
+ * @tparam T The type of the values to be stored in the container.
+ * @tparam MemoryPolicy Memory management policy. See @ref
+ *         memory_policy.
+ * @tparam Threshold Maximum number of elements kept in contiguous
+ *         memory.
+ *
+ * @rst
+ *
+ * While it holds at most ``Threshold`` elements, the elements are
+ * stored in contiguous memory, ``data()`` returns a pointer to them
+ * and every update copies the whole sequence, like in an ``array``.
+ * When it grows beyond the threshold it is converted to a radix
+ * balanced tree, ``data()`` returns ``nullptr`` and updates are
+ * :math:`O(log(size))`, like in a ``vector``.  It is converted back to
+ * contiguous memory only when shrinking to half of the threshold,
+ * such that taking and pushing around the threshold does not convert
+ * the whole sequence every time.
+ *
+ * .. tip:: Use this container for sequences that are usually short
+ *    but that may occasionally grow into the thousands, where an
+ *    ``array`` would make every update copy the whole thing.
+ *
+ * @endrst
+ */
+template <typename T,
+          typename MemoryPolicy  = default_memory_policy,
+          std::size_t Threshold  = default_adaptive_threshold,
+          detail::rbts::bits_t B = default_bits,
+          detail::rbts::bits_t BL =
+              detail::rbts::derive_bits_leaf<T, MemoryPolicy, B>>
+class adaptive_array
+{
+    using impl_t =
+        detail::arrays::adaptive<T, MemoryPolicy, Threshold, B, BL>;
+
+    using move_t =
+        std::integral_constant<bool, MemoryPolicy::use_transient_rvalues>;
+
+public:
+    static constexpr std::size_t threshold = Threshold;
+    static constexpr auto bits             = B;
+    static constexpr auto bits_leaf        = BL;
+
+    using value_type      = T;
+    using reference       = const T&;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const T&;
+
+    using iterator =
+        detail::arrays::adaptive_iterator<T, MemoryPolicy, Threshold, B, BL>;
+    using const_iterator   = iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    using memory_policy = MemoryPolicy;
+
+    /*!
+     * Default constructor.  It creates an array of `size() == 0`.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    adaptive_array() = default;
+
+    /*!
+     * Constructs an array containing the elements in `values`.
+     */
+    adaptive_array(std::initializer_list<T> values)
+        : impl_{impl_t::from_initializer_list(values)}
+    {}
+
+    /*!
+     * Constructs an array containing the elements in the range
+     * defined by the forward iterator `first` and range sentinel `last`.
+     */
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<detail::compatible_sentinel_v<Iter, Sent> &&
+                                   detail::is_forward_iterator_v<Iter>,
+                               bool> = true>
+    adaptive_array(Iter first, Sent last)
+        : impl_{impl_t::from_range(first, last)}
+    {}
+
+    /*!
+     * Constructs an array containing the element `val` repeated `n`
+     * times.
+     */
+    adaptive_array(size_type n, T v = {})
+        : impl_{impl_t::from_fill(n, v)}
+    {}
+
+    /*!
+     * Returns an iterator pointing at the first element of the
+     * collection. It does not allocate memory and its complexity is
+     * @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD iterator begin() const { return {impl_}; }
+
+    /*!
+     * Returns an iterator pointing just after the last element of the
+     * collection. It does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD iterator end() const
+    {
+        return {impl_, typename iterator::end_t{}};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing at the first element of the reversed collection. It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD reverse_iterator rbegin() const
+    {
+        return reverse_iterator{end()};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing after the last element of the reversed collection. It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD reverse_iterator rend() const
+    {
+        return reverse_iterator{begin()};
+    }
+
+    /*!
+     * Returns the number of elements in the container.  It does
+     * not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD size_type size() const { return impl_.size(); }
+
+    /*!
+     * Returns `true` if there are no elements in the container.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD bool empty() const { return size() == 0; }
+
+    /*!
+     * Returns `true` when the elements are stored in contiguous
+     * memory, which is the case at least while @f$ size() \leq
+     * Threshold @f$.
+     */
+    IMMER_NODISCARD bool is_flat() const { return impl_.is_flat; }
+
+    /*!
+     * Access the raw data when the array is flat, or `nullptr`
+     * otherwise.
+     */
+    IMMER_NODISCARD const T* data() const { return impl_.data(); }
+
+    /*!
+     * Access the last element.
+     */
+    IMMER_NODISCARD const T& back() const { return impl_.get(size() - 1); }
+
+    /*!
+     * Access the first element.
+     */
+    IMMER_NODISCARD const T& front() const { return impl_.get(0); }
+
+    /*!
+     * Returns a `const` reference to the element at position `index`.
+     * It is undefined when @f$ index \geq size() @f$.  It does not
+     * allocate memory and its complexity is *effectively* @f$ O(1)
+     * @f$.
+     */
+    IMMER_NODISCARD reference operator[](size_type index) const
+    {
+        return impl_.get(index);
+    }
+
+    /*!
+     * Returns a `const` reference to the element at position
+     * `index`. It throws an `std::out_of_range` exception when @f$
+     * index \geq size() @f$.  It does not allocate memory and its
+     * complexity is *effectively* @f$ O(1) @f$.
+     */
+    reference at(size_type index) const { return impl_.get_check(index); }
+
+    /*!
+     * Returns whether the arrays are equal, no matter whether they
+     * are flat or not.
+     */
+    IMMER_NODISCARD bool operator==(const adaptive_array& other) const
+    {
+        return impl_.equals(other.impl_);
+    }
+    IMMER_NODISCARD bool operator!=(const adaptive_array& other) const
+    {
+        return !(*this == other);
+    }
+
+    /*!
+     * Returns an array with `value` inserted at the end.  It may
+     * allocate memory and its complexity is @f$ O(size) @f$ while
+     * flat and *effectively* @f$ O(1) @f$ otherwise.  Pushing past
+     * the threshold converts the array into a tree.
+     */
+    IMMER_NODISCARD adaptive_array push_back(value_type value) const&
+    {
+        return impl_.push_back(std::move(value));
+    }
+
+    IMMER_NODISCARD decltype(auto) push_back(value_type value) &&
+    {
+        return push_back_move(move_t{}, std::move(value));
+    }
+
+    /*!
+     * Returns an array containing value `value` at position `idx`.
+     * Undefined for `index >= size()`.  It may allocate memory and
+     * its complexity is @f$ O(size) @f$ while flat and *effectively*
+     * @f$ O(1) @f$ otherwise.
+     */
+    IMMER_NODISCARD adaptive_array set(size_type index,
+                                       value_type value) const&
+    {
+        return impl_.assoc(index, std::move(value));
+    }
+
+    IMMER_NODISCARD decltype(auto) set(size_type index, value_type value) &&
+    {
+        return set_move(move_t{}, index, std::move(value));
+    }
+
+    /*!
+     * Returns an array containing the result of the expression
+     * `fn((*this)[idx])` at position `idx`.  Undefined for `index >=
+     * size()`.  It may allocate memory and its complexity is @f$
+     * O(size) @f$ while flat and *effectively* @f$ O(1) @f$
+     * otherwise.
+     */
+    template <typename FnT>
+    IMMER_NODISCARD adaptive_array update(size_type index, FnT&& fn) const&
+    {
+        return impl_.update(index, std::forward<FnT>(fn));
+    }
+
+    template <typename FnT>
+    IMMER_NODISCARD decltype(auto) update(size_type index, FnT&& fn) &&
+    {
+        return update_move(move_t{}, index, std::forward<FnT>(fn));
+    }
+
+    /*!
+     * Returns an array containing only the first `min(elems, size())`
+     * elements.  When the result has at most half of the threshold
+     * elements it is flat again, which copies them.  Otherwise, it
+     * may allocate memory and its complexity is *effectively* @f$
+     * O(1) @f$.
+     */
+    IMMER_NODISCARD adaptive_array take(size_type elems) const&
+    {
+        return impl_.take(elems);
+    }
+
+    IMMER_NODISCARD decltype(auto) take(size_type elems) &&
+    {
+        return take_move(move_t{}, elems);
+    }
+
+    // Semi-private
+    const impl_t& impl() const { return impl_; }
+
+private:
+    adaptive_array(impl_t impl)
+        : impl_(std::move(impl))
+    {}
+
+    adaptive_array&& push_back_move(std::true_type, value_type value)
+    {
+        impl_.push_back_mut({}, std::move(value));
+        return std::move(*this);
+    }
+    adaptive_array push_back_move(std::false_type, value_type value)
+    {
+        return impl_.push_back(std::move(value));
+    }
+
+    adaptive_array&& set_move(std::true_type, size_type index, value_type value)
+    {
+        impl_.assoc_mut({}, index, std::move(value));
+        return std::move(*this);
+    }
+    adaptive_array set_move(std::false_type, size_type index, value_type value)
+    {
+        return impl_.assoc(index, std::move(value));
+    }
+
+    template <typename Fn>
+    adaptive_array&& update_move(std::true_type, size_type index, Fn&& fn)
+    {
+        impl_.update_mut({}, index, std::forward<Fn>(fn));
+        return std::move(*this);
+    }
+    template <typename Fn>
+    adaptive_array update_move(std::false_type, size_type index, Fn&& fn)
+    {
+        return impl_.update(index, std::forward<Fn>(fn));
+    }
+
+    adaptive_array&& take_move(std::true_type, size_type elems)
+    {
+        impl_.take_mut({}, elems);
+        return std::move(*this);
+    }
+    adaptive_array take_move(std::false_type, size_type elems)
+    {
+        return impl_.take(elems);
+    }
+
+    impl_t impl_ = impl_t::empty();
+};
+
+} /* namespace immer */
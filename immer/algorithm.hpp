@@ -10,9 +10,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <numeric>
 #include <type_traits>
+#include <utility>
 
 namespace immer {
 
@@ -229,6 +232,274 @@ bool all_of(Iter first, Iter last, Pred p)
     });
 }
 
+namespace detail {
+
+// Number of independent accumulators used by the reduction kernels.
+// Splitting the reduction in lanes breaks the dependency chain
+// between consecutive elements, which allows the compiler to
+// vectorize the inner loop for the target instruction set.
+constexpr std::size_t reduce_lanes = 8;
+
+template <typename T>
+constexpr bool can_reduce_in_lanes = std::is_arithmetic<T>::value;
+
+template <typename Iter, typename T, typename Reduce, typename Transform>
+auto transform_reduce_chunk(
+    Iter first, Iter last, T init, Reduce reduce, Transform transform)
+    -> std::enable_if_t<!can_reduce_in_lanes<T>, T>
+{
+    for (; first != last; ++first)
+        init = reduce(std::move(init), transform(*first));
+    return init;
+}
+
+template <typename Iter, typename T, typename Reduce, typename Transform>
+auto transform_reduce_chunk(
+    Iter first, Iter last, T init, Reduce reduce, Transform transform)
+    -> std::enable_if_t<can_reduce_in_lanes<T>, T>
+{
+    constexpr auto L = reduce_lanes;
+    if (static_cast<std::size_t>(last - first) >= L) {
+        T acc[L];
+        for (auto i = std::size_t{}; i < L; ++i)
+            acc[i] = transform(first[i]);
+        first += L;
+        for (; static_cast<std::size_t>(last - first) >= L; first += L)
+            for (auto i = std::size_t{}; i < L; ++i)
+                acc[i] = reduce(acc[i], transform(first[i]));
+        for (auto n = L / 2; n > 0; n /= 2)
+            for (auto i = std::size_t{}; i < n; ++i)
+                acc[i] = reduce(acc[i], acc[i + n]);
+        init = reduce(init, acc[0]);
+    }
+    for (; first != last; ++first)
+        init = reduce(init, transform(*first));
+    return init;
+}
+
+template <typename Iter1, typename Iter2, typename T>
+auto dot_chunk(Iter1 first1, Iter1 last1, Iter2 first2, T init)
+    -> std::enable_if_t<!can_reduce_in_lanes<T>, T>
+{
+    for (; first1 != last1; ++first1, ++first2)
+        init = std::move(init) + *first1 * *first2;
+    return init;
+}
+
+template <typename Iter1, typename Iter2, typename T>
+auto dot_chunk(Iter1 first1, Iter1 last1, Iter2 first2, T init)
+    -> std::enable_if_t<can_reduce_in_lanes<T>, T>
+{
+    constexpr auto L = reduce_lanes;
+    T acc[L]         = {};
+    for (; static_cast<std::size_t>(last1 - first1) >= L;
+         first1 += L, first2 += L)
+        for (auto i = std::size_t{}; i < L; ++i)
+            acc[i] += static_cast<T>(first1[i]) * static_cast<T>(first2[i]);
+    for (auto n = L / 2; n > 0; n /= 2)
+        for (auto i = std::size_t{}; i < n; ++i)
+            acc[i] += acc[i + n];
+    init += acc[0];
+    for (; first1 != last1; ++first1, ++first2)
+        init += static_cast<T>(*first1) * static_cast<T>(*first2);
+    return init;
+}
+
+template <typename Iter, typename T>
+auto min_max_chunk(Iter first, Iter last, T& lo, T& hi)
+    -> std::enable_if_t<!can_reduce_in_lanes<T>>
+{
+    for (; first != last; ++first) {
+        if (*first < lo)
+            lo = *first;
+        if (hi < *first)
+            hi = *first;
+    }
+}
+
+template <typename Iter, typename T>
+auto min_max_chunk(Iter first, Iter last, T& lo, T& hi)
+    -> std::enable_if_t<can_reduce_in_lanes<T>>
+{
+    constexpr auto L = reduce_lanes;
+    if (static_cast<std::size_t>(last - first) >= L) {
+        T los[L], his[L];
+        for (auto i = std::size_t{}; i < L; ++i)
+            los[i] = his[i] = first[i];
+        first += L;
+        for (; static_cast<std::size_t>(last - first) >= L; first += L)
+            for (auto i = std::size_t{}; i < L; ++i) {
+                los[i] = first[i] < los[i] ? first[i] : los[i];
+                his[i] = his[i] < first[i] ? first[i] : his[i];
+            }
+        for (auto i = std::size_t{}; i < L; ++i) {
+            lo = los[i] < lo ? los[i] : lo;
+            hi = hi < his[i] ? his[i] : hi;
+        }
+    }
+    for (; first != last; ++first) {
+        lo = *first < lo ? *first : lo;
+        hi = hi < *first ? *first : hi;
+    }
+}
+
+template <typename T>
+struct identity_fn
+{
+    const T& operator()(const T& x) const { return x; }
+};
+
+} // namespace detail
+
+/*!
+ * Equivalent of `std::transform_reduce` applied to the range `r`.
+ * The reduction is performed over every contiguous chunk of the
+ * container, combining the partial results.  Like in the standard
+ * algorithm, `reduce` must be associative and commutative, since the
+ * elements may be grouped and reordered arbitrarily.
+ *
+ * @rst
+ *
+ * .. note:: When ``T`` is an arithmetic type every chunk is reduced
+ *    using multiple independent accumulators, which allows the
+ *    compiler to vectorize the computation for the instruction set
+ *    that the program targets (e.g. with ``-mavx2``).  For floating
+ *    point types this means that the result may differ from the one
+ *    of ``immer::accumulate`` due to rounding.
+ *
+ * @endrst
+ */
+template <typename Range, typename T, typename Reduce, typename Transform>
+T transform_reduce(Range&& r, T init, Reduce reduce, Transform transform)
+{
+    for_each_chunk(r, [&](auto first, auto last) {
+        init = detail::transform_reduce_chunk(
+            first, last, std::move(init), reduce, transform);
+    });
+    return init;
+}
+
+/*!
+ * Equivalent of `std::transform_reduce` applied to the range @f$
+ * [first, last) @f$.
+ */
+template <typename Iterator,
+          typename T,
+          typename Reduce,
+          typename Transform>
+T transform_reduce(
+    Iterator first, Iterator last, T init, Reduce reduce, Transform transform)
+{
+    for_each_chunk(first, last, [&](auto first, auto last) {
+        init = detail::transform_reduce_chunk(
+            first, last, std::move(init), reduce, transform);
+    });
+    return init;
+}
+
+/*!
+ * Returns the sum of all the elements in the range `r`, starting
+ * from a value initialized `value_type{}`.  See @a transform_reduce
+ * for a discussion on how the sum is computed.
+ */
+template <typename Range>
+auto sum(const Range& r) -> typename Range::value_type
+{
+    using value_t = typename Range::value_type;
+    return immer::transform_reduce(
+        r, value_t{}, std::plus<value_t>{}, detail::identity_fn<value_t>{});
+}
+
+/*!
+ * Returns the sum of all the elements in the range @f$ [first, last)
+ * @f$.
+ */
+template <typename Iterator>
+auto sum(Iterator first, Iterator last) ->
+    typename std::iterator_traits<Iterator>::value_type
+{
+    using value_t = typename std::iterator_traits<Iterator>::value_type;
+    return immer::transform_reduce(first,
+                                   last,
+                                   value_t{},
+                                   std::plus<value_t>{},
+                                   detail::identity_fn<value_t>{});
+}
+
+/*!
+ * Returns a pair with the smallest and the biggest element in the
+ * non-empty range `r`, as compared with `operator<`.
+ */
+template <typename Range>
+auto min_max(const Range& r)
+    -> std::pair<typename Range::value_type, typename Range::value_type>
+{
+    using value_t = typename Range::value_type;
+    assert(!r.empty());
+    auto init = false;
+    auto lo   = value_t{};
+    auto hi   = value_t{};
+    for_each_chunk(r, [&](auto first, auto last) {
+        if (!init && first != last) {
+            lo = hi = *first;
+            init    = true;
+        }
+        detail::min_max_chunk(first, last, lo, hi);
+    });
+    return {lo, hi};
+}
+
+/*!
+ * Returns a pair with the smallest and the biggest element in the
+ * non-empty range @f$ [first, last) @f$, as compared with `operator<`.
+ */
+template <typename Iterator>
+auto min_max(Iterator first, Iterator last)
+    -> std::pair<typename std::iterator_traits<Iterator>::value_type,
+                 typename std::iterator_traits<Iterator>::value_type>
+{
+    using value_t = typename std::iterator_traits<Iterator>::value_type;
+    assert(first != last);
+    auto lo = value_t{*first};
+    auto hi = lo;
+    for_each_chunk(first, last, [&](auto first, auto last) {
+        detail::min_max_chunk(first, last, lo, hi);
+    });
+    return {lo, hi};
+}
+
+/*!
+ * Returns the dot product of the sequences `a` and `b`, this is, the
+ * sum of the products of their respective elements.  Both sequences
+ * must have the same size.  Chunks of both containers are traversed
+ * in lockstep, so this is efficient even when their internal
+ * structures differ.
+ */
+template <typename Range1, typename Range2>
+auto dot(const Range1& a, const Range2& b)
+    -> std::common_type_t<typename Range1::value_type,
+                          typename Range2::value_type>
+{
+    using value_t = std::common_type_t<typename Range1::value_type,
+                                       typename Range2::value_type>;
+    assert(a.size() == b.size());
+    auto result = value_t{};
+    auto other  = b.begin();
+    for_each_chunk(a, [&](auto first, auto last) {
+        if (first == last)
+            return;
+        auto next = other + (last - first);
+        for_each_chunk(other, next, [&](auto bfirst, auto blast) {
+            auto bsize = blast - bfirst;
+            result     = detail::dot_chunk(
+                first, first + bsize, bfirst, std::move(result));
+            first += bsize;
+        });
+        other = next;
+    });
+    return result;
+}
+
 /*!
  * Object that can be used to process changes as computed by the @a diff
  * algorithm.
@@ -298,8 +569,9 @@ auto make_differ(AddedFn&& added, RemovedFn&& removed)
  *
  * @rst
  *
- * .. note:: This method is only implemented for ``map`` and ``set``. When sets
- *           are diffed, the ``changed`` function is never called.
+ * .. note:: This method is only implemented for ``map``, ``set``,
+ *           ``sorted_map`` and ``sorted_set``. When sets are diffed, the
+ *           ``changed`` function is never called.
  *
  * @endrst
  */
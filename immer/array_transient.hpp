@@ -101,6 +101,13 @@ public:
      */
     IMMER_NODISCARD bool empty() const { return impl_.size == 0; }
 
+    /*!
+     * Returns the number of elements that fit in the currently
+     * allocated storage.  It does not allocate memory and its
+     * complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD std::size_t capacity() const { return impl_.capacity; }
+
     /*!
      * Access the raw data.
      */
@@ -177,6 +184,31 @@ public:
      */
     void take(size_type elems) { impl_.take_mut(*this, elems); }
 
+    /*!
+     * Makes room for at least `n` elements, such that pushing back up
+     * to that many elements does not allocate again.  It does nothing
+     * when the capacity is already big enough.  Otherwise, it
+     * allocates memory and its complexity is @f$ O(size) @f$.
+     *
+     * @rst
+     *
+     * .. tip:: Reserving the final size before building an array of a
+     *    known size avoids the slack that growing the capacity as
+     *    determined by the *growth policy* of the memory policy would
+     *    leave otherwise.
+     *
+     * @endrst
+     */
+    void reserve(size_type n) { impl_.reserve_mut(*this, n); }
+
+    /*!
+     * Releases the spare capacity, such that `capacity() == size()`.
+     * Use it before calling `persistent()` on an array that is going
+     * to be kept around for long.  It may allocate memory and its
+     * complexity is @f$ O(size) @f$.
+     */
+    void shrink_to_fit() { impl_.shrink_to_fit_mut(*this); }
+
     /*!
      * Returns an @a immutable form of this container, an
      * `immer::array`.
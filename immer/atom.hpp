@@ -65,7 +65,9 @@ struct refcount_atom_impl
             auto newv = oldv.update(fn);
             {
                 scoped_lock_t lock{lock_};
-                if (oldv.impl_ == impl_.impl_) {
+                if (box_type::same_data(typename box_type::inline_t{},
+                                        oldv.impl_,
+                                        impl_.impl_)) {
                     impl_ = newv;
                     return {newv};
                 }
@@ -98,17 +100,20 @@ struct gc_atom_impl
         : impl_{b.impl_}
     {}
 
-    box_type load() const { return {impl_.load()}; }
+    box_type load() const { return {tag_t{}, impl_.load()}; }
 
     void store(box_type b) { impl_.store(b.impl_); }
 
-    box_type exchange(box_type b) { return {impl_.exchange(b.impl_)}; }
+    box_type exchange(box_type b)
+    {
+        return {tag_t{}, impl_.exchange(b.impl_)};
+    }
 
     template <typename Fn>
     box_type update(Fn&& fn)
     {
         while (true) {
-            auto oldv = box_type{impl_.load()};
+            auto oldv = box_type{tag_t{}, impl_.load()};
             auto newv = oldv.update(fn);
             if (impl_.compare_exchange_weak(oldv.impl_, newv.impl_))
                 return {newv};
@@ -116,7 +121,9 @@ struct gc_atom_impl
     }
 
 private:
-    std::atomic<typename box_type::holder*> impl_;
+    using tag_t = typename box_type::data_tag;
+
+    std::atomic<typename box_type::data_t> impl_;
 };
 
 } // namespace detail
@@ -12,6 +12,8 @@
 #include <immer/memory_policy.hpp>
 
 #include <cstddef>
+#include <cstring>
+#include <type_traits>
 
 namespace immer {
 
@@ -23,20 +25,77 @@ struct gc_atom_impl;
 template <typename U, typename MP>
 struct refcount_atom_impl;
 
+template <typename MP, typename Enable = void>
+struct get_inline_small_boxes : std::false_type
+{};
+
+template <typename MP>
+struct get_inline_small_boxes<MP, std::enable_if_t<MP::inline_small_boxes>>
+    : std::true_type
+{};
+
+// Inline values are compared bitwise by `atom::update()`, which needs
+// equal copies to have equal bytes, so types that may have padding
+// are not inlined.
+template <typename T>
+struct has_no_padding
+#if IMMER_HAS_CPP17
+    : std::integral_constant<bool,
+                             std::is_scalar<T>::value ||
+                                 std::has_unique_object_representations<
+                                     T>::value>
+#else
+    : std::is_scalar<T>
+#endif
+{};
+
+template <typename T>
+struct can_inline_box
+    : std::integral_constant<bool,
+                             std::is_trivially_copyable<T>::value &&
+                                 has_no_padding<T>::value &&
+                                 sizeof(T) <= sizeof(void*)>
+{};
+
+// Note that `T` is only inspected when the memory policy requests
+// inline boxes, such that boxes of incomplete types can still be used
+// to build recursive data structures.
+template <typename T, typename MP>
+struct is_inline_box
+    : std::conditional_t<get_inline_small_boxes<MP>::value,
+                         can_inline_box<T>,
+                         std::false_type>
+{};
+
 } // namespace detail
 
+template <typename T, typename MemoryPolicy>
+class box_transient;
+
 /*!
  * Immutable box for a single value of type `T`.
  *
  * The box is always copiable and movable. The `T` copy or move
  * operations are never called.  Since a box is immutable, copying or
  * moving just copy the underlying pointers.
+ *
+ * @rst
+ *
+ * .. note:: When the memory policy enables ``inline_small_boxes`` and
+ *    ``T`` is trivially copyable and no bigger than a pointer, the
+ *    value is stored directly inside the box.  No memory is allocated
+ *    and copies do not touch any reference count.  In this mode, a
+ *    copied box does not share the address of its value with the
+ *    original.
+ *
+ * @endrst
  */
 template <typename T, typename MemoryPolicy = default_memory_policy>
 class box
 {
     friend struct detail::gc_atom_impl<T, MemoryPolicy>;
     friend struct detail::refcount_atom_impl<T, MemoryPolicy>;
+    friend class box_transient<T, MemoryPolicy>;
 
     struct holder : MemoryPolicy::refcount
     {
@@ -50,23 +109,96 @@ class box
 
     using heap = typename MemoryPolicy::heap::type;
 
-    holder* impl_ = nullptr;
+    using inline_t = detail::is_inline_box<T, MemoryPolicy>;
+    using data_t   = std::conditional_t<inline_t::value, T, holder*>;
+
+    struct data_tag
+    {};
+
+    data_t impl_ = {};
 
-    box(holder* impl)
+    box(data_tag, data_t impl)
         : impl_{impl}
     {}
 
+    template <typename... Args>
+    static data_t make_data(std::false_type, Args&&... args)
+    {
+        return detail::make<heap, holder>(std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    static data_t make_data(std::true_type, Args&&... args)
+    {
+        return T{std::forward<Args>(args)...};
+    }
+
+    static void inc_data(std::false_type, holder* p) { p->inc(); }
+    static void inc_data(std::true_type, const T&) {}
+
+    static void dec_data(std::false_type, holder* p)
+    {
+        if (p && p->dec()) {
+            p->~holder();
+            heap::deallocate(sizeof(holder), p);
+        }
+    }
+    static void dec_data(std::true_type, const T&) {}
+
+    static const holder* impl_data(std::false_type, const holder* p)
+    {
+        return p;
+    }
+    static const T* impl_data(std::true_type, const T& v) { return &v; }
+
+    static const T& get_data(std::false_type, const holder* p)
+    {
+        return p->value;
+    }
+    static const T& get_data(std::true_type, const T& v) { return v; }
+
+    static bool same_data(std::false_type, const holder* a, const holder* b)
+    {
+        return a == b;
+    }
+    static bool same_data(std::true_type, const T& a, const T& b)
+    {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    T& get_mut_data(std::false_type, bool owned)
+    {
+        if (!owned && !impl_->unique())
+            *this = box{detail::as_const(impl_->value)};
+        return impl_->value;
+    }
+    T& get_mut_data(std::true_type, bool) { return impl_; }
+
+    template <typename Fn>
+    void update_data(std::false_type, Fn&& fn)
+    {
+        if (impl_->unique())
+            impl_->value = std::forward<Fn>(fn)(std::move(impl_->value));
+        else
+            *this = std::forward<Fn>(fn)(impl_->value);
+    }
+    template <typename Fn>
+    void update_data(std::true_type, Fn&& fn)
+    {
+        *this = std::forward<Fn>(fn)(std::move(impl_));
+    }
+
 public:
-    const holder* impl() const { return impl_; };
+    auto impl() const { return impl_data(inline_t{}, impl_); };
 
-    using value_type    = T;
-    using memory_policy = MemoryPolicy;
+    using value_type     = T;
+    using memory_policy  = MemoryPolicy;
+    using transient_type = box_transient<T, MemoryPolicy>;
 
     /*!
      * Constructs a box holding `T{}`.
      */
     box()
-        : impl_{detail::make<heap, holder>()}
+        : impl_{make_data(inline_t{})}
     {}
 
     /*!
@@ -77,7 +209,7 @@ public:
                   !std::is_same<box, std::decay_t<Arg>>::value &&
                   std::is_constructible<T, Arg>::value>>
     box(Arg&& arg)
-        : impl_{detail::make<heap, holder>(std::forward<Arg>(arg))}
+        : impl_{make_data(inline_t{}, std::forward<Arg>(arg))}
     {}
 
     /*!
@@ -85,9 +217,10 @@ public:
      */
     template <typename Arg1, typename Arg2, typename... Args>
     box(Arg1&& arg1, Arg2&& arg2, Args&&... args)
-        : impl_{detail::make<heap, holder>(std::forward<Arg1>(arg1),
-                                           std::forward<Arg2>(arg2),
-                                           std::forward<Args>(args)...)}
+        : impl_{make_data(inline_t{},
+                          std::forward<Arg1>(arg1),
+                          std::forward<Arg2>(arg2),
+                          std::forward<Args>(args)...)}
     {}
 
     friend void swap(box& a, box& b)
@@ -100,7 +233,7 @@ public:
     box(const box& other)
         : impl_(other.impl_)
     {
-        impl_->inc();
+        inc_data(inline_t{}, impl_);
     }
     box& operator=(box&& other)
     {
@@ -113,16 +246,10 @@ public:
         swap(*this, aux);
         return *this;
     }
-    ~box()
-    {
-        if (impl_ && impl_->dec()) {
-            impl_->~holder();
-            heap::deallocate(sizeof(holder), impl_);
-        }
-    }
+    ~box() { dec_data(inline_t{}, impl_); }
 
     /*! Query the current value. */
-    IMMER_NODISCARD const T& get() const { return impl_->value; }
+    IMMER_NODISCARD const T& get() const { return get_data(inline_t{}, impl_); }
 
     /*! Conversion to the boxed type. */
     operator const T&() const { return get(); }
@@ -156,12 +283,22 @@ public:
     template <typename Fn>
     IMMER_NODISCARD box&& update(Fn&& fn) &&
     {
-        if (impl_->unique())
-            impl_->value = std::forward<Fn>(fn)(std::move(impl_->value));
-        else
-            *this = std::forward<Fn>(fn)(impl_->value);
+        update_data(inline_t{}, std::forward<Fn>(fn));
         return std::move(*this);
     }
+
+    /*!
+     * Returns a @a transient form of this box, an
+     * `immer::box_transient`.
+     */
+    IMMER_NODISCARD transient_type transient() const&
+    {
+        return transient_type{*this};
+    }
+    IMMER_NODISCARD transient_type transient() &&
+    {
+        return transient_type{std::move(*this)};
+    }
 };
 
 template <typename T, typename MP>
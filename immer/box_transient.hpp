@@ -0,0 +1,124 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/box.hpp>
+#include <immer/memory_policy.hpp>
+
+namespace immer {
+
+/*!
+ * Mutable version of `immer::box`.
+ *
+ * @rst
+ *
+ * Refer to :doc:`transients` to learn more about when and how to use
+ * the mutable versions of immutable containers.
+ *
+ * The value is copied the first time it is accessed mutably, unless
+ * the box was not shared with anybody else.  From then on, it is
+ * updated in place until ``persistent()`` is called on an l-value.
+ *
+ * @endrst
+ */
+template <typename T, typename MemoryPolicy = default_memory_policy>
+class box_transient
+{
+public:
+    using value_type      = T;
+    using memory_policy   = MemoryPolicy;
+    using persistent_type = box<T, MemoryPolicy>;
+
+    /*!
+     * Constructs a transient box holding `T{}`.
+     */
+    box_transient() = default;
+
+    box_transient(box_transient&& other) = default;
+    box_transient& operator=(box_transient&& other) = default;
+
+    /*!
+     * Copying a transient box makes both the copy and the original
+     * copy the value again on the next mutable access.
+     */
+    box_transient(const box_transient& other)
+        : impl_{other.impl_}
+    {
+        other.owned_ = false;
+    }
+    box_transient& operator=(const box_transient& other)
+    {
+        impl_        = other.impl_;
+        owned_       = false;
+        other.owned_ = false;
+        return *this;
+    }
+
+    /*! Query the current value. */
+    IMMER_NODISCARD const T& get() const { return impl_.get(); }
+
+    /*! Access via dereference */
+    const T& operator*() const { return get(); }
+
+    /*! Access via pointer member access */
+    const T* operator->() const { return &get(); }
+
+    /*!
+     * Returns a mutable reference to the value.  It copies the value
+     * the first time, unless it was not shared.  The reference is
+     * invalidated by any subsequent operation on the transient.
+     */
+    IMMER_NODISCARD T& get_mut()
+    {
+        auto& r = impl_.get_mut_data(typename persistent_type::inline_t{},
+                                     owned_);
+        owned_  = true;
+        return r;
+    }
+
+    /*!
+     * Replaces the value with `value`.
+     */
+    void set(T value) { get_mut() = std::move(value); }
+
+    /*!
+     * Replaces the value with the result of `fn(std::move(value))`.
+     */
+    template <typename Fn>
+    void update(Fn&& fn)
+    {
+        auto& v = get_mut();
+        v       = std::forward<Fn>(fn)(std::move(v));
+    }
+
+    /*!
+     * Returns an @a immutable form of this box, an `immer::box`.
+     */
+    IMMER_NODISCARD persistent_type persistent() &
+    {
+        owned_ = false;
+        return impl_;
+    }
+    IMMER_NODISCARD persistent_type persistent() &&
+    {
+        return std::move(impl_);
+    }
+
+private:
+    friend persistent_type;
+
+    box_transient(persistent_type impl)
+        : impl_(std::move(impl))
+    {}
+
+    persistent_type impl_;
+    mutable bool owned_ = false;
+};
+
+} // namespace immer
@@ -74,10 +74,21 @@
 #define IMMER_DEBUG_STATS 0
 #endif
 
+#ifndef IMMER_ENABLE_PROBES
+#define IMMER_ENABLE_PROBES 0
+#endif
+
 #ifndef IMMER_DEBUG_DEEP_CHECK
 #define IMMER_DEBUG_DEEP_CHECK 0
 #endif
 
+// Trees with at least this many levels of inner nodes are released and
+// traversed using a fixed size explicit stack instead of recursion.
+// Define it to 0 to always do so, e.g. when running on small stacks.
+#ifndef IMMER_ITERATIVE_MIN_DEPTH
+#define IMMER_ITERATIVE_MIN_DEPTH 3
+#endif
+
 #if IMMER_DEBUG_TRACES || IMMER_DEBUG_PRINT
 #include <iostream>
 #include <prettyprint.hpp>
@@ -121,9 +132,47 @@
 #endif
 #endif
 
+#include <cstddef>
+#include <cstdint>
+
 namespace immer {
 
 const auto default_bits           = 5;
 const auto default_free_list_size = 1 << 10;
 
+namespace detail {
+
+constexpr std::uint32_t bits_leaf_for_bytes_aux(std::size_t count)
+{
+    return count <= 1 ? 0 : 1 + bits_leaf_for_bytes_aux(count >> 1);
+}
+
+} // namespace detail
+
+/*!
+ * Number of bits `BL` for the leaves of a `vector` or `flex_vector`
+ * of `T` such that every leaf stores, at most, `Bytes` bytes worth of
+ * elements.  It can be passed as the `BL` parameter to size the
+ * leaves to match, for example, a number of cache lines or pages,
+ * regardless of `sizeof(T)`.  Note that the size of the node header
+ * is not accounted for.  When `T` is bigger than `Bytes` the leaves
+ * contain a single element.
+ *
+ * @rst
+ *
+ * **Example**
+ *   .. code-block:: c++
+ *
+ *      using text = immer::flex_vector<
+ *          char,
+ *          immer::default_memory_policy,
+ *          immer::default_bits,
+ *          immer::bits_leaf_for_bytes<char, 1024>>;
+ *
+ * @endrst
+ */
+template <typename T, std::size_t Bytes>
+constexpr std::uint32_t bits_leaf_for_bytes =
+    detail::bits_leaf_for_bytes_aux(Bytes / sizeof(T));
+
 } // namespace immer
@@ -0,0 +1,324 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/arrays/with_capacity.hpp>
+#include <immer/detail/rbts/rbtree.hpp>
+#include <immer/detail/rbts/rbtree_iterator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace immer {
+namespace detail {
+namespace arrays {
+
+/*!
+ * Implementation of `immer::adaptive_array`.  It holds either a flat
+ * array, while it has at most `Threshold` elements, or a radix
+ * balanced tree.  It goes back to flat only when shrinking to half of
+ * the threshold, such that alternating pushes and takes around the
+ * threshold do not convert the whole sequence every time.
+ */
+template <typename T,
+          typename MemoryPolicy,
+          std::size_t Threshold,
+          rbts::bits_t B,
+          rbts::bits_t BL>
+struct adaptive
+{
+    using flat_t = std::conditional_t<MemoryPolicy::use_transient_rvalues,
+                                      with_capacity<T, MemoryPolicy>,
+                                      no_capacity<T, MemoryPolicy>>;
+    using tree_t = rbts::rbtree<T, MemoryPolicy, B, BL>;
+    using edit_t = typename MemoryPolicy::transience_t::edit;
+    using size_t = std::size_t;
+
+    static constexpr size_t threshold = Threshold;
+
+    union
+    {
+        flat_t flat;
+        tree_t tree;
+    };
+    bool is_flat;
+
+    static const adaptive& empty()
+    {
+        static const adaptive empty_{flat_t::empty()};
+        return empty_;
+    }
+
+    adaptive(flat_t f)
+        : flat{std::move(f)}
+        , is_flat{true}
+    {}
+
+    adaptive(tree_t t)
+        : tree{std::move(t)}
+        , is_flat{false}
+    {}
+
+    adaptive(const adaptive& other)
+        : is_flat{other.is_flat}
+    {
+        if (is_flat)
+            new (&flat) flat_t{other.flat};
+        else
+            new (&tree) tree_t{other.tree};
+    }
+
+    adaptive(adaptive&& other)
+        : is_flat{other.is_flat}
+    {
+        if (is_flat)
+            new (&flat) flat_t{std::move(other.flat)};
+        else
+            new (&tree) tree_t{std::move(other.tree)};
+    }
+
+    adaptive& operator=(const adaptive& other)
+    {
+        if (this != &other) {
+            destroy();
+            new (this) adaptive{other};
+        }
+        return *this;
+    }
+
+    adaptive& operator=(adaptive&& other)
+    {
+        if (this != &other) {
+            if (is_flat && other.is_flat)
+                flat = std::move(other.flat);
+            else if (!is_flat && !other.is_flat)
+                tree = std::move(other.tree);
+            else {
+                destroy();
+                new (this) adaptive{std::move(other)};
+            }
+        }
+        return *this;
+    }
+
+    ~adaptive() { destroy(); }
+
+    void destroy()
+    {
+        if (is_flat)
+            flat.~flat_t();
+        else
+            tree.~tree_t();
+    }
+
+    template <typename U>
+    static adaptive from_initializer_list(std::initializer_list<U> values)
+    {
+        using namespace std;
+        return from_range(begin(values), end(values));
+    }
+
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<compatible_sentinel_v<Iter, Sent>, bool> = true>
+    static adaptive from_range(Iter first, Sent last)
+    {
+        if (static_cast<size_t>(detail::distance(first, last)) <= Threshold)
+            return flat_t::from_range(first, last);
+        else
+            return tree_t::from_range(first, last);
+    }
+
+    static adaptive from_fill(size_t n, T v)
+    {
+        if (n <= Threshold)
+            return flat_t::from_fill(n, std::move(v));
+        else
+            return tree_t::from_fill(n, std::move(v));
+    }
+
+    size_t size() const { return is_flat ? flat.size : tree.size; }
+
+    const T* data() const { return is_flat ? flat.data() : nullptr; }
+
+    template <typename Fn>
+    void for_each_chunk(Fn&& fn) const
+    {
+        if (is_flat)
+            flat.for_each_chunk(std::forward<Fn>(fn));
+        else
+            tree.for_each_chunk(std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    void for_each_chunk(size_t first, size_t last, Fn&& fn) const
+    {
+        if (is_flat)
+            std::forward<Fn>(fn)(flat.data() + first, flat.data() + last);
+        else
+            tree.for_each_chunk(first, last, std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    bool for_each_chunk_p(Fn&& fn) const
+    {
+        return is_flat ? flat.for_each_chunk_p(std::forward<Fn>(fn))
+                       : tree.for_each_chunk_p(std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    bool for_each_chunk_p(size_t first, size_t last, Fn&& fn) const
+    {
+        return is_flat ? std::forward<Fn>(fn)(flat.data() + first,
+                                              flat.data() + last)
+                       : tree.for_each_chunk_p(
+                             first, last, std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    void for_each_node(Fn&& fn) const
+    {
+        if (is_flat)
+            flat.for_each_node(std::forward<Fn>(fn));
+        else
+            tree.for_each_node(std::forward<Fn>(fn));
+    }
+
+    const T& get(size_t index) const
+    {
+        return is_flat ? flat.get(index) : tree.get(index);
+    }
+
+    const T& get_check(size_t index) const
+    {
+        return is_flat ? flat.get_check(index) : tree.get_check(index);
+    }
+
+    bool equals(const adaptive& other) const
+    {
+        if (is_flat && other.is_flat)
+            return flat.equals(other.flat);
+        else if (!is_flat && !other.is_flat)
+            return tree.equals(other.tree);
+        else if (size() != other.size())
+            return false;
+        else {
+            auto& f = is_flat ? flat : other.flat;
+            auto& t = is_flat ? other.tree : tree;
+            auto p  = f.data();
+            return t.for_each_chunk_p([&](auto first, auto last) {
+                auto r = std::equal(first, last, p);
+                p += last - first;
+                return r;
+            });
+        }
+    }
+
+    tree_t to_tree() const
+    {
+        assert(is_flat);
+        return tree_t::from_range(flat.data(), flat.data() + flat.size);
+    }
+
+    flat_t to_flat(size_t n) const
+    {
+        assert(!is_flat);
+        using iter_t = rbts::rbtree_iterator<T, MemoryPolicy, B, BL>;
+        auto first   = iter_t{tree};
+        return flat_t::from_range(first, first + n);
+    }
+
+    static bool should_flatten(size_t n) { return n <= Threshold / 2; }
+
+    adaptive push_back(T value) const
+    {
+        if (!is_flat)
+            return tree.push_back(std::move(value));
+        else if (flat.size < Threshold)
+            return flat.push_back(std::move(value));
+        else
+            return to_tree().push_back(std::move(value));
+    }
+
+    adaptive assoc(size_t idx, T value) const
+    {
+        return is_flat ? adaptive{flat.assoc(idx, std::move(value))}
+                       : adaptive{tree.assoc(idx, std::move(value))};
+    }
+
+    template <typename Fn>
+    adaptive update(size_t idx, Fn&& op) const
+    {
+        return is_flat ? adaptive{flat.update(idx, std::forward<Fn>(op))}
+                       : adaptive{tree.update(idx, std::forward<Fn>(op))};
+    }
+
+    adaptive take(size_t sz) const
+    {
+        if (sz >= size())
+            return *this;
+        else if (is_flat)
+            return flat.take(sz);
+        else if (should_flatten(sz))
+            return to_flat(sz);
+        else
+            return tree.take(sz);
+    }
+
+    void push_back_mut(edit_t e, T value)
+    {
+        if (!is_flat)
+            tree.push_back_mut(e, std::move(value));
+        else if (flat.size < Threshold)
+            flat.push_back_mut(e, std::move(value));
+        else {
+            auto t = to_tree();
+            t.push_back_mut(e, std::move(value));
+            *this = std::move(t);
+        }
+    }
+
+    void assoc_mut(edit_t e, size_t idx, T value)
+    {
+        if (is_flat)
+            flat.assoc_mut(e, idx, std::move(value));
+        else
+            tree.assoc_mut(e, idx, std::move(value));
+    }
+
+    template <typename Fn>
+    void update_mut(edit_t e, size_t idx, Fn&& op)
+    {
+        if (is_flat)
+            flat.update_mut(e, idx, std::forward<Fn>(op));
+        else
+            tree.update_mut(e, idx, std::forward<Fn>(op));
+    }
+
+    void take_mut(edit_t e, size_t sz)
+    {
+        if (sz >= size())
+            return;
+        else if (is_flat)
+            flat.take_mut(e, sz);
+        else if (should_flatten(sz))
+            *this = to_flat(sz);
+        else
+            tree.take_mut(e, sz);
+    }
+};
+
+} // namespace arrays
+} // namespace detail
+} // namespace immer
@@ -0,0 +1,105 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/arrays/adaptive.hpp>
+#include <immer/detail/iterator_facade.hpp>
+
+namespace immer {
+namespace detail {
+namespace arrays {
+
+template <typename T,
+          typename MP,
+          std::size_t Threshold,
+          rbts::bits_t B,
+          rbts::bits_t BL>
+struct adaptive_iterator
+    : iterator_facade<adaptive_iterator<T, MP, Threshold, B, BL>,
+                      std::random_access_iterator_tag,
+                      T,
+                      const T&,
+                      std::ptrdiff_t,
+                      const T*>
+{
+    using impl_t = adaptive<T, MP, Threshold, B, BL>;
+
+    struct end_t
+    {};
+
+    const impl_t& impl() const { return *v_; }
+    size_t index() const { return i_; }
+
+    adaptive_iterator() = default;
+
+    adaptive_iterator(const impl_t& v)
+        : v_{&v}
+        , i_{0}
+        , base_{~size_t{}}
+        , curr_{v.data()}
+    {}
+
+    adaptive_iterator(const impl_t& v, end_t)
+        : v_{&v}
+        , i_{v.size()}
+        , base_{~size_t{}}
+        , curr_{v.data()}
+    {}
+
+private:
+    friend iterator_core_access;
+
+    const impl_t* v_;
+    size_t i_;
+    mutable size_t base_;
+    mutable const T* curr_;
+
+    void increment()
+    {
+        assert(i_ < v_->size());
+        ++i_;
+    }
+
+    void decrement()
+    {
+        assert(i_ > 0);
+        --i_;
+    }
+
+    void advance(std::ptrdiff_t n)
+    {
+        assert(n <= 0 || i_ + static_cast<size_t>(n) <= v_->size());
+        assert(n >= 0 || static_cast<size_t>(-n) <= i_);
+        i_ += n;
+    }
+
+    bool equal(const adaptive_iterator& other) const { return i_ == other.i_; }
+
+    std::ptrdiff_t distance_to(const adaptive_iterator& other) const
+    {
+        return other.i_ > i_ ? static_cast<std::ptrdiff_t>(other.i_ - i_)
+                             : -static_cast<std::ptrdiff_t>(i_ - other.i_);
+    }
+
+    const T& dereference() const
+    {
+        if (v_->is_flat)
+            return curr_[i_];
+        auto base = i_ & ~rbts::mask<BL>;
+        if (base_ != base) {
+            base_ = base;
+            curr_ = v_->tree.array_for(i_);
+        }
+        return curr_[i_ & rbts::mask<BL>];
+    }
+};
+
+} // namespace arrays
+} // namespace detail
+} // namespace immer
@@ -142,6 +142,12 @@ struct no_capacity
         return std::forward<Fn>(fn)(data(), data() + size);
     }
 
+    template <typename Fn>
+    void for_each_node(Fn&& fn) const
+    {
+        fn(static_cast<const void*>(ptr), node_t::sizeof_n(size));
+    }
+
     const T& get(std::size_t index) const { return data()[index]; }
 
     const T& get_check(std::size_t index) const
@@ -12,6 +12,7 @@
 #include <immer/detail/combine_standard_layout.hpp>
 #include <immer/detail/type_traits.hpp>
 #include <immer/detail/util.hpp>
+#include <immer/probe.hpp>
 
 #include <cstddef>
 #include <limits>
@@ -56,7 +57,7 @@ struct node
 
     bool can_mutate(edit_t e) const
     {
-        return refs().unique() || ownee().can_mutate(e);
+        return IMMER_PROBE_MUTATE(refs().unique() || ownee().can_mutate(e));
     }
 
     static void delete_n(node_t* p, size_t sz, size_t cap)
@@ -67,6 +68,7 @@ struct node
 
     static node_t* make_n(size_t n)
     {
+        IMMER_PROBE(leaf_alloc);
         return new (heap::allocate(sizeof_n(n))) node_t{};
     }
 
@@ -109,6 +111,7 @@ struct node
 
     static node_t* copy_n(size_t n, node_t* p, size_t count)
     {
+        IMMER_PROBE(node_copy);
         return copy_n(n, p->data(), p->data() + count);
     }
 
@@ -122,6 +125,7 @@ struct node
 
     static node_t* copy_e(edit_t e, size_t n, node_t* p, size_t count)
     {
+        IMMER_PROBE(node_copy);
         return copy_e(e, n, p->data(), p->data() + count);
     }
 };
@@ -10,23 +10,39 @@
 
 #include <immer/config.hpp>
 #include <immer/detail/arrays/no_capacity.hpp>
+#include <immer/detail/type_traits.hpp>
+#include <immer/growth/factor_growth_policy.hpp>
 
 #include <cassert>
 #include <cstddef>
 #include <stdexcept>
+#include <type_traits>
 
 namespace immer {
 namespace detail {
 namespace arrays {
 
+template <typename MP, typename Enable = void>
+struct get_growth_policy
+{
+    using type = factor_growth_policy<>;
+};
+
+template <typename MP>
+struct get_growth_policy<MP, void_t<typename MP::growth>>
+{
+    using type = typename MP::growth;
+};
+
 template <typename T, typename MemoryPolicy>
 struct with_capacity
 {
     using no_capacity_t = no_capacity<T, MemoryPolicy>;
 
-    using node_t = node<T, MemoryPolicy>;
-    using edit_t = typename MemoryPolicy::transience_t::edit;
-    using size_t = std::size_t;
+    using node_t   = node<T, MemoryPolicy>;
+    using edit_t   = typename MemoryPolicy::transience_t::edit;
+    using growth_t = typename get_growth_policy<MemoryPolicy>::type;
+    using size_t   = std::size_t;
 
     node_t* ptr;
     size_t size;
@@ -111,6 +127,21 @@ struct with_capacity
         return data();
     }
 
+    // Moves the elements to a new node of capacity `cap` when this one
+    // can be mutated, and copies them otherwise.  Moving is only done
+    // when it can not throw, so the old node stays valid on failure.
+    void relocate_mut(edit_t e, size_t cap, bool can_mutate)
+    {
+        assert(cap >= size);
+        if (std::is_nothrow_move_constructible<T>::value && can_mutate) {
+            auto p = node_t::make_e(e, cap);
+            detail::uninitialized_move(data(), data() + size, p->data());
+            *this = {p, size, cap};
+        } else {
+            *this = {node_t::copy_e(e, cap, ptr, size), size, cap};
+        }
+    }
+
     operator no_capacity_t() const
     {
         if (size == capacity) {
@@ -159,6 +190,12 @@ struct with_capacity
         return std::forward<Fn>(fn)(data(), data() + size);
     }
 
+    template <typename Fn>
+    void for_each_node(Fn&& fn) const
+    {
+        fn(static_cast<const void*>(ptr), node_t::sizeof_n(capacity));
+    }
+
     const T& get(std::size_t index) const { return data()[index]; }
 
     const T& get_check(std::size_t index) const
@@ -177,11 +214,7 @@ struct with_capacity
 
     static size_t recommend_up(size_t sz, size_t cap)
     {
-        auto max = std::numeric_limits<size_t>::max();
-        return sz <= cap        ? cap
-               : cap >= max / 2 ? max
-                                /* otherwise */
-                                : std::max(2 * cap, sz);
+        return growth_t::grow(sz, cap);
     }
 
     static size_t recommend_down(size_t sz, size_t cap)
@@ -208,21 +241,25 @@ struct with_capacity
 
     void push_back_mut(edit_t e, T value)
     {
-        if (ptr->can_mutate(e) && capacity > size) {
-            new (data() + size) T{std::move(value)};
-            ++size;
-        } else {
-            auto cap = recommend_up(size + 1, capacity);
-            auto p   = node_t::copy_e(e, cap, ptr, size);
-            IMMER_TRY {
-                new (p->data() + size) T{std::move(value)};
-                *this = {p, size + 1, cap};
-            }
-            IMMER_CATCH (...) {
-                node_t::delete_n(p, size, cap);
-                IMMER_RETHROW;
-            }
-        }
+        auto can_mutate = ptr->can_mutate(e);
+        if (!can_mutate || capacity == size)
+            relocate_mut(e, recommend_up(size + 1, capacity), can_mutate);
+        new (data() + size) T{std::move(value)};
+        ++size;
+    }
+
+    void reserve_mut(edit_t e, size_t n)
+    {
+        if (n > capacity)
+            relocate_mut(e, n, ptr->can_mutate(e));
+    }
+
+    void shrink_to_fit_mut(edit_t e)
+    {
+        if (size == 0)
+            *this = empty();
+        else if (size < capacity)
+            relocate_mut(e, size, ptr->can_mutate(e));
     }
 
     with_capacity assoc(std::size_t idx, T value) const
@@ -302,7 +339,7 @@ struct with_capacity
     {
         assert(sz <= size);
         if (ptr->can_mutate(e)) {
-            detail::destroy_n(data() + size, size - sz);
+            detail::destroy_n(data() + sz, size - sz);
             size = sz;
         } else {
             auto cap = recommend_down(sz, capacity);
@@ -0,0 +1,50 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace immer {
+namespace detail {
+namespace btrees {
+
+using bits_t  = std::uint32_t;
+using count_t = std::uint32_t;
+using size_t  = std::size_t;
+
+template <bits_t B, typename T = count_t>
+constexpr T branches = T{1} << B;
+
+// Bound on the height of a tree with inner nodes of `B` bits.  All
+// inner nodes but the root have at least `branches<B> / 2` children.
+template <bits_t B>
+constexpr count_t max_height = 2 + sizeof(size_t) * 8 / (B - 1);
+
+// Bits for the leaves such that a full leaf takes about as much space
+// as a full inner node, which holds `branches<B>` children and one key
+// less.
+template <typename T, typename Key, bits_t B>
+constexpr bits_t derive_bits_leaf_aux()
+{
+    constexpr auto inner_bytes =
+        branches<B, size_t> * sizeof(void*) +
+        (branches<B, size_t> - 1) * sizeof(Key);
+    constexpr auto BL = bits_leaf_for_bytes_aux(inner_bytes / sizeof(T));
+    return BL < 1 ? 1 : BL;
+}
+
+template <typename T, typename Key, bits_t B>
+constexpr bits_t derive_bits_leaf = derive_bits_leaf_aux<T, Key, B>();
+
+} // namespace btrees
+} // namespace detail
+} // namespace immer
@@ -0,0 +1,772 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/btrees/node.hpp>
+#include <immer/detail/type_traits.hpp>
+#include <immer/reclamation/immediate_reclamation_policy.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <utility>
+
+namespace immer {
+namespace detail {
+namespace btrees {
+
+// A position in a tree, as the path from the root to a leaf.  It is
+// past the end of the tree when the index in the leaf is its count,
+// which only happens in the last leaf.
+template <typename Node, bits_t B>
+struct cursor
+{
+    using node_t = Node;
+
+    const node_t* nodes[max_height<B>];
+    count_t idx[max_height<B>];
+    count_t height;
+
+    const node_t* leaf() const { return nodes[height]; }
+    bool at_end() const { return idx[height] == leaf()->count(); }
+    const typename node_t::value_t& get() const
+    {
+        return leaf()->values()[idx[height]];
+    }
+
+    bool operator==(const cursor& other) const
+    {
+        return leaf() == other.leaf() && idx[height] == other.idx[height];
+    }
+
+    void descend_first(count_t d)
+    {
+        for (; d < height; ++d) {
+            idx[d]        = 0;
+            nodes[d + 1] = nodes[d]->children()[0];
+        }
+        idx[height] = 0;
+    }
+
+    void descend_last(count_t d)
+    {
+        for (; d < height; ++d) {
+            idx[d]        = nodes[d]->count() - 1;
+            nodes[d + 1] = nodes[d]->children()[idx[d]];
+        }
+        idx[height] = leaf()->count() - 1;
+    }
+
+    void first(const node_t* root, count_t h)
+    {
+        height   = h;
+        nodes[0] = root;
+        descend_first(0);
+    }
+
+    void end(const node_t* root, count_t h)
+    {
+        height   = h;
+        nodes[0] = root;
+        descend_last(0);
+        idx[height] = leaf()->count();
+    }
+
+    // Moves to the first element of the next leaf when the index is
+    // past the end of the current one.
+    void normalize()
+    {
+        if (idx[height] < leaf()->count())
+            return;
+        for (auto d = height; d-- > 0;) {
+            if (idx[d] + 1 < nodes[d]->count()) {
+                ++idx[d];
+                nodes[d + 1] = nodes[d]->children()[idx[d]];
+                descend_first(d + 1);
+                return;
+            }
+        }
+    }
+
+    void next()
+    {
+        ++idx[height];
+        normalize();
+    }
+
+    void prev()
+    {
+        if (idx[height] > 0) {
+            --idx[height];
+            return;
+        }
+        for (auto d = height; d-- > 0;) {
+            if (idx[d] > 0) {
+                --idx[d];
+                nodes[d + 1] = nodes[d]->children()[idx[d]];
+                descend_last(d + 1);
+                return;
+            }
+        }
+    }
+
+    // Moves past the subtree at depth `d`.
+    void skip(count_t d)
+    {
+        descend_last(d);
+        next();
+    }
+
+    // Finds the highest subtree that starts at the current position of
+    // both cursors and that is shared between them, and moves both
+    // past it.  Returns whether something was skipped.
+    static bool skip_shared(cursor& a, cursor& b)
+    {
+        auto found = false;
+        auto j     = count_t{};
+        for (auto da = a.height, db = b.height;; --da, --db) {
+            if (a.idx[da] != 0 || b.idx[db] != 0 ||
+                a.nodes[da] != b.nodes[db])
+                break;
+            found = true;
+            j     = a.height - da;
+            if (da == 0 || db == 0)
+                break;
+        }
+        if (found) {
+            a.skip(a.height - j);
+            b.skip(b.height - j);
+        }
+        return found;
+    }
+};
+
+template <typename T,
+          typename Key,
+          typename KeyOf,
+          typename Compare,
+          typename MemoryPolicy,
+          bits_t B,
+          bits_t BL>
+struct btree
+{
+    static_assert(B >= 2, "inner nodes need at least 4 children");
+    static_assert(BL >= 1, "leaves need room for at least 2 values");
+
+    using node_t    = node<T, Key, MemoryPolicy, B, BL>;
+    using edit_t    = typename MemoryPolicy::transience_t::edit;
+    using owner_t   = typename MemoryPolicy::transience_t::owner;
+    using reclaim_t = get_reclamation_policy_t<MemoryPolicy>;
+    using cursor_t  = cursor<node_t, B>;
+
+    static constexpr auto inner_max = branches<B>;
+    static constexpr auto leaf_max  = branches<BL>;
+    static constexpr auto inner_min = inner_max / 2;
+    static constexpr auto leaf_min  = leaf_max / 2;
+
+    size_t size;
+    count_t height;
+    node_t* root;
+
+    static node_t* empty_root()
+    {
+        static const auto empty_ = node_t::make_leaf_n();
+        return empty_->inc();
+    }
+
+    btree()
+        : size{0}
+        , height{0}
+        , root{empty_root()}
+    {}
+
+    btree(size_t sz, count_t h, node_t* r)
+        : size{sz}
+        , height{h}
+        , root{r}
+    {}
+
+    btree(const btree& other)
+        : btree{other.size, other.height, other.root}
+    {
+        inc();
+    }
+
+    btree(btree&& other)
+        : btree{}
+    {
+        swap(*this, other);
+    }
+
+    btree& operator=(const btree& other)
+    {
+        auto next = other;
+        swap(*this, next);
+        return *this;
+    }
+
+    btree& operator=(btree&& other)
+    {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(btree& x, btree& y)
+    {
+        using std::swap;
+        swap(x.size, y.size);
+        swap(x.height, y.height);
+        swap(x.root, y.root);
+    }
+
+    ~btree() { dec(); }
+
+    void inc() const { root->inc(); }
+
+    void dec() const
+    {
+        if (root->dec())
+            dec_impl(std::integral_constant<bool, reclaim_t::deferred>{});
+    }
+
+    void dec_impl(std::false_type) const { node_t::delete_deep(root, height); }
+
+    void dec_impl(std::true_type) const
+    {
+        auto& q = reclaim_t::queue();
+        q.push(&node_t::reclaim_deep, root, height);
+        q.drain(reclaim_t::budget);
+    }
+
+    template <typename U>
+    static auto from_initializer_list(std::initializer_list<U> values)
+    {
+        auto e      = owner_t{};
+        auto result = btree{};
+        for (auto&& v : values)
+            result.insert_mut(e, v);
+        return result;
+    }
+
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<compatible_sentinel_v<Iter, Sent>, bool> = true>
+    static auto from_range(Iter first, Sent last)
+    {
+        auto e      = owner_t{};
+        auto result = btree{};
+        for (; first != last; ++first)
+            result.insert_mut(e, *first);
+        return result;
+    }
+
+    static const Key& key(const T& x) { return KeyOf{}(x); }
+
+    template <typename K1, typename K2>
+    static bool less(const K1& a, const K2& b)
+    {
+        return Compare{}(a, b);
+    }
+
+    template <typename K>
+    static count_t child_index(const node_t* n, const K& k)
+    {
+        auto keys = n->keys();
+        return static_cast<count_t>(
+            std::upper_bound(
+                keys,
+                keys + n->count() - 1,
+                k,
+                [](const K& a, const Key& b) { return less(a, b); }) -
+            keys);
+    }
+
+    template <typename K>
+    static count_t leaf_lower_bound(const node_t* n, const K& k)
+    {
+        auto values = n->values();
+        return static_cast<count_t>(
+            std::lower_bound(
+                values,
+                values + n->count(),
+                k,
+                [](const T& a, const K& b) { return less(key(a), b); }) -
+            values);
+    }
+
+    template <typename K>
+    static count_t leaf_upper_bound(const node_t* n, const K& k)
+    {
+        auto values = n->values();
+        return static_cast<count_t>(
+            std::upper_bound(
+                values,
+                values + n->count(),
+                k,
+                [](const K& a, const T& b) { return less(a, key(b)); }) -
+            values);
+    }
+
+    template <typename K>
+    const T* find(const K& k) const
+    {
+        auto n = static_cast<const node_t*>(root);
+        for (auto h = height; h > 0; --h)
+            n = n->children()[child_index(n, k)];
+        auto pos = leaf_lower_bound(n, k);
+        return pos < n->count() && !less(k, key(n->values()[pos]))
+                   ? n->values() + pos
+                   : nullptr;
+    }
+
+    cursor_t first() const
+    {
+        auto c = cursor_t{};
+        c.first(root, height);
+        return c;
+    }
+
+    cursor_t end() const
+    {
+        auto c = cursor_t{};
+        c.end(root, height);
+        return c;
+    }
+
+    template <bool Upper, typename K>
+    cursor_t bound(const K& k) const
+    {
+        auto c     = cursor_t{};
+        c.height   = height;
+        c.nodes[0] = root;
+        for (auto d = count_t{}; d < height; ++d) {
+            c.idx[d]       = child_index(c.nodes[d], k);
+            c.nodes[d + 1] = c.nodes[d]->children()[c.idx[d]];
+        }
+        c.idx[height] = Upper ? leaf_upper_bound(c.leaf(), k)
+                              : leaf_lower_bound(c.leaf(), k);
+        c.normalize();
+        return c;
+    }
+
+    template <typename Fn>
+    bool for_each_chunk_p(Fn&& fn) const
+    {
+        return for_each_chunk_p_traversal(root, height, fn);
+    }
+
+    template <typename Fn>
+    static bool
+    for_each_chunk_p_traversal(const node_t* n, count_t height, Fn&& fn)
+    {
+        if (height == 0)
+            return fn(n->values(), n->values() + n->count());
+        auto fst = n->children();
+        auto lst = fst + n->count();
+        for (; fst != lst; ++fst)
+            if (!for_each_chunk_p_traversal(*fst, height - 1, fn))
+                return false;
+        return true;
+    }
+
+    template <typename Fn>
+    void for_each_chunk(Fn&& fn) const
+    {
+        for_each_chunk_p([&](auto first, auto last) {
+            fn(first, last);
+            return true;
+        });
+    }
+
+    template <typename EqualValue, typename Differ>
+    void diff(const btree& other, Differ&& differ) const
+    {
+        if (root == other.root)
+            return;
+        auto a = first();
+        auto b = other.first();
+        while (!a.at_end() && !b.at_end()) {
+            if (cursor_t::skip_shared(a, b))
+                continue;
+            auto& x = a.get();
+            auto& y = b.get();
+            if (less(key(x), key(y))) {
+                differ.removed(x);
+                a.next();
+            } else if (less(key(y), key(x))) {
+                differ.added(y);
+                b.next();
+            } else {
+                if (!EqualValue{}(x, y))
+                    differ.changed(x, y);
+                a.next();
+                b.next();
+            }
+        }
+        for (; !a.at_end(); a.next())
+            differ.removed(a.get());
+        for (; !b.at_end(); b.next())
+            differ.added(b.get());
+    }
+
+    template <typename Eq>
+    bool equals(const btree& other) const
+    {
+        if (size != other.size)
+            return false;
+        if (root == other.root)
+            return true;
+        auto a = first();
+        auto b = other.first();
+        while (!a.at_end()) {
+            if (cursor_t::skip_shared(a, b))
+                continue;
+            if (!Eq{}(a.get(), b.get()))
+                return false;
+            a.next();
+            b.next();
+        }
+        return true;
+    }
+
+    static bool is_full(const node_t* n, count_t height)
+    {
+        return n->count() == (height ? inner_max : leaf_max);
+    }
+
+    static void dec_node(node_t* n, count_t height)
+    {
+        if (n->dec())
+            node_t::delete_deep(n, height);
+    }
+
+    static void ensure_mutable(edit_t e, node_t*& n, count_t height)
+    {
+        if (!n->can_mutate(e)) {
+            auto p = height ? node_t::copy_inner_e(e, n)
+                            : node_t::copy_leaf_e(e, n);
+            dec_node(n, height);
+            n = p;
+        }
+    }
+
+    // Constructs `x` at `pos` in the array of `n` elements at `data`,
+    // that has room for one more.
+    template <typename U>
+    static void insert_at(U* data, count_t n, count_t pos, U&& x)
+    {
+        if (pos == n)
+            new (data + n) U{std::move(x)};
+        else {
+            new (data + n) U{std::move(data[n - 1])};
+            std::move_backward(data + pos, data + n - 1, data + n);
+            data[pos] = std::move(x);
+        }
+    }
+
+    template <typename U>
+    static void erase_at(U* data, count_t n, count_t pos)
+    {
+        std::move(data + pos + 1, data + n, data + pos);
+        detail::destroy_at(data + n - 1);
+    }
+
+    static void insert_child(node_t* parent, count_t i, Key sep, node_t* child)
+    {
+        auto n = parent->count();
+        insert_at(parent->keys(), n - 1, i, std::move(sep));
+        auto children = parent->children();
+        std::move_backward(children + i + 1, children + n, children + n + 1);
+        children[i + 1] = child;
+        ++parent->count();
+    }
+
+    static void erase_child(node_t* parent, count_t i)
+    {
+        auto n = parent->count();
+        erase_at(parent->keys(), n - 1, i);
+        auto children = parent->children();
+        std::move(children + i + 2, children + n, children + i + 1);
+        --parent->count();
+    }
+
+    // Splits the full child `i` of the mutable node `parent` in two
+    // halves.
+    static void split_child(edit_t e, node_t* parent, count_t i, count_t height)
+    {
+        auto left = parent->children()[i];
+        auto n    = left->count();
+        auto mid  = n / 2;
+        if (height == 0) {
+            auto sep   = Key{key(left->values()[mid])};
+            auto right = node_t::make_leaf_e(e);
+            IMMER_TRY {
+                detail::uninitialized_move(left->values() + mid,
+                                           left->values() + n,
+                                           right->values());
+                right->count() = n - mid;
+                insert_child(parent, i, std::move(sep), right);
+            }
+            IMMER_CATCH (...) {
+                node_t::delete_leaf(right);
+                IMMER_RETHROW;
+            }
+            detail::destroy_n(left->values() + mid, n - mid);
+            left->count() = mid;
+        } else {
+            auto right = node_t::make_inner_e(e);
+            IMMER_TRY {
+                detail::uninitialized_move(left->keys() + mid,
+                                           left->keys() + n - 1,
+                                           right->keys());
+            }
+            IMMER_CATCH (...) {
+                node_t::delete_inner(right);
+                IMMER_RETHROW;
+            }
+            std::copy(left->children() + mid,
+                      left->children() + n,
+                      right->children());
+            right->count() = n - mid;
+            auto sep       = std::move(left->keys()[mid - 1]);
+            detail::destroy_n(left->keys() + mid - 1, n - mid);
+            left->count() = mid;
+            IMMER_TRY {
+                insert_child(parent, i, std::move(sep), right);
+            }
+            IMMER_CATCH (...) {
+                // The children now belong to `right` only.
+                node_t::delete_deep(right, height);
+                IMMER_RETHROW;
+            }
+        }
+    }
+
+    // Inserts `value`, replacing the value with the same key if there
+    // is one.  Full nodes are split on the way down, such that there
+    // is always room for the separator of a split child in its parent.
+    // Returns whether the value was added.
+    bool insert_mut(edit_t e, T value)
+    {
+        ensure_mutable(e, root, height);
+        if (is_full(root, height)) {
+            auto new_root           = node_t::make_inner_e(e);
+            new_root->children()[0] = root;
+            new_root->count()       = 1;
+            IMMER_TRY {
+                split_child(e, new_root, 0, height);
+            }
+            IMMER_CATCH (...) {
+                node_t::delete_inner(new_root);
+                IMMER_RETHROW;
+            }
+            root = new_root;
+            ++height;
+        }
+        auto n = root;
+        for (auto h = height; h > 0; --h) {
+            auto i = child_index(n, key(value));
+            ensure_mutable(e, n->children()[i], h - 1);
+            if (is_full(n->children()[i], h - 1)) {
+                split_child(e, n, i, h - 1);
+                if (!less(key(value), n->keys()[i]))
+                    ++i;
+            }
+            n = n->children()[i];
+        }
+        auto pos = leaf_lower_bound(n, key(value));
+        if (pos < n->count() && !less(key(value), key(n->values()[pos]))) {
+            n->values()[pos] = std::move(value);
+            return false;
+        } else {
+            insert_at(n->values(), n->count(), pos, std::move(value));
+            ++n->count();
+            ++size;
+            assert(check_tree());
+            return true;
+        }
+    }
+
+    btree add(T value) const
+    {
+        auto result = *this;
+        result.insert_mut(owner_t{}, std::move(value));
+        return result;
+    }
+
+    template <typename K>
+    btree sub(const K& k) const
+    {
+        if (!find(k))
+            return *this;
+        auto result = *this;
+        result.erase_mut(owner_t{}, k);
+        return result;
+    }
+
+    template <typename K>
+    bool erase_mut(edit_t e, const K& k)
+    {
+        if (!find(k))
+            return false;
+        ensure_mutable(e, root, height);
+        do_erase_mut(e, root, height, k);
+        --size;
+        if (height > 0 && root->count() == 1) {
+            auto old = root;
+            root     = old->children()[0];
+            node_t::delete_inner(old);
+            --height;
+        }
+        assert(check_tree());
+        return true;
+    }
+
+    template <typename K>
+    static void do_erase_mut(edit_t e, node_t* n, count_t height, const K& k)
+    {
+        if (height == 0) {
+            auto pos = leaf_lower_bound(n, k);
+            assert(pos < n->count());
+            erase_at(n->values(), n->count(), pos);
+            --n->count();
+        } else {
+            auto i   = child_index(n, k);
+            auto min = height - 1 ? inner_min : leaf_min;
+            ensure_mutable(e, n->children()[i], height - 1);
+            // The sibling is made mutable before anything is erased, so
+            // that running out of memory can not leave the tree broken.
+            if (n->children()[i]->count() == min)
+                ensure_mutable(e, n->children()[i > 0 ? i - 1 : i + 1],
+                               height - 1);
+            do_erase_mut(e, n->children()[i], height - 1, k);
+            if (n->children()[i]->count() < min)
+                rebalance(e, n, i, height - 1);
+        }
+    }
+
+    // Fixes the child `i` of the mutable node `parent`, which has less
+    // than the minimum number of entries, by merging it with a sibling
+    // or by taking an entry from it.
+    static void rebalance(edit_t e, node_t* parent, count_t i, count_t height)
+    {
+        auto l = i > 0 ? i - 1 : i;
+        ensure_mutable(e, parent->children()[l], height);
+        ensure_mutable(e, parent->children()[l + 1], height);
+        auto left  = parent->children()[l];
+        auto right = parent->children()[l + 1];
+        auto sep   = parent->keys() + l;
+        auto nl    = left->count();
+        auto nr    = right->count();
+        if (height == 0) {
+            if (nl + nr <= leaf_max) {
+                detail::uninitialized_move(right->values(),
+                                           right->values() + nr,
+                                           left->values() + nl);
+                left->count() = nl + nr;
+                node_t::delete_leaf(right);
+                erase_child(parent, l);
+            } else if (nl < nr) {
+                new (left->values() + nl) T{std::move(right->values()[0])};
+                ++left->count();
+                erase_at(right->values(), nr, 0);
+                --right->count();
+                *sep = key(right->values()[0]);
+            } else {
+                insert_at(right->values(),
+                          nr,
+                          0,
+                          std::move(left->values()[nl - 1]));
+                ++right->count();
+                detail::destroy_at(left->values() + nl - 1);
+                --left->count();
+                *sep = key(right->values()[0]);
+            }
+        } else {
+            if (nl + nr <= inner_max) {
+                new (left->keys() + nl - 1) Key{std::move(*sep)};
+                detail::uninitialized_move(right->keys(),
+                                           right->keys() + nr - 1,
+                                           left->keys() + nl);
+                std::copy(right->children(),
+                          right->children() + nr,
+                          left->children() + nl);
+                left->count() = nl + nr;
+                node_t::delete_inner(right);
+                erase_child(parent, l);
+            } else if (nl < nr) {
+                new (left->keys() + nl - 1) Key{std::move(*sep)};
+                left->children()[nl] = right->children()[0];
+                ++left->count();
+                *sep = std::move(right->keys()[0]);
+                erase_at(right->keys(), nr - 1, 0);
+                std::move(right->children() + 1,
+                          right->children() + nr,
+                          right->children());
+                --right->count();
+            } else {
+                insert_at(right->keys(), nr - 1, 0, std::move(*sep));
+                std::move_backward(right->children(),
+                                   right->children() + nr,
+                                   right->children() + nr + 1);
+                right->children()[0] = left->children()[nl - 1];
+                ++right->count();
+                *sep = std::move(left->keys()[nl - 2]);
+                detail::destroy_at(left->keys() + nl - 2);
+                --left->count();
+            }
+        }
+    }
+
+    bool check_tree() const
+    {
+#if IMMER_DEBUG_DEEP_CHECK
+        auto count = size_t{};
+        assert(check_node(root, height, true, nullptr, nullptr, count));
+        assert(count == size);
+#endif
+        return true;
+    }
+
+    static bool check_node(const node_t* n,
+                           count_t height,
+                           bool is_root,
+                           const Key* lo,
+                           const Key* hi,
+                           size_t& count)
+    {
+        if (height == 0) {
+            assert(is_root || n->count() >= leaf_min);
+            assert(n->count() <= leaf_max);
+            for (auto i = count_t{}; i < n->count(); ++i) {
+                auto& k = key(n->values()[i]);
+                assert(!lo || !less(k, *lo));
+                assert(!hi || less(k, *hi));
+                assert(i == 0 || less(key(n->values()[i - 1]), k));
+            }
+            count += n->count();
+        } else {
+            assert(is_root ? n->count() >= 2 : n->count() >= inner_min);
+            assert(n->count() <= inner_max);
+            for (auto i = count_t{}; i < n->count(); ++i)
+                check_node(n->children()[i],
+                           height - 1,
+                           false,
+                           i ? n->keys() + i - 1 : lo,
+                           i + 1 < n->count() ? n->keys() + i : hi,
+                           count);
+        }
+        return true;
+    }
+};
+
+} // namespace btrees
+} // namespace detail
+} // namespace immer
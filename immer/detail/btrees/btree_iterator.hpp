@@ -0,0 +1,69 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/btrees/btree.hpp>
+#include <immer/detail/iterator_facade.hpp>
+
+namespace immer {
+namespace detail {
+namespace btrees {
+
+template <typename T,
+          typename Key,
+          typename KeyOf,
+          typename Compare,
+          typename MP,
+          bits_t B,
+          bits_t BL>
+struct btree_iterator
+    : iterator_facade<btree_iterator<T, Key, KeyOf, Compare, MP, B, BL>,
+                      std::bidirectional_iterator_tag,
+                      T,
+                      const T&,
+                      std::ptrdiff_t,
+                      const T*>
+{
+    using tree_t   = btree<T, Key, KeyOf, Compare, MP, B, BL>;
+    using cursor_t = typename tree_t::cursor_t;
+
+    struct end_t
+    {};
+
+    btree_iterator() = default;
+
+    btree_iterator(const tree_t& v)
+        : c_{v.first()}
+    {}
+
+    btree_iterator(const tree_t& v, end_t)
+        : c_{v.end()}
+    {}
+
+    btree_iterator(cursor_t c)
+        : c_{c}
+    {}
+
+private:
+    friend iterator_core_access;
+
+    cursor_t c_;
+
+    void increment() { c_.next(); }
+
+    void decrement() { c_.prev(); }
+
+    bool equal(const btree_iterator& other) const { return c_ == other.c_; }
+
+    const T& dereference() const { return c_.get(); }
+};
+
+} // namespace btrees
+} // namespace detail
+} // namespace immer
@@ -0,0 +1,284 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/btrees/bits.hpp>
+#include <immer/detail/combine_standard_layout.hpp>
+#include <immer/detail/util.hpp>
+#include <immer/probe.hpp>
+#include <immer/reclamation/reclamation_queue.hpp>
+
+#include <cassert>
+#include <cstddef>
+
+namespace immer {
+namespace detail {
+namespace btrees {
+
+// A node of a B+-tree.  Leaves hold up to `branches<BL>` values and
+// inner nodes up to `branches<B>` children, separated by one key less.
+// The key at `i` is less than or equal than all the keys in the child
+// at `i + 1`, and greater than all the keys in the child at `i`.  Nodes
+// are always allocated with room for a full node, such that they can
+// be updated in place by transients.
+template <typename T, typename Key, typename MemoryPolicy, bits_t B, bits_t BL>
+struct node
+{
+    using node_t = node;
+
+    using memory      = MemoryPolicy;
+    using heap_policy = typename memory::heap;
+    using heap        = typename heap_policy::type;
+    using transience  = typename memory::transience_t;
+    using refs_t      = typename memory::refcount;
+    using ownee_t     = typename transience::ownee;
+    using edit_t      = typename transience::edit;
+    using value_t     = T;
+    using key_t       = Key;
+
+    static constexpr auto inner_max = branches<B>;
+    static constexpr auto leaf_max  = branches<BL>;
+
+    enum class kind_t
+    {
+        leaf,
+        inner
+    };
+
+    struct leaf_t
+    {
+        aligned_storage_for<T> buffer;
+    };
+
+    struct inner_t
+    {
+        node_t* children[branches<B>];
+        aligned_storage_for<Key> keys;
+    };
+
+    union data_t
+    {
+        leaf_t leaf;
+        inner_t inner;
+    };
+
+    struct impl_data_t
+    {
+#if IMMER_TAGGED_NODE
+        kind_t kind;
+#endif
+        count_t count;
+        data_t data;
+    };
+
+    using impl_t = combine_standard_layout_t<impl_data_t, refs_t, ownee_t>;
+
+    impl_t impl;
+
+    constexpr static std::size_t sizeof_leaf =
+        immer_offsetof(impl_t, d.data.leaf.buffer) + sizeof(T) * leaf_max;
+
+    constexpr static std::size_t sizeof_inner =
+        immer_offsetof(impl_t, d.data.inner.keys) +
+        sizeof(Key) * (inner_max - 1);
+
+#if IMMER_TAGGED_NODE
+    kind_t kind() const { return impl.d.kind; }
+#endif
+
+    count_t count() const { return impl.d.count; }
+    count_t& count() { return impl.d.count; }
+
+    T* values()
+    {
+        IMMER_ASSERT_TAGGED(kind() == kind_t::leaf);
+        return reinterpret_cast<T*>(&impl.d.data.leaf.buffer);
+    }
+
+    const T* values() const
+    {
+        IMMER_ASSERT_TAGGED(kind() == kind_t::leaf);
+        return reinterpret_cast<const T*>(&impl.d.data.leaf.buffer);
+    }
+
+    node_t** children()
+    {
+        IMMER_ASSERT_TAGGED(kind() == kind_t::inner);
+        return impl.d.data.inner.children;
+    }
+
+    const node_t* const* children() const
+    {
+        IMMER_ASSERT_TAGGED(kind() == kind_t::inner);
+        return impl.d.data.inner.children;
+    }
+
+    Key* keys()
+    {
+        IMMER_ASSERT_TAGGED(kind() == kind_t::inner);
+        return reinterpret_cast<Key*>(&impl.d.data.inner.keys);
+    }
+
+    const Key* keys() const
+    {
+        IMMER_ASSERT_TAGGED(kind() == kind_t::inner);
+        return reinterpret_cast<const Key*>(&impl.d.data.inner.keys);
+    }
+
+    static refs_t& refs(const node_t* x)
+    {
+        return auto_const_cast(get<refs_t>(x->impl));
+    }
+    static const ownee_t& ownee(const node_t* x)
+    {
+        return get<ownee_t>(x->impl);
+    }
+    static ownee_t& ownee(node_t* x) { return get<ownee_t>(x->impl); }
+
+    bool can_mutate(edit_t e) const
+    {
+        return IMMER_PROBE_MUTATE(refs(this).unique() ||
+                                  ownee(this).can_mutate(e));
+    }
+
+    const node_t* inc() const
+    {
+        refs(this).inc();
+        return this;
+    }
+
+    node_t* inc()
+    {
+        refs(this).inc();
+        return this;
+    }
+
+    bool dec() const { return refs(this).dec(); }
+
+    static node_t* make_leaf_n()
+    {
+        IMMER_PROBE(leaf_alloc);
+        auto p = new (heap::allocate(sizeof_leaf)) node_t;
+#if IMMER_TAGGED_NODE
+        p->impl.d.kind = kind_t::leaf;
+#endif
+        p->impl.d.count = 0;
+        return p;
+    }
+
+    static node_t* make_leaf_e(edit_t e)
+    {
+        auto p   = make_leaf_n();
+        ownee(p) = e;
+        return p;
+    }
+
+    static node_t* make_inner_e(edit_t e)
+    {
+        IMMER_PROBE(inner_alloc);
+        auto p = new (heap::allocate(sizeof_inner)) node_t;
+#if IMMER_TAGGED_NODE
+        p->impl.d.kind = kind_t::inner;
+#endif
+        p->impl.d.count = 0;
+        ownee(p)        = e;
+        return p;
+    }
+
+    static node_t* copy_leaf_e(edit_t e, const node_t* src)
+    {
+        IMMER_PROBE(node_copy);
+        auto dst = make_leaf_e(e);
+        IMMER_TRY {
+            detail::uninitialized_copy(
+                src->values(), src->values() + src->count(), dst->values());
+        }
+        IMMER_CATCH (...) {
+            heap::deallocate(sizeof_leaf, dst);
+            IMMER_RETHROW;
+        }
+        dst->count() = src->count();
+        return dst;
+    }
+
+    static node_t* copy_inner_e(edit_t e, const node_t* src)
+    {
+        IMMER_PROBE(node_copy);
+        auto dst = make_inner_e(e);
+        auto n   = src->count();
+        IMMER_TRY {
+            detail::uninitialized_copy(
+                src->keys(), src->keys() + n - 1, dst->keys());
+        }
+        IMMER_CATCH (...) {
+            heap::deallocate(sizeof_inner, dst);
+            IMMER_RETHROW;
+        }
+        auto children = dst->children();
+        for (auto i = count_t{}; i < n; ++i)
+            children[i] = const_cast<node_t*>(src->children()[i])->inc();
+        dst->count() = n;
+        return dst;
+    }
+
+    static void delete_leaf(node_t* p)
+    {
+        IMMER_ASSERT_TAGGED(p->kind() == kind_t::leaf);
+        detail::destroy_n(p->values(), p->count());
+        heap::deallocate(sizeof_leaf, p);
+    }
+
+    // Frees the node and its keys, but not its children.
+    static void delete_inner(node_t* p)
+    {
+        IMMER_ASSERT_TAGGED(p->kind() == kind_t::inner);
+        if (p->count())
+            detail::destroy_n(p->keys(), p->count() - 1);
+        heap::deallocate(sizeof_inner, p);
+    }
+
+    static void delete_deep(node_t* p, count_t height)
+    {
+        if (height == 0)
+            delete_leaf(p);
+        else {
+            auto fst = p->children();
+            auto lst = fst + p->count();
+            for (; fst != lst; ++fst)
+                if ((*fst)->dec())
+                    delete_deep(*fst, height - 1);
+            delete_inner(p);
+        }
+    }
+
+    // Like `delete_deep`, but only frees `p`, enqueueing the children
+    // that are no longer referenced, as a step of a reclamation queue.
+    static void reclaim_deep(reclamation_queue& q,
+                             void* node,
+                             std::size_t height,
+                             std::size_t)
+    {
+        auto p = static_cast<node_t*>(node);
+        if (height == 0)
+            delete_leaf(p);
+        else {
+            auto fst = p->children();
+            auto lst = fst + p->count();
+            for (; fst != lst; ++fst)
+                if ((*fst)->dec())
+                    q.push(&reclaim_deep, *fst, height - 1);
+            delete_inner(p);
+        }
+    }
+};
+
+} // namespace btrees
+} // namespace detail
+} // namespace immer
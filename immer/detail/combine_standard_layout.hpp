@@ -200,8 +200,32 @@ struct combine_standard_layout_aux<T>
                                              csl::member<T>>::type;
 };
 
+template <typename T, typename... Ts>
+struct is_one_of : std::false_type
+{};
+
+template <typename T, typename U, typename... Ts>
+struct is_one_of<T, U, Ts...>
+    : std::conditional_t<std::is_same<T, U>::value,
+                         std::true_type,
+                         is_one_of<T, Ts...>>
+{};
+
+template <typename T, typename... Ts>
+struct combine_standard_layout_distinct;
+
+// A type that is repeated is stored only once, so that, for example,
+// a reference count that also tracks the transience ownership can
+// play both roles.
 template <typename T, typename... Ts>
 struct combine_standard_layout_aux<T, Ts...>
+    : std::conditional_t<is_one_of<T, Ts...>::value,
+                         combine_standard_layout_aux<Ts...>,
+                         combine_standard_layout_distinct<T, Ts...>>
+{};
+
+template <typename T, typename... Ts>
+struct combine_standard_layout_distinct
 {
     static_assert(std::is_standard_layout<T>::value, "");
 
@@ -10,8 +10,10 @@
 
 #include <immer/config.hpp>
 #include <immer/detail/hamts/node.hpp>
+#include <immer/reclamation/immediate_reclamation_policy.hpp>
 
 #include <algorithm>
+#include <vector>
 
 namespace immer {
 namespace detail {
@@ -127,10 +129,11 @@ struct champ
 {
     static constexpr auto bits = B;
 
-    using node_t   = node<T, Hash, Equal, MemoryPolicy, B>;
-    using edit_t   = typename MemoryPolicy::transience_t::edit;
-    using owner_t  = typename MemoryPolicy::transience_t::owner;
-    using bitmap_t = typename get_bitmap_type<B>::type;
+    using node_t    = node<T, Hash, Equal, MemoryPolicy, B>;
+    using edit_t    = typename MemoryPolicy::transience_t::edit;
+    using owner_t   = typename MemoryPolicy::transience_t::owner;
+    using bitmap_t  = typename get_bitmap_type<B>::type;
+    using reclaim_t = get_reclamation_policy_t<MemoryPolicy>;
 
     static_assert(branches<B> <= sizeof(bitmap_t) * 8, "");
 
@@ -187,9 +190,35 @@ struct champ
     void dec() const
     {
         if (root->dec())
+            dec_impl(std::integral_constant<bool, reclaim_t::deferred>{});
+    }
+
+    void dec_impl(std::false_type) const
+    {
+        if (use_iterative())
+            node_t::delete_deep_iter(root);
+        else
             node_t::delete_deep(root, 0);
     }
 
+    // Whether the trie is expected to have at least
+    // `IMMER_ITERATIVE_MIN_DEPTH` levels, such that it is traversed
+    // without recursion.
+    bool use_iterative() const
+    {
+        constexpr auto depth = IMMER_ITERATIVE_MIN_DEPTH;
+        constexpr auto bits  = std::min<std::size_t>(
+            depth > 1 ? B * (depth - 1) : 0, sizeof(std::size_t) * 8 - 1);
+        return (size >> bits) != 0 || depth <= 1;
+    }
+
+    void dec_impl(std::true_type) const
+    {
+        auto& q = reclaim_t::queue();
+        q.push(&node_t::reclaim_deep, root, 0);
+        q.drain(reclaim_t::budget);
+    }
+
 #if IMMER_DEBUG_STATS
     void do_get_debug_stats(champ_debug_stats& stats,
                             node_t* node,
@@ -247,7 +276,43 @@ struct champ
     template <typename Fn>
     void for_each_chunk(Fn&& fn) const
     {
-        for_each_chunk_traversal(root, 0, fn);
+        if (use_iterative())
+            for_each_chunk_iter(fn);
+        else
+            for_each_chunk_traversal(root, 0, fn);
+    }
+
+    template <typename Fn>
+    void for_each_chunk_iter(Fn&& fn) const
+    {
+        struct frame
+        {
+            const node_t* node;
+            count_t i;
+            count_t count;
+        };
+        frame stack[max_depth<B>];
+        auto top   = stack;
+        auto enter = [&](const node_t* node) {
+            if (node->datamap())
+                fn(node->values(), node->values() + node->data_count());
+            *top++ = {node, 0, node->children_count()};
+        };
+        enter(root);
+        while (top != stack) {
+            auto& f = top[-1];
+            if (f.i == f.count)
+                --top;
+            else {
+                auto child = f.node->children()[f.i++];
+                if (top - stack < max_depth<B>)
+                    enter(child);
+                else {
+                    auto collisions = child->collisions();
+                    fn(collisions, collisions + child->collision_count());
+                }
+            }
+        }
     }
 
     template <typename Fn>
@@ -271,6 +336,35 @@ struct champ
         }
     }
 
+    // Calls `fn(node, bytes)` for every node in the trie, and for every
+    // array of values of the inner nodes, passing the number of bytes
+    // allocated for it.
+    template <typename Fn>
+    void for_each_node(Fn&& fn) const
+    {
+        for_each_node_traversal(root, 0, fn);
+    }
+
+    template <typename Fn>
+    void
+    for_each_node_traversal(const node_t* node, count_t depth, Fn&& fn) const
+    {
+        if (depth < max_depth<B>) {
+            fn(static_cast<const void*>(node),
+               node_t::sizeof_inner_n(node->children_count()));
+            if (auto values = node->impl.d.data.inner.values)
+                fn(static_cast<const void*>(values),
+                   node_t::sizeof_values_n(node->data_count()));
+            auto fst = node->children();
+            auto lst = fst + node->children_count();
+            for (; fst != lst; ++fst)
+                for_each_node_traversal(*fst, depth + 1, fn);
+        } else {
+            fn(static_cast<const void*>(node),
+               node_t::sizeof_collision_n(node->collision_count()));
+        }
+    }
+
     template <typename EqualValue, typename Differ>
     void diff(const champ& new_champ, Differ&& differ) const
     {
@@ -538,15 +632,17 @@ struct champ
                 auto offset = node->data_count(bit);
                 auto val    = node->values() + offset;
                 if (Equal{}(*val, v))
-                    return {node_t::copy_inner_replace_value(
-                                node, offset, std::move(v)),
+                    return {node_t::intern_values(
+                                node_t::copy_inner_replace_value(
+                                    node, offset, std::move(v))),
                             false};
                 else {
                     auto child = node_t::make_merged(
                         shift + B, std::move(v), hash, *val, Hash{}(*val));
                     IMMER_TRY {
-                        return {node_t::copy_inner_replace_merged(
-                                    node, bit, offset, child),
+                        return {node_t::intern_values(
+                                    node_t::copy_inner_replace_merged(
+                                        node, bit, offset, child)),
                                 true};
                     }
                     IMMER_CATCH (...) {
@@ -555,9 +651,9 @@ struct champ
                     }
                 }
             } else {
-                return {
-                    node_t::copy_inner_insert_value(node, bit, std::move(v)),
-                    true};
+                return {node_t::intern_values(node_t::copy_inner_insert_value(
+                            node, bit, std::move(v))),
+                        true};
             }
         }
     }
@@ -734,12 +830,13 @@ struct champ
                 auto offset = node->data_count(bit);
                 auto val    = node->values() + offset;
                 if (Equal{}(*val, k))
-                    return {node_t::copy_inner_replace_value(
-                                node,
-                                offset,
-                                Combine{}(std::forward<K>(k),
-                                          std::forward<Fn>(fn)(Project{}(
-                                              detail::as_const(*val))))),
+                    return {node_t::intern_values(
+                                node_t::copy_inner_replace_value(
+                                    node,
+                                    offset,
+                                    Combine{}(std::forward<K>(k),
+                                              std::forward<Fn>(fn)(Project{}(
+                                                  detail::as_const(*val)))))),
                             false};
                 else {
                     auto child = node_t::make_merged(
@@ -750,8 +847,9 @@ struct champ
                         *val,
                         Hash{}(*val));
                     IMMER_TRY {
-                        return {node_t::copy_inner_replace_merged(
-                                    node, bit, offset, child),
+                        return {node_t::intern_values(
+                                    node_t::copy_inner_replace_merged(
+                                        node, bit, offset, child)),
                                 true};
                     }
                     IMMER_CATCH (...) {
@@ -760,11 +858,11 @@ struct champ
                     }
                 }
             } else {
-                return {node_t::copy_inner_insert_value(
+                return {node_t::intern_values(node_t::copy_inner_insert_value(
                             node,
                             bit,
                             Combine{}(std::forward<K>(k),
-                                      std::forward<Fn>(fn)(Default{}()))),
+                                      std::forward<Fn>(fn)(Default{}())))),
                         true};
             }
         }
@@ -824,12 +922,13 @@ struct champ
                 auto offset = node->data_count(bit);
                 auto val    = node->values() + offset;
                 if (Equal{}(*val, k))
-                    return node_t::copy_inner_replace_value(
-                        node,
-                        offset,
-                        Combine{}(std::forward<K>(k),
-                                  std::forward<Fn>(fn)(
-                                      Project{}(detail::as_const(*val)))));
+                    return node_t::intern_values(
+                        node_t::copy_inner_replace_value(
+                            node,
+                            offset,
+                            Combine{}(std::forward<K>(k),
+                                      std::forward<Fn>(fn)(
+                                          Project{}(detail::as_const(*val))))));
                 else {
                     return nullptr;
                 }
@@ -1173,8 +1272,12 @@ struct champ
                     return node->datamap() == 0 &&
                                    node->children_count() == 1 && shift > 0
                                ? result
-                               : node_t::copy_inner_replace_inline(
-                                     node, bit, offset, *result.data.singleton);
+                               : node_t::intern_values(
+                                     node_t::copy_inner_replace_inline(
+                                         node,
+                                         bit,
+                                         offset,
+                                         *result.data.singleton));
                 case sub_result::tree:
                     IMMER_TRY {
                         return node_t::copy_inner_replace(
@@ -1191,8 +1294,8 @@ struct champ
                 if (Equal{}(*val, k)) {
                     auto nv = node->data_count();
                     if (node->nodemap() || nv > 2)
-                        return node_t::copy_inner_remove_value(
-                            node, bit, offset);
+                        return node_t::intern_values(
+                            node_t::copy_inner_remove_value(node, bit, offset));
                     else if (nv == 2) {
                         return shift > 0 ? sub_result{node->values() + !offset}
                                          : node_t::make_inner_n(
@@ -1418,6 +1521,260 @@ struct champ
         }
     }
 
+    // Builds a trie of type `Champ` with the same shape as this one,
+    // where every value `v` is replaced by `fn(v)`.  `fn` must not
+    // change what `Hash` and `Equal` see, so nothing is rehashed.
+    template <typename Champ, typename Fn>
+    static typename Champ::node_t*
+    do_transform(const node_t* node, count_t depth, Fn& fn)
+    {
+        using onode_t = typename Champ::node_t;
+        using ovalue_t = typename onode_t::value_t;
+        if (depth == max_depth<B>) {
+            auto n   = node->collision_count();
+            auto r   = onode_t::make_collision_n(n);
+            auto src = node->collisions();
+            auto dst = r->collisions();
+            auto i   = count_t{};
+            IMMER_TRY {
+                for (; i < n; ++i)
+                    new (dst + i) ovalue_t{fn(src[i])};
+            }
+            IMMER_CATCH (...) {
+                detail::destroy_n(dst, i);
+                onode_t::deallocate_collision(r, n);
+                IMMER_RETHROW;
+            }
+            return r;
+        } else {
+            auto nn                      = node->children_count();
+            auto nv                      = node->data_count();
+            auto r                       = onode_t::make_inner_n(nn, nv);
+            r->impl.d.data.inner.nodemap = node->nodemap();
+            r->impl.d.data.inner.datamap = node->datamap();
+            if (nv) {
+                auto src = node->values();
+                auto dst = r->values();
+                auto i   = count_t{};
+                IMMER_TRY {
+                    for (; i < nv; ++i)
+                        new (dst + i) ovalue_t{fn(src[i])};
+                }
+                IMMER_CATCH (...) {
+                    detail::destroy_n(dst, i);
+                    onode_t::deallocate_inner(r, nn, nv);
+                    IMMER_RETHROW;
+                }
+            }
+            auto i = count_t{};
+            IMMER_TRY {
+                for (; i < nn; ++i)
+                    r->children()[i] = do_transform<Champ>(
+                        node->children()[i], depth + 1, fn);
+            }
+            IMMER_CATCH (...) {
+                for (auto j = count_t{}; j < i; ++j)
+                    onode_t::delete_deep(r->children()[j], depth + 1);
+                onode_t::delete_inner(r);
+                IMMER_RETHROW;
+            }
+            return r;
+        }
+    }
+
+    template <typename Champ, typename Fn>
+    Champ transform(Fn&& fn) const
+    {
+        if (!size)
+            return Champ{Champ::empty()};
+        return Champ{do_transform<Champ>(root, 0, fn), size};
+    }
+
+    struct filter_result
+    {
+        enum kind_t
+        {
+            nothing,
+            singleton,
+            tree,
+            same
+        };
+
+        kind_t kind;
+        union
+        {
+            const T* singleton;
+            node_t* tree;
+        } data;
+    };
+
+    // Keeps the values for which `pred` is true, sharing the subtrees
+    // where all values are kept and never calling `Hash`.  Like
+    // `do_sub`, it keeps the trie canonical: emptied subtrees are
+    // removed and those left with a single value are inlined in their
+    // parent.
+    template <typename Pred>
+    static filter_result
+    do_filter(node_t* node, count_t depth, Pred& pred, size_t& count)
+    {
+        if (depth == max_depth<B>) {
+            auto n    = node->collision_count();
+            auto src  = node->collisions();
+            auto keep = std::vector<bool>(n);
+            auto kept = count_t{};
+            for (auto i = count_t{}; i < n; ++i)
+                if (pred(src[i])) {
+                    keep[i] = true;
+                    ++kept;
+                }
+            count += kept;
+            if (kept == n)
+                return {filter_result::same, {nullptr}};
+            else if (kept == 0)
+                return {filter_result::nothing, {nullptr}};
+            else if (kept == 1) {
+                auto r = filter_result{filter_result::singleton, {nullptr}};
+                r.data.singleton =
+                    src + (std::find(keep.begin(), keep.end(), true) -
+                           keep.begin());
+                return r;
+            }
+            auto r   = node_t::make_collision_n(kept);
+            auto dst = r->collisions();
+            auto j   = count_t{};
+            IMMER_TRY {
+                for (auto i = count_t{}; i < n; ++i)
+                    if (keep[i])
+                        new (dst + j++) T{src[i]};
+            }
+            IMMER_CATCH (...) {
+                detail::destroy_n(dst, j);
+                node_t::deallocate_collision(r, kept);
+                IMMER_RETHROW;
+            }
+            auto res      = filter_result{filter_result::tree, {nullptr}};
+            res.data.tree = r;
+            return res;
+        } else {
+            auto nn       = node->children_count();
+            auto nodemap  = node->nodemap();
+            auto datamap  = node->datamap();
+            auto children = node->children();
+            filter_result results[branches<B>];
+            auto done = count_t{};
+            IMMER_TRY {
+                auto kept_datamap = bitmap_t{};
+                auto src          = datamap ? node->values() : nullptr;
+                for (auto map = datamap, i = count_t{}; map;
+                     map &= map - 1, ++i) {
+                    if (pred(src[i])) {
+                        kept_datamap |= map & ~(map - 1);
+                        ++count;
+                    }
+                }
+                auto all_same      = kept_datamap == datamap;
+                auto new_nodemap   = bitmap_t{};
+                auto singleton_map = bitmap_t{};
+                for (auto map = nodemap; map; map &= map - 1, ++done) {
+                    auto bit      = static_cast<bitmap_t>(map & ~(map - 1));
+                    results[done] = do_filter(
+                        children[done], depth + 1, pred, count);
+                    switch (results[done].kind) {
+                    case filter_result::nothing:
+                        all_same = false;
+                        break;
+                    case filter_result::singleton:
+                        all_same = false;
+                        singleton_map |= bit;
+                        break;
+                    case filter_result::tree:
+                        all_same = false;
+                        new_nodemap |= bit;
+                        break;
+                    case filter_result::same:
+                        new_nodemap |= bit;
+                        break;
+                    }
+                }
+                if (all_same)
+                    return {filter_result::same, {nullptr}};
+                auto new_datamap =
+                    static_cast<bitmap_t>(kept_datamap | singleton_map);
+                auto new_nv = popcount(new_datamap);
+                if (!new_nodemap && new_nv == 0)
+                    return {filter_result::nothing, {nullptr}};
+                if (!new_nodemap && new_nv == 1 && depth > 0) {
+                    auto r = filter_result{filter_result::singleton, {nullptr}};
+                    r.data.singleton =
+                        kept_datamap
+                            ? src + node->data_count(kept_datamap)
+                            : results[node->children_count(singleton_map)]
+                                  .data.singleton;
+                    return r;
+                }
+                auto new_nn = popcount(new_nodemap);
+                auto r      = node_t::make_inner_n(new_nn, new_nv);
+                r->impl.d.data.inner.nodemap = new_nodemap;
+                r->impl.d.data.inner.datamap = new_datamap;
+                if (new_nv) {
+                    auto dst = r->values();
+                    auto j   = count_t{};
+                    IMMER_TRY {
+                        for (auto map = new_datamap; map; map &= map - 1) {
+                            auto bit = static_cast<bitmap_t>(map & ~(map - 1));
+                            auto& v  = (kept_datamap & bit)
+                                          ? src[node->data_count(bit)]
+                                          : *results[node->children_count(bit)]
+                                                 .data.singleton;
+                            new (dst + j) T{v};
+                            ++j;
+                        }
+                    }
+                    IMMER_CATCH (...) {
+                        detail::destroy_n(dst, j);
+                        node_t::deallocate_inner(r, new_nn, new_nv);
+                        IMMER_RETHROW;
+                    }
+                }
+                auto out = r->children();
+                for (auto i = count_t{}; i < nn; ++i) {
+                    if (results[i].kind == filter_result::tree)
+                        *out++ = results[i].data.tree;
+                    else if (results[i].kind == filter_result::same) {
+                        node_t::refs(children[i]).inc();
+                        *out++ = children[i];
+                    }
+                }
+                auto res      = filter_result{filter_result::tree, {nullptr}};
+                res.data.tree = r;
+                return res;
+            }
+            IMMER_CATCH (...) {
+                for (auto i = count_t{}; i < done; ++i)
+                    if (results[i].kind == filter_result::tree)
+                        node_t::delete_deep(results[i].data.tree, depth + 1);
+                IMMER_RETHROW;
+            }
+        }
+    }
+
+    template <typename Pred>
+    champ filter(Pred&& pred) const
+    {
+        auto count = size_t{};
+        auto res   = do_filter(root, 0, pred, count);
+        switch (res.kind) {
+        case filter_result::same:
+            return *this;
+        case filter_result::nothing:
+            return {empty()};
+        case filter_result::tree:
+            return {res.data.tree, count};
+        default:
+            IMMER_UNREACHABLE;
+        }
+    }
+
     template <typename Eq = Equal>
     bool equals(const champ& other) const
     {
@@ -1449,7 +1806,7 @@ struct champ
     template <typename Eq>
     static bool equals_values(const T* a, const T* b, count_t n)
     {
-        return std::equal(a, a + n, b, Eq{});
+        return a == b || std::equal(a, a + n, b, Eq{});
     }
 
     template <typename Eq>
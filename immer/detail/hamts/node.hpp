@@ -12,9 +12,14 @@
 #include <immer/detail/combine_standard_layout.hpp>
 #include <immer/detail/hamts/bits.hpp>
 #include <immer/detail/util.hpp>
+#include <immer/interning/no_interning_policy.hpp>
+#include <immer/probe.hpp>
+#include <immer/reclamation/reclamation_queue.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <type_traits>
 
 namespace immer {
 namespace detail {
@@ -195,7 +200,7 @@ struct node
     static ownee_t& ownee(values_t* x) { return get<ownee_t>(*x); }
     static bool can_mutate(values_t* x, edit_t e)
     {
-        return refs(x).unique() || ownee(x).can_mutate(e);
+        return IMMER_PROBE_MUTATE(refs(x).unique() || ownee(x).can_mutate(e));
     }
 
     static refs_t& refs(const node_t* x)
@@ -210,7 +215,8 @@ struct node
 
     bool can_mutate(edit_t e) const
     {
-        return refs(this).unique() || ownee(this).can_mutate(e);
+        return IMMER_PROBE_MUTATE(refs(this).unique() ||
+                                  ownee(this).can_mutate(e));
     }
     bool can_mutate_values(edit_t e) const
     {
@@ -219,6 +225,7 @@ struct node
 
     static node_t* make_inner_n(count_t n)
     {
+        IMMER_PROBE(inner_alloc);
         assert(n <= branches<B>);
         auto m = heap::allocate(sizeof_inner_n(n));
         auto p = new (m) node_t;
@@ -247,6 +254,7 @@ struct node
         assert(nv <= branches<B>);
         auto p = make_inner_n(n);
         if (nv) {
+            IMMER_PROBE(values_alloc);
             IMMER_TRY {
                 p->impl.d.data.inner.values =
                     new (heap::allocate(sizeof_values_n(nv))) values_t{};
@@ -315,6 +323,7 @@ struct node
 
     static node_t* make_collision_n(count_t n)
     {
+        IMMER_PROBE(collision_alloc);
         auto m = heap::allocate(sizeof_collision_n(n));
         auto p = new (m) node_t;
 #if IMMER_TAGGED_NODE
@@ -326,6 +335,7 @@ struct node
 
     static node_t* make_collision(T v1, T v2)
     {
+        IMMER_PROBE(collision_alloc);
         auto m = heap::allocate(sizeof_collision_n(2));
         auto p = new (m) node_t;
 #if IMMER_TAGGED_NODE
@@ -357,6 +367,7 @@ struct node
         if (node_t::can_mutate(old, e))
             return values();
         else {
+            IMMER_PROBE(values_alloc);
             auto nv    = data_count();
             auto nxt   = new (heap::allocate(sizeof_values_n(nv))) values_t{};
             auto dst   = (T*) &nxt->d.buffer;
@@ -378,6 +389,7 @@ struct node
 
     static node_t* copy_collision_insert(node_t* src, T v)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::collision);
         auto n    = src->collision_count();
         auto dst  = make_collision_n(n + 1);
@@ -427,6 +439,7 @@ struct node
 
     static node_t* copy_collision_remove(node_t* src, T* v)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::collision);
         assert(src->collision_count() > 1);
         auto n    = src->collision_count();
@@ -478,6 +491,7 @@ struct node
 
     static node_t* copy_collision_replace(node_t* src, T* pos, T v)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::collision);
         auto n    = src->collision_count();
         auto dst  = make_collision_n(n);
@@ -511,6 +525,7 @@ struct node
     static node_t*
     copy_inner_replace(node_t* src, count_t offset, node_t* child)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto n    = src->children_count();
         auto dst  = make_inner_n(n, src->impl.d.data.inner.values);
@@ -548,6 +563,7 @@ struct node
 
     static node_t* copy_inner_replace_value(node_t* src, count_t offset, T v)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         assert(offset < src->data_count());
         auto n                         = src->children_count();
@@ -580,6 +596,7 @@ struct node
                                              count_t voffset,
                                              node_t* node)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         assert(!(src->nodemap() & bit));
         assert(src->datamap() & bit);
@@ -675,6 +692,7 @@ struct node
                                              count_t noffset,
                                              T value)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         assert(!(src->datamap() & bit));
         assert(src->nodemap() & bit);
@@ -785,6 +803,7 @@ struct node
     static node_t*
     copy_inner_remove_value(node_t* src, bitmap_t bit, count_t voffset)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         assert(!(src->nodemap() & bit));
         assert(src->datamap() & bit);
@@ -879,6 +898,7 @@ struct node
 
     static node_t* copy_inner_insert_value(node_t* src, bitmap_t bit, T v)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto n                         = src->children_count();
         auto nv                        = src->data_count();
@@ -1061,6 +1081,62 @@ struct node
         deallocate_values(p, n);
     }
 
+    struct values_interning_traits
+    {
+        using node_t  = values_t;
+        using count_t = hamts::count_t;
+        using lock_t  = typename memory::lock;
+
+        static std::size_t hash(values_t* p, count_t n)
+        {
+            auto h = std::size_t{};
+            for (auto i = (T*) &p->d.buffer, e = i + n; i != e; ++i)
+                h = hash_combine(h, Hash{}(*i));
+            return h;
+        }
+
+        static bool equals(values_t* a, values_t* b, count_t n)
+        {
+            auto pa = (T*) &a->d.buffer;
+            return std::equal(pa, pa + n, (T*) &b->d.buffer);
+        }
+
+        static void inc(values_t* p) { refs(p).inc(); }
+        static bool unique(values_t* p) { return refs(p).unique(); }
+        static void release(values_t* p, count_t n)
+        {
+            if (refs(p).dec())
+                delete_values(p, n);
+        }
+    };
+
+    // Replaces the values of `p`, that was just made by a persistent
+    // update, by an equal interned array when the memory policy
+    // interns nodes.
+    static node_t* intern_values(node_t* p)
+    {
+        return intern_values(p, interning_enabled_t<memory>{});
+    }
+
+    static node_t* intern_values(node_t* p, std::false_type) { return p; }
+
+    static node_t* intern_values(node_t* p, std::true_type)
+    {
+        static_assert(!std::is_empty<refs_t>::value,
+                      "interning requires a reference counting policy");
+        using table_t = typename get_interning_policy_t<
+            memory>::template table<values_interning_traits>;
+        auto vp = p->impl.d.data.inner.values;
+        if (vp) {
+            auto nv = p->data_count();
+            auto r  = table_t::instance().intern(vp, nv);
+            if (refs(vp).dec())
+                delete_values(vp, nv);
+            p->impl.d.data.inner.values = r;
+        }
+        return p;
+    }
+
     static void delete_inner(node_t* p)
     {
         assert(p);
@@ -1094,6 +1170,57 @@ struct node
         }
     }
 
+    // Like `delete_deep`, but using a fixed size explicit stack instead
+    // of recursion.
+    static void delete_deep_iter(node_t* p)
+    {
+        struct frame
+        {
+            node_t* node;
+            count_t i;
+            count_t count;
+        };
+        frame stack[max_depth<B> + 1];
+        auto top = stack;
+        *top++   = {p, 0, p->children_count()};
+        while (top != stack) {
+            auto& f = top[-1];
+            if (top - stack > max_depth<B>) {
+                delete_collision(f.node);
+                --top;
+            } else if (f.i == f.count) {
+                delete_inner(f.node);
+                --top;
+            } else {
+                auto child = f.node->children()[f.i++];
+                if (child->dec()) {
+                    auto count = top - stack < max_depth<B>
+                                     ? child->children_count()
+                                     : count_t{};
+                    *top++     = {child, 0, count};
+                }
+            }
+        }
+    }
+
+    // Like `delete_deep`, but only frees `p`, enqueueing the children
+    // that are no longer referenced, as a step of a reclamation queue.
+    static void
+    reclaim_deep(reclamation_queue& q, void* node, std::size_t s, std::size_t)
+    {
+        auto p = static_cast<node_t*>(node);
+        if (s == max_depth<B>)
+            delete_collision(p);
+        else {
+            auto fst = p->children();
+            auto lst = fst + p->children_count();
+            for (; fst != lst; ++fst)
+                if ((*fst)->dec())
+                    q.push(&reclaim_deep, *fst, s + 1);
+            delete_inner(p);
+        }
+    }
+
     static void delete_deep_shift(node_t* p, shift_t s)
     {
         if (s == max_shift<B>)
@@ -0,0 +1,267 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/heaps/node.hpp>
+#include <immer/detail/type_traits.hpp>
+#include <immer/reclamation/immediate_reclamation_policy.hpp>
+
+#include <cassert>
+#include <initializer_list>
+#include <utility>
+
+namespace immer {
+namespace detail {
+namespace heaps {
+
+// Leftist heap where the root holds the element that is not ordered
+// before any other by `Compare`.  All the operations are based on
+// merging two heaps along their right spines, which takes
+// `O(log(size))` in the worst case, also when old versions are
+// reused.  Nodes that can be mutated, because they are unique or
+// owned by the edit, are updated in place instead of copied.
+template <typename T, typename Compare, typename MemoryPolicy>
+struct leftist_heap
+{
+    using node_t    = node<T, MemoryPolicy>;
+    using edit_t    = typename MemoryPolicy::transience_t::edit;
+    using owner_t   = typename MemoryPolicy::transience_t::owner;
+    using reclaim_t = get_reclamation_policy_t<MemoryPolicy>;
+
+    size_t size;
+    node_t* root;
+
+    leftist_heap()
+        : size{0}
+        , root{nullptr}
+    {}
+
+    leftist_heap(size_t sz, node_t* r)
+        : size{sz}
+        , root{r}
+    {}
+
+    leftist_heap(const leftist_heap& other)
+        : leftist_heap{other.size, other.root}
+    {
+        inc();
+    }
+
+    leftist_heap(leftist_heap&& other)
+        : leftist_heap{}
+    {
+        swap(*this, other);
+    }
+
+    leftist_heap& operator=(const leftist_heap& other)
+    {
+        auto next = other;
+        swap(*this, next);
+        return *this;
+    }
+
+    leftist_heap& operator=(leftist_heap&& other)
+    {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(leftist_heap& x, leftist_heap& y)
+    {
+        using std::swap;
+        swap(x.size, y.size);
+        swap(x.root, y.root);
+    }
+
+    ~leftist_heap() { dec(); }
+
+    void inc() const
+    {
+        if (root)
+            root->inc();
+    }
+
+    void dec() const
+    {
+        if (root && root->dec())
+            dec_impl(std::integral_constant<bool, reclaim_t::deferred>{});
+    }
+
+    void dec_impl(std::false_type) const { node_t::delete_deep(root); }
+
+    void dec_impl(std::true_type) const
+    {
+        auto& q = reclaim_t::queue();
+        q.push(&node_t::reclaim_deep, root);
+        q.drain(reclaim_t::budget);
+    }
+
+    template <typename U>
+    static auto from_initializer_list(std::initializer_list<U> values)
+    {
+        auto e      = owner_t{};
+        auto result = leftist_heap{};
+        for (auto&& v : values)
+            result.push_mut(e, v);
+        return result;
+    }
+
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<compatible_sentinel_v<Iter, Sent>, bool> = true>
+    static auto from_range(Iter first, Sent last)
+    {
+        auto e      = owner_t{};
+        auto result = leftist_heap{};
+        for (; first != last; ++first)
+            result.push_mut(e, *first);
+        return result;
+    }
+
+    const T& top() const
+    {
+        assert(root);
+        return root->value();
+    }
+
+    // Merges the heaps `a` and `b`.  The references to `a` and `b` are
+    // taken over by the result, unless it throws, in which case they
+    // are left untouched.
+    static node_t* merge_nodes(edit_t e, node_t* a, node_t* b)
+    {
+        if (!a)
+            return b;
+        if (!b)
+            return a;
+        if (Compare{}(a->value(), b->value()))
+            std::swap(a, b);
+        auto m = a->can_mutate(e) ? a : node_t::copy_e(e, a);
+        auto r = static_cast<node_t*>(nullptr);
+        IMMER_TRY {
+            r = merge_nodes(e, m->right(), b);
+        }
+        IMMER_CATCH (...) {
+            if (m != a)
+                node_t::dec_node(m);
+            IMMER_RETHROW;
+        }
+        m->right() = r;
+        if (node_t::rank(m->left()) < node_t::rank(r))
+            std::swap(m->left(), m->right());
+        m->rank() = node_t::rank(m->right()) + 1;
+        if (m != a)
+            node_t::dec_node(a);
+        return m;
+    }
+
+    template <typename U>
+    void push_mut(edit_t e, U&& value)
+    {
+        auto p = node_t::make_e(e, std::forward<U>(value));
+        IMMER_TRY {
+            root = merge_nodes(e, root, p);
+        }
+        IMMER_CATCH (...) {
+            node_t::delete_node(p);
+            IMMER_RETHROW;
+        }
+        ++size;
+        assert(check_tree());
+    }
+
+    void pop_mut(edit_t e)
+    {
+        assert(root);
+        auto p = root;
+        auto l = p->left();
+        auto r = p->right();
+        if (p->can_mutate(e)) {
+            root       = merge_nodes(e, l, r);
+            p->left()  = nullptr;
+            p->right() = nullptr;
+            node_t::delete_node(p);
+        } else {
+            if (l)
+                l->inc();
+            if (r)
+                r->inc();
+            IMMER_TRY {
+                root = merge_nodes(e, l, r);
+            }
+            IMMER_CATCH (...) {
+                node_t::dec_node(l);
+                node_t::dec_node(r);
+                IMMER_RETHROW;
+            }
+            node_t::dec_node(p);
+        }
+        --size;
+        assert(check_tree());
+    }
+
+    void merge_mut(edit_t e, const leftist_heap& other)
+    {
+        other.inc();
+        IMMER_TRY {
+            root = merge_nodes(e, root, other.root);
+        }
+        IMMER_CATCH (...) {
+            node_t::dec_node(other.root);
+            IMMER_RETHROW;
+        }
+        size += other.size;
+        assert(check_tree());
+    }
+
+    template <typename U>
+    leftist_heap push(U&& value) const
+    {
+        auto result = *this;
+        result.push_mut(owner_t{}, std::forward<U>(value));
+        return result;
+    }
+
+    leftist_heap pop() const
+    {
+        auto result = *this;
+        result.pop_mut(owner_t{});
+        return result;
+    }
+
+    leftist_heap merge(const leftist_heap& other) const
+    {
+        auto result = *this;
+        result.merge_mut(owner_t{}, other);
+        return result;
+    }
+
+    bool check_tree() const
+    {
+#if IMMER_DEBUG_DEEP_CHECK
+        assert(check_node(root) == size);
+#endif
+        return true;
+    }
+
+    static size_t check_node(const node_t* p)
+    {
+        if (!p)
+            return 0;
+        assert(node_t::rank(p->left()) >= node_t::rank(p->right()));
+        assert(p->impl.d.rank == node_t::rank(p->right()) + 1);
+        assert(!p->left() || !Compare{}(p->value(), p->left()->value()));
+        assert(!p->right() || !Compare{}(p->value(), p->right()->value()));
+        return 1 + check_node(p->left()) + check_node(p->right());
+    }
+};
+
+} // namespace heaps
+} // namespace detail
+} // namespace immer
@@ -0,0 +1,183 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/combine_standard_layout.hpp>
+#include <immer/detail/util.hpp>
+#include <immer/probe.hpp>
+#include <immer/reclamation/reclamation_queue.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace immer {
+namespace detail {
+namespace heaps {
+
+using count_t = std::uint32_t;
+using size_t  = std::size_t;
+
+// A node of a leftist heap.  The rank of a node is the length of its
+// right spine, which is never longer than the right spine of its left
+// child, such that the right spines have at most `log(size)` nodes.
+// All nodes have the same size, so they come from an optimized heap.
+template <typename T, typename MemoryPolicy>
+struct node
+{
+    using node_t = node;
+
+    using memory      = MemoryPolicy;
+    using heap_policy = typename memory::heap;
+    using transience  = typename memory::transience_t;
+    using refs_t      = typename memory::refcount;
+    using ownee_t     = typename transience::ownee;
+    using edit_t      = typename transience::edit;
+    using value_t     = T;
+
+    struct impl_data_t
+    {
+        count_t rank;
+        node_t* left;
+        node_t* right;
+        aligned_storage_for<T> buffer;
+    };
+
+    using impl_t = combine_standard_layout_t<impl_data_t, refs_t, ownee_t>;
+
+    using heap =
+        typename heap_policy::template optimized<sizeof(impl_t)>::type;
+
+    impl_t impl;
+
+    T& value() { return *reinterpret_cast<T*>(&impl.d.buffer); }
+    const T& value() const
+    {
+        return *reinterpret_cast<const T*>(&impl.d.buffer);
+    }
+
+    node_t*& left() { return impl.d.left; }
+    node_t*& right() { return impl.d.right; }
+    const node_t* left() const { return impl.d.left; }
+    const node_t* right() const { return impl.d.right; }
+    count_t& rank() { return impl.d.rank; }
+
+    static count_t rank(const node_t* p) { return p ? p->impl.d.rank : 0; }
+
+    static refs_t& refs(const node_t* x)
+    {
+        return auto_const_cast(get<refs_t>(x->impl));
+    }
+    static const ownee_t& ownee(const node_t* x)
+    {
+        return get<ownee_t>(x->impl);
+    }
+    static ownee_t& ownee(node_t* x) { return get<ownee_t>(x->impl); }
+
+    bool can_mutate(edit_t e) const
+    {
+        return IMMER_PROBE_MUTATE(refs(this).unique() ||
+                                  ownee(this).can_mutate(e));
+    }
+
+    node_t* inc()
+    {
+        refs(this).inc();
+        return this;
+    }
+
+    bool dec() const { return refs(this).dec(); }
+
+    template <typename U>
+    static node_t* make_e(edit_t e, U&& value)
+    {
+        IMMER_PROBE(leaf_alloc);
+        auto p = new (heap::allocate(sizeof(node_t))) node_t;
+        IMMER_TRY {
+            new (&p->impl.d.buffer) T{std::forward<U>(value)};
+        }
+        IMMER_CATCH (...) {
+            heap::deallocate(sizeof(node_t), p);
+            IMMER_RETHROW;
+        }
+        p->impl.d.rank  = 1;
+        p->impl.d.left  = nullptr;
+        p->impl.d.right = nullptr;
+        ownee(p)        = e;
+        return p;
+    }
+
+    static node_t* copy_e(edit_t e, const node_t* src)
+    {
+        IMMER_PROBE(node_copy);
+        auto p          = make_e(e, src->value());
+        p->impl.d.rank  = src->impl.d.rank;
+        p->impl.d.left  = src->impl.d.left;
+        p->impl.d.right = src->impl.d.right;
+        if (p->left())
+            p->left()->inc();
+        if (p->right())
+            p->right()->inc();
+        return p;
+    }
+
+    // Frees the node, but not its children.
+    static void delete_node(node_t* p)
+    {
+        detail::destroy_at(&p->value());
+        heap::deallocate(sizeof(node_t), p);
+    }
+
+    static void dec_node(node_t* p)
+    {
+        if (p && p->dec())
+            delete_deep(p);
+    }
+
+    // Frees `p` and the nodes below it that are not referenced anymore.
+    // The left spine may be as long as the heap, so instead of
+    // recursing, a left child that has to be freed is rotated above its
+    // parent, which is kept alive by giving it back one reference.
+    static void delete_deep(node_t* p)
+    {
+        while (p) {
+            auto l = p->left();
+            if (l && l->dec()) {
+                p->left()  = l->right();
+                l->right() = p->inc();
+                p          = l;
+            } else {
+                auto r = p->right();
+                delete_node(p);
+                p = r && r->dec() ? r : nullptr;
+            }
+        }
+    }
+
+    // Frees a node that is no longer referenced, enqueueing its
+    // children if they are not referenced anymore either.
+    static void reclaim_deep(reclamation_queue& q,
+                             void* node,
+                             std::size_t,
+                             std::size_t)
+    {
+        auto p = static_cast<node_t*>(node);
+        auto l = p->left();
+        auto r = p->right();
+        delete_node(p);
+        if (l && l->dec())
+            q.push(&reclaim_deep, l);
+        if (r && r->dec())
+            q.push(&reclaim_deep, r);
+    }
+};
+
+} // namespace heaps
+} // namespace detail
+} // namespace immer
@@ -0,0 +1,112 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace immer {
+namespace detail {
+
+/*!
+ * Global table of the interned nodes described by `Traits`, which
+ * provides the `node_t`, `count_t` and `lock_t` types and the static
+ * functions `hash`, `equals`, `inc`, `unique` and `release`.
+ *
+ * The table holds a reference to every node in it.  Thus, interned
+ * nodes never look unique and containers never update them in place.
+ * The nodes that are only referenced by the table are released once
+ * it has doubled its size since the last time it was purged.
+ */
+template <typename Traits>
+class intern_table
+{
+    using node_t        = typename Traits::node_t;
+    using count_t       = typename Traits::count_t;
+    using lock_t        = typename Traits::lock_t;
+    using scoped_lock_t = typename lock_t::scoped_lock;
+
+    struct entry
+    {
+        node_t* node;
+        count_t count;
+    };
+
+    static constexpr std::size_t min_purge_size = 256;
+
+    lock_t lock_;
+    std::unordered_multimap<std::size_t, entry> table_;
+    std::size_t purge_size_ = min_purge_size;
+
+    void purge(std::vector<entry>& garbage)
+    {
+        for (auto it = table_.begin(); it != table_.end();) {
+            if (Traits::unique(it->second.node)) {
+                garbage.push_back(it->second);
+                it = table_.erase(it);
+            } else
+                ++it;
+        }
+        purge_size_ = std::max(min_purge_size, 2 * table_.size());
+    }
+
+public:
+    // The table is intentionally leaked, such that containers with
+    // static storage duration can be safely destroyed at exit.
+    static intern_table& instance()
+    {
+        static auto t = new intern_table{};
+        return *t;
+    }
+
+    /*!
+     * Returns a new reference to a node with the same `n` values as
+     * `p`, that is either an equal node that was interned before, or
+     * `p` itself, which is interned then.  When hashing, comparing or
+     * allocating throws, `p` is returned without interning it.
+     */
+    node_t* intern(node_t* p, count_t n)
+    {
+        auto garbage = std::vector<entry>{};
+        IMMER_TRY {
+            auto hash = Traits::hash(p, n);
+            scoped_lock_t lock{lock_};
+            auto r = table_.equal_range(hash);
+            for (auto it = r.first; it != r.second; ++it) {
+                auto x = it->second;
+                if (x.count == n &&
+                    (x.node == p || Traits::equals(x.node, p, n))) {
+                    Traits::inc(x.node);
+                    return x.node;
+                }
+            }
+            if (table_.size() >= purge_size_)
+                purge(garbage);
+            table_.emplace(hash, entry{p, n});
+            Traits::inc(p);
+        }
+        IMMER_CATCH (...) {}
+        // Releasing the nodes destroys their values, which may in turn
+        // intern or release other nodes, so it is done without the lock.
+        for (auto x : garbage)
+            Traits::release(x.node, x.count);
+        Traits::inc(p);
+        return p;
+    }
+};
+
+template <typename Traits>
+constexpr std::size_t intern_table<Traits>::min_purge_size;
+
+} // namespace detail
+} // namespace immer
@@ -13,9 +13,13 @@
 #include <immer/detail/rbts/bits.hpp>
 #include <immer/detail/util.hpp>
 #include <immer/heap/tags.hpp>
+#include <immer/interning/no_interning_policy.hpp>
+#include <immer/probe.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <type_traits>
 
@@ -201,6 +205,7 @@ struct node
 
     static node_t* make_inner_n(count_t n)
     {
+        IMMER_PROBE(inner_alloc);
         assert(n <= branches<B>);
         auto m                       = heap::allocate(sizeof_inner_n(n));
         auto p                       = new (m) node_t;
@@ -213,6 +218,7 @@ struct node
 
     static node_t* make_inner_e(edit_t e)
     {
+        IMMER_PROBE(inner_alloc);
         auto m                       = heap::allocate(max_sizeof_inner);
         auto p                       = new (m) node_t;
         ownee(p)                     = e;
@@ -225,6 +231,7 @@ struct node
 
     static node_t* make_inner_r_n(count_t n)
     {
+        IMMER_PROBE(relaxed_alloc);
         assert(n <= branches<B>);
         auto mp = heap::allocate(sizeof_inner_r_n(n));
         auto mr = static_cast<void*>(nullptr);
@@ -254,6 +261,7 @@ struct node
         return static_if<embed_relaxed, node_t*>(
             [&](auto) { return node_t::make_inner_r_n(n); },
             [&](auto) {
+                IMMER_PROBE(inner_alloc);
                 auto p =
                     new (heap::allocate(node_t::sizeof_inner_r_n(n))) node_t;
                 assert(r->d.count >= n);
@@ -268,6 +276,7 @@ struct node
 
     static node_t* make_inner_r_e(edit_t e)
     {
+        IMMER_PROBE(relaxed_alloc);
         auto mp = heap::allocate(max_sizeof_inner_r);
         auto mr = static_cast<void*>(nullptr);
         if (embed_relaxed) {
@@ -298,6 +307,7 @@ struct node
         return static_if<embed_relaxed, node_t*>(
             [&](auto) { return node_t::make_inner_r_e(e); },
             [&](auto) {
+                IMMER_PROBE(inner_alloc);
                 auto p =
                     new (heap::allocate(node_t::max_sizeof_inner_r)) node_t;
                 node_t::refs(r).inc();
@@ -312,6 +322,7 @@ struct node
 
     static node_t* make_leaf_n(count_t n)
     {
+        IMMER_PROBE(leaf_alloc);
         assert(n <= branches<BL>);
         auto p = new (heap::allocate(sizeof_leaf_n(n))) node_t;
 #if IMMER_TAGGED_NODE
@@ -322,6 +333,7 @@ struct node
 
     static node_t* make_leaf_e(edit_t e)
     {
+        IMMER_PROBE(leaf_alloc);
         auto p   = new (heap::allocate(max_sizeof_leaf)) node_t;
         ownee(p) = e;
 #if IMMER_TAGGED_NODE
@@ -508,6 +520,7 @@ struct node
 
     static node_t* copy_inner(node_t* src, count_t n)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto dst = make_inner_n(n);
         inc_nodes(src->inner(), n);
@@ -532,6 +545,7 @@ struct node
 
     static node_t* do_copy_inner(node_t* dst, node_t* src, count_t n)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(dst->kind() == kind_t::inner);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto p = src->inner();
@@ -543,6 +557,7 @@ struct node
     static node_t* do_copy_inner_replace(
         node_t* dst, node_t* src, count_t n, count_t offset, node_t* child)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(dst->kind() == kind_t::inner);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto p = src->inner();
@@ -584,6 +599,7 @@ struct node
 
     static node_t* do_copy_inner_r(node_t* dst, node_t* src, count_t n)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(dst->kind() == kind_t::inner);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto src_r = src->relaxed();
@@ -598,6 +614,7 @@ struct node
     static node_t* do_copy_inner_replace_r(
         node_t* dst, node_t* src, count_t n, count_t offset, node_t* child)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(dst->kind() == kind_t::inner);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::inner);
         auto src_r = src->relaxed();
@@ -617,6 +634,7 @@ struct node
         if (embed_relaxed)
             return do_copy_inner_r(dst, src, n);
         else {
+            IMMER_PROBE(node_copy);
             inc_nodes(src->inner(), n);
             std::copy(src->inner(), src->inner() + n, dst->inner());
             return dst;
@@ -629,6 +647,7 @@ struct node
         if (embed_relaxed)
             return do_copy_inner_replace_r(dst, src, n, offset, child);
         else {
+            IMMER_PROBE(node_copy);
             auto p = src->inner();
             inc_nodes(p, offset);
             inc_nodes(p + offset + 1, n - offset - 1);
@@ -640,6 +659,7 @@ struct node
 
     static node_t* copy_leaf(node_t* src, count_t n)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::leaf);
         auto dst = make_leaf_n(n);
         IMMER_TRY {
@@ -655,6 +675,7 @@ struct node
 
     static node_t* copy_leaf_e(edit_t e, node_t* src, count_t n)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::leaf);
         auto dst = make_leaf_e(e);
         IMMER_TRY {
@@ -670,6 +691,7 @@ struct node
 
     static node_t* copy_leaf_n(count_t allocn, node_t* src, count_t n)
     {
+        IMMER_PROBE(node_copy);
         assert(allocn >= n);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::leaf);
         auto dst = make_leaf_n(allocn);
@@ -686,6 +708,7 @@ struct node
 
     static node_t* copy_leaf(node_t* src1, count_t n1, node_t* src2, count_t n2)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src1->kind() == kind_t::leaf);
         IMMER_ASSERT_TAGGED(src2->kind() == kind_t::leaf);
         auto dst = make_leaf_n(n1 + n2);
@@ -712,6 +735,7 @@ struct node
     static node_t*
     copy_leaf_e(edit_t e, node_t* src1, count_t n1, node_t* src2, count_t n2)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src1->kind() == kind_t::leaf);
         IMMER_ASSERT_TAGGED(src2->kind() == kind_t::leaf);
         auto dst = make_leaf_e(e);
@@ -737,6 +761,7 @@ struct node
 
     static node_t* copy_leaf_e(edit_t e, node_t* src, count_t idx, count_t last)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::leaf);
         auto dst = make_leaf_e(e);
         IMMER_TRY {
@@ -752,6 +777,7 @@ struct node
 
     static node_t* copy_leaf(node_t* src, count_t idx, count_t last)
     {
+        IMMER_PROBE(node_copy);
         IMMER_ASSERT_TAGGED(src->kind() == kind_t::leaf);
         auto dst = make_leaf_n(last - idx);
         IMMER_TRY {
@@ -844,7 +870,8 @@ struct node
 
     bool can_mutate(edit_t e) const
     {
-        return refs(this).unique() || ownee(this).can_mutate(e);
+        return IMMER_PROBE_MUTATE(refs(this).unique() ||
+                                  ownee(this).can_mutate(e));
     }
 
     bool can_relax() const { return !embed_relaxed || relaxed(); }
@@ -948,6 +975,75 @@ struct node
             refs(*i).inc();
     }
 
+    struct leaf_interning_traits
+    {
+        using node_t  = node;
+        using count_t = rbts::count_t;
+        using lock_t  = typename memory::lock;
+
+        static std::size_t hash(node_t* p, count_t n)
+        {
+            auto h = std::size_t{};
+            for (auto i = p->leaf(), e = i + n; i != e; ++i)
+                h = hash_combine(h, std::hash<T>{}(*i));
+            return h;
+        }
+
+        static bool equals(node_t* a, node_t* b, count_t n)
+        {
+            return std::equal(a->leaf(), a->leaf() + n, b->leaf());
+        }
+
+        static void inc(node_t* p) { p->inc(); }
+        static bool unique(node_t* p) { return refs(p).unique(); }
+        static void release(node_t* p, count_t n)
+        {
+            if (p->dec())
+                delete_leaf(p, n);
+        }
+    };
+
+    // Returns a new reference to a leaf with the same `n` elements as
+    // `p`, which is an equal interned leaf when the memory policy
+    // interns nodes.
+    static node_t* share_leaf(node_t* p, count_t n)
+    {
+        return share_leaf(p, n, interning_enabled_t<memory>{});
+    }
+
+    static node_t* share_leaf(node_t* p, count_t, std::false_type)
+    {
+        return p->inc();
+    }
+
+    static node_t* share_leaf(node_t* p, count_t n, std::true_type)
+    {
+        static_assert(!std::is_empty<refs_t>::value,
+                      "interning requires a reference counting policy");
+        using table_t = typename get_interning_policy_t<
+            memory>::template table<leaf_interning_traits>;
+        return table_t::instance().intern(p, n);
+    }
+
+    // Like share_leaf(), but it takes over the reference to `p`.
+    static node_t* intern_leaf(node_t* p, count_t n)
+    {
+        return intern_leaf(p, n, interning_enabled_t<memory>{});
+    }
+
+    static node_t* intern_leaf(node_t* p, count_t, std::false_type)
+    {
+        return p;
+    }
+
+    static node_t* intern_leaf(node_t* p, count_t n, std::true_type)
+    {
+        auto r = share_leaf(p, n, std::true_type{});
+        if (p->dec())
+            delete_leaf(p, n);
+        return r;
+    }
+
 #if IMMER_TAGGED_NODE
     shift_t compute_shift()
     {
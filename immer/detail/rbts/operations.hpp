@@ -18,6 +18,7 @@
 #include <immer/detail/rbts/visitor.hpp>
 #include <immer/detail/util.hpp>
 #include <immer/heap/tags.hpp>
+#include <immer/reclamation/reclamation_queue.hpp>
 
 namespace immer {
 namespace detail {
@@ -96,6 +97,39 @@ struct for_each_chunk_visitor : visitor_base<for_each_chunk_visitor>
     }
 };
 
+struct for_each_node_visitor : visitor_base<for_each_node_visitor>
+{
+    using this_t = for_each_node_visitor;
+
+    template <typename Pos, typename Fn>
+    static void visit_relaxed(Pos&& pos, Fn&& fn)
+    {
+        using node_t = node_type<Pos>;
+        auto count   = pos.count();
+        fn(static_cast<const void*>(pos.node()),
+           node_t::sizeof_inner_r_n(count) +
+               (node_t::embed_relaxed ? 0 : node_t::sizeof_relaxed_n(count)));
+        pos.each(this_t{}, fn);
+    }
+
+    template <typename Pos, typename Fn>
+    static void visit_regular(Pos&& pos, Fn&& fn)
+    {
+        using node_t = node_type<Pos>;
+        fn(static_cast<const void*>(pos.node()),
+           node_t::sizeof_inner_n(pos.count()));
+        pos.each(this_t{}, fn);
+    }
+
+    template <typename Pos, typename Fn>
+    static void visit_leaf(Pos&& pos, Fn&& fn)
+    {
+        using node_t = node_type<Pos>;
+        fn(static_cast<const void*>(pos.node()),
+           node_t::sizeof_leaf_n(pos.count()));
+    }
+};
+
 struct for_each_chunk_p_visitor : visitor_base<for_each_chunk_p_visitor>
 {
     using this_t = for_each_chunk_p_visitor;
@@ -504,7 +538,7 @@ struct update_visitor : visitor_base<update_visitor<NodeT>>
         IMMER_TRY {
             node->leaf()[offset] =
                 std::forward<Fn>(fn)(std::move(node->leaf()[offset]));
-            return node;
+            return node_t::intern_leaf(node, pos.count());
         }
         IMMER_CATCH (...) {
             node_t::delete_leaf(node, pos.count());
@@ -580,6 +614,228 @@ void dec_empty_regular(NodeT* node)
     make_empty_regular_pos(node).visit(dec_visitor());
 }
 
+template <typename NodeT>
+void reclaim_inner(reclamation_queue& q,
+                   void* node,
+                   std::size_t shift,
+                   std::size_t size);
+
+// Like `dec_visitor`, but instead of recursing into an inner node that
+// is no longer referenced it enqueues it in the reclamation queue.
+struct deferred_dec_visitor : visitor_base<deferred_dec_visitor>
+{
+    template <typename Pos>
+    static void visit_relaxed(Pos&& p, reclamation_queue& q)
+    {
+        using node_t = node_type<Pos>;
+        auto node    = p.node();
+        if (node->dec()) {
+            if (p.count())
+                q.push(&reclaim_inner<node_t>, node, p.shift(), p.size());
+            else
+                node_t::delete_inner_r(node, 0);
+        }
+    }
+
+    template <typename Pos>
+    static void visit_regular(Pos&& p, reclamation_queue& q)
+    {
+        using node_t = node_type<Pos>;
+        auto node    = p.node();
+        if (node->dec()) {
+            if (p.count())
+                q.push(
+                    &reclaim_inner<node_t>, node, p.shift(), p.this_size());
+            else
+                node_t::delete_inner(node, 0);
+        }
+    }
+
+    template <typename Pos>
+    static void visit_leaf(Pos&& p, reclamation_queue& q)
+    {
+        using node_t = node_type<Pos>;
+        auto node    = p.node();
+        if (node->dec()) {
+            node_t::delete_leaf(node, p.count());
+        }
+    }
+};
+
+// Frees an inner node that is no longer referenced, releasing its
+// children with a `deferred_dec_visitor`.
+struct reclaim_visitor : visitor_base<reclaim_visitor>
+{
+    template <typename Pos>
+    static void visit_relaxed(Pos&& p, reclamation_queue& q)
+    {
+        using node_t = node_type<Pos>;
+        p.each(deferred_dec_visitor{}, q);
+        node_t::delete_inner_r(p.node(), p.count());
+    }
+
+    template <typename Pos>
+    static void visit_regular(Pos&& p, reclamation_queue& q)
+    {
+        using node_t = node_type<Pos>;
+        p.each(deferred_dec_visitor{}, q);
+        node_t::delete_inner(p.node(), p.count());
+    }
+};
+
+template <typename NodeT>
+void reclaim_inner(reclamation_queue& q,
+                   void* node,
+                   std::size_t shift,
+                   std::size_t size)
+{
+    visit_maybe_relaxed_sub(static_cast<NodeT*>(node),
+                            static_cast<shift_t>(shift),
+                            size,
+                            reclaim_visitor{},
+                            q);
+}
+
+// Maximum number of levels of inner nodes in a tree, which bounds the
+// size of the explicit stacks used by the iterative traversals.
+template <bits_t B, bits_t BL>
+constexpr std::size_t max_inner_depth = (sizeof(size_t) * 8 - BL) / B + 1;
+
+// Shift of the root from which the iterative traversals are used,
+// according to `IMMER_ITERATIVE_MIN_DEPTH`.
+template <bits_t B, bits_t BL>
+constexpr shift_t iterative_min_shift =
+    IMMER_ITERATIVE_MIN_DEPTH > 1 ? BL + B * (IMMER_ITERATIVE_MIN_DEPTH - 1)
+                                  : 0;
+
+// Position in an inner node of the iterative traversals, which decides
+// whether the node is relaxed by looking at the node itself.
+template <typename NodeT>
+struct inner_cursor
+{
+    using node_t    = NodeT;
+    using relaxed_t = typename NodeT::relaxed_t;
+
+    node_t* node;
+    relaxed_t* relaxed;
+    size_t size;
+    shift_t shift;
+    count_t count;
+    count_t i;
+
+    size_t child_size(count_t idx) const
+    {
+        return relaxed ? relaxed->d.sizes[idx] -
+                             (idx ? relaxed->d.sizes[idx - 1] : 0)
+               : idx + 1 < count ? size_t{1} << shift
+                                 : size - (size_t{idx} << shift);
+    }
+};
+
+template <typename NodeT>
+inner_cursor<NodeT> make_inner_cursor(NodeT* node, shift_t shift, size_t size)
+{
+    auto r     = node->relaxed();
+    auto count = r      ? r->d.count
+                 : size ? static_cast<count_t>((size - 1) >> shift) + 1
+                        : count_t{};
+    return {node, r, size, shift, count, 0};
+}
+
+// Frees the inner `node`, which is no longer referenced, and every node
+// below it that is not referenced anymore, without recursion.
+template <typename NodeT>
+void release_inner_iter(NodeT* node, shift_t shift, size_t size)
+{
+    constexpr auto B     = NodeT::bits;
+    constexpr auto BL    = NodeT::bits_leaf;
+    constexpr auto depth = max_inner_depth<B, BL>;
+    inner_cursor<NodeT> stack[depth];
+    auto top = stack;
+    *top++   = make_inner_cursor(node, shift, size);
+    while (top != stack) {
+        auto& c = top[-1];
+        if (c.i == c.count) {
+            if (c.relaxed)
+                NodeT::delete_inner_r(c.node, c.count);
+            else
+                NodeT::delete_inner(c.node, c.count);
+            --top;
+        } else {
+            auto idx   = c.i++;
+            auto child = c.node->inner()[idx];
+            if (child->dec()) {
+                if (c.shift == BL)
+                    NodeT::delete_leaf(child, c.child_size(idx));
+                else {
+                    assert(top != stack + depth);
+                    *top++ = make_inner_cursor(
+                        child, c.shift - B, c.child_size(idx));
+                }
+            }
+        }
+    }
+}
+
+// Calls `fn(first, last)` on the elements of every leaf below the
+// inner `node`, in order and without recursion, until it returns
+// `false`.
+template <typename NodeT, typename Fn>
+bool for_each_chunk_p_iter(NodeT* node, shift_t shift, size_t size, Fn&& fn)
+{
+    constexpr auto B     = NodeT::bits;
+    constexpr auto BL    = NodeT::bits_leaf;
+    constexpr auto depth = max_inner_depth<B, BL>;
+    inner_cursor<NodeT> stack[depth];
+    auto top = stack;
+    *top++   = make_inner_cursor(node, shift, size);
+    while (top != stack) {
+        auto& c = top[-1];
+        if (c.i == c.count)
+            --top;
+        else if (c.shift == BL) {
+            for (; c.i < c.count; ++c.i) {
+                auto data = as_const(c.node->inner()[c.i]->leaf());
+                if (!fn(data, data + c.child_size(c.i)))
+                    return false;
+            }
+        } else {
+            auto idx = c.i++;
+            assert(top != stack + depth);
+            *top++ = make_inner_cursor(
+                c.node->inner()[idx], c.shift - B, c.child_size(idx));
+        }
+    }
+    return true;
+}
+
+// Like `dec_visitor`, but releasing the inner nodes with
+// `release_inner_iter`.
+struct dec_iter_visitor : visitor_base<dec_iter_visitor>
+{
+    template <typename Pos>
+    static void visit_relaxed(Pos&& p)
+    {
+        auto node = p.node();
+        if (node->dec())
+            release_inner_iter(node, p.shift(), p.size());
+    }
+
+    template <typename Pos>
+    static void visit_regular(Pos&& p)
+    {
+        auto node = p.node();
+        if (node->dec())
+            release_inner_iter(node, p.shift(), p.this_size());
+    }
+
+    template <typename Pos>
+    static void visit_leaf(Pos&& p)
+    {
+        dec_visitor::visit_leaf(p);
+    }
+};
+
 template <typename NodeT>
 struct get_mut_visitor : visitor_base<get_mut_visitor<NodeT>>
 {
@@ -41,6 +41,7 @@ struct empty_regular_pos
     node_t* node() const { return node_; }
     shift_t shift() const { return 0; }
     size_t size() const { return 0; }
+    size_t this_size() const { return 0; }
 
     template <typename Visitor, typename... Args>
     void each(Visitor, Args&&...)
@@ -1150,6 +1151,7 @@ struct full_pos
     count_t count() const { return branches<B>; }
     node_t* node() const { return node_; }
     size_t size() const { return branches<B, size_t> << shift_; }
+    size_t this_size() const { return size(); }
     shift_t shift() const { return shift_; }
     count_t index(size_t idx) const { return (idx >> shift_) & mask<B>; }
     count_t subindex(size_t idx) const { return idx >> shift_; }
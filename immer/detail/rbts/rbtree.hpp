@@ -13,6 +13,7 @@
 #include <immer/detail/rbts/operations.hpp>
 #include <immer/detail/rbts/position.hpp>
 #include <immer/detail/type_traits.hpp>
+#include <immer/reclamation/immediate_reclamation_policy.hpp>
 
 #include <cassert>
 #include <memory>
@@ -26,9 +27,10 @@ namespace rbts {
 template <typename T, typename MemoryPolicy, bits_t B, bits_t BL>
 struct rbtree
 {
-    using node_t  = node<T, MemoryPolicy, B, BL>;
-    using edit_t  = typename node_t::edit_t;
-    using owner_t = typename MemoryPolicy::transience_t::owner;
+    using node_t    = node<T, MemoryPolicy, B, BL>;
+    using edit_t    = typename node_t::edit_t;
+    using owner_t   = typename MemoryPolicy::transience_t::owner;
+    using reclaim_t = get_reclamation_policy_t<MemoryPolicy>;
 
     size_t size;
     shift_t shift;
@@ -144,7 +146,27 @@ struct rbtree
         tail->inc();
     }
 
-    void dec() const { traverse(dec_visitor()); }
+    void dec() const
+    {
+        dec_impl(std::integral_constant<bool, reclaim_t::deferred>{});
+    }
+
+    void dec_impl(std::false_type) const
+    {
+        if (use_iterative())
+            traverse(dec_iter_visitor());
+        else
+            traverse(dec_visitor());
+    }
+
+    bool use_iterative() const { return shift >= iterative_min_shift<B, BL>; }
+
+    void dec_impl(std::true_type) const
+    {
+        auto& q = reclaim_t::queue();
+        traverse(deferred_dec_visitor{}, q);
+        q.drain(reclaim_t::budget);
+    }
 
     auto tail_size() const { return size ? ((size - 1) & mask<BL>) +1 : 0; }
 
@@ -224,7 +246,13 @@ struct rbtree
     template <typename Fn>
     void for_each_chunk(Fn&& fn) const
     {
-        traverse(for_each_chunk_visitor{}, std::forward<Fn>(fn));
+        if (use_iterative())
+            for_each_chunk_p_iter([&](auto first, auto last) {
+                fn(first, last);
+                return true;
+            });
+        else
+            traverse(for_each_chunk_visitor{}, std::forward<Fn>(fn));
     }
 
     template <typename Fn>
@@ -233,10 +261,33 @@ struct rbtree
         traverse(for_each_chunk_i_visitor{}, first, last, std::forward<Fn>(fn));
     }
 
+    // Calls `fn(node, bytes)` for every node in the tree, passing the
+    // approximate number of bytes allocated for it.
+    template <typename Fn>
+    void for_each_node(Fn&& fn) const
+    {
+        traverse(for_each_node_visitor{}, fn);
+    }
+
     template <typename Fn>
     bool for_each_chunk_p(Fn&& fn) const
     {
-        return traverse_p(for_each_chunk_p_visitor{}, std::forward<Fn>(fn));
+        if (use_iterative())
+            return for_each_chunk_p_iter(fn);
+        else
+            return traverse_p(for_each_chunk_p_visitor{},
+                              std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    bool for_each_chunk_p_iter(Fn&& fn) const
+    {
+        auto tail_off  = tail_offset();
+        auto tail_size = size - tail_off;
+        auto data      = as_const(tail->leaf());
+        return (!tail_off ||
+                rbts::for_each_chunk_p_iter(root, shift, tail_off, fn)) &&
+               fn(data, data + tail_size);
     }
 
     template <typename Fn>
@@ -276,6 +327,7 @@ struct rbtree
             ensure_mutable_tail(e, ts);
             new (&tail->leaf()[ts]) T{std::move(value)};
         } else {
+            tail          = node_t::intern_leaf(tail, branches<BL>);
             auto new_tail = node_t::make_leaf_e(e, std::move(value));
             IMMER_TRY {
                 if (tail_off == size_t{branches<B>} << shift) {
@@ -324,15 +376,15 @@ struct rbtree
             return {size + 1, shift, root->inc(), new_tail};
         } else {
             auto new_tail = node_t::make_leaf_n(1, std::move(value));
+            auto leaf     = node_t::share_leaf(tail, branches<BL>);
             IMMER_TRY {
                 if (tail_off == size_t{branches<B>} << shift) {
                     auto new_root = node_t::make_inner_n(2);
                     IMMER_TRY {
-                        auto path            = node_t::make_path(shift, tail);
+                        auto path            = node_t::make_path(shift, leaf);
                         new_root->inner()[0] = root;
                         new_root->inner()[1] = path;
                         root->inc();
-                        tail->inc();
                         return {size + 1, shift + B, new_root, new_tail};
                     }
                     IMMER_CATCH (...) {
@@ -342,16 +394,15 @@ struct rbtree
                 } else if (tail_off) {
                     auto new_root =
                         make_regular_sub_pos(root, shift, tail_off)
-                            .visit(push_tail_visitor<node_t>{}, tail);
-                    tail->inc();
+                            .visit(push_tail_visitor<node_t>{}, leaf);
                     return {size + 1, shift, new_root, new_tail};
                 } else {
-                    auto new_root = node_t::make_path(shift, tail);
-                    tail->inc();
+                    auto new_root = node_t::make_path(shift, leaf);
                     return {size + 1, shift, new_root, new_tail};
                 }
             }
             IMMER_CATCH (...) {
+                dec_leaf(leaf, branches<BL>);
                 node_t::delete_leaf(new_tail, 1);
                 IMMER_RETHROW;
             }
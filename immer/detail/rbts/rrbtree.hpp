@@ -14,6 +14,7 @@
 #include <immer/detail/rbts/position.hpp>
 
 #include <immer/detail/type_traits.hpp>
+#include <immer/reclamation/immediate_reclamation_policy.hpp>
 
 #include <cassert>
 #include <limits>
@@ -31,9 +32,10 @@ struct rrbtree_iterator;
 template <typename T, typename MemoryPolicy, bits_t B, bits_t BL>
 struct rrbtree
 {
-    using node_t  = node<T, MemoryPolicy, B, BL>;
-    using edit_t  = typename node_t::edit_t;
-    using owner_t = typename MemoryPolicy::transience_t::owner;
+    using node_t    = node<T, MemoryPolicy, B, BL>;
+    using edit_t    = typename node_t::edit_t;
+    using owner_t   = typename MemoryPolicy::transience_t::owner;
+    using reclaim_t = get_reclamation_policy_t<MemoryPolicy>;
 
     size_t size;
     shift_t shift;
@@ -150,7 +152,27 @@ struct rrbtree
         tail->inc();
     }
 
-    void dec() const { traverse(dec_visitor()); }
+    void dec() const
+    {
+        dec_impl(std::integral_constant<bool, reclaim_t::deferred>{});
+    }
+
+    void dec_impl(std::false_type) const
+    {
+        if (use_iterative())
+            traverse(dec_iter_visitor());
+        else
+            traverse(dec_visitor());
+    }
+
+    bool use_iterative() const { return shift >= iterative_min_shift<B, BL>; }
+
+    void dec_impl(std::true_type) const
+    {
+        auto& q = reclaim_t::queue();
+        traverse(deferred_dec_visitor{}, q);
+        q.drain(reclaim_t::budget);
+    }
 
     auto tail_size() const { return size - tail_offset(); }
 
@@ -250,7 +272,13 @@ struct rrbtree
     template <typename Fn>
     void for_each_chunk(Fn&& fn) const
     {
-        traverse(for_each_chunk_visitor{}, std::forward<Fn>(fn));
+        if (use_iterative())
+            for_each_chunk_p_iter([&](auto first, auto last) {
+                fn(first, last);
+                return true;
+            });
+        else
+            traverse(for_each_chunk_visitor{}, std::forward<Fn>(fn));
     }
 
     template <typename Fn>
@@ -259,10 +287,33 @@ struct rrbtree
         traverse(for_each_chunk_i_visitor{}, first, last, std::forward<Fn>(fn));
     }
 
+    // Calls `fn(node, bytes)` for every node in the tree, passing the
+    // approximate number of bytes allocated for it.
+    template <typename Fn>
+    void for_each_node(Fn&& fn) const
+    {
+        traverse(for_each_node_visitor{}, fn);
+    }
+
     template <typename Fn>
     bool for_each_chunk_p(Fn&& fn) const
     {
-        return traverse_p(for_each_chunk_p_visitor{}, std::forward<Fn>(fn));
+        if (use_iterative())
+            return for_each_chunk_p_iter(fn);
+        else
+            return traverse_p(for_each_chunk_p_visitor{},
+                              std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    bool for_each_chunk_p_iter(Fn&& fn) const
+    {
+        auto tail_off  = tail_offset();
+        auto tail_size = size - tail_off;
+        auto data      = as_const(tail->leaf());
+        return (!tail_off ||
+                rbts::for_each_chunk_p_iter(root, shift, tail_off, fn)) &&
+               fn(data, data + tail_size);
     }
 
     template <typename Fn>
@@ -443,6 +494,7 @@ struct rrbtree
             new (&tail->leaf()[ts]) T{std::move(value)};
         } else {
             using std::get;
+            tail          = node_t::intern_leaf(tail, branches<BL>);
             auto new_tail = node_t::make_leaf_e(e, std::move(value));
             auto tail_off = tail_offset();
             IMMER_TRY {
@@ -468,13 +520,14 @@ struct rrbtree
             using std::get;
             auto new_tail = node_t::make_leaf_n(1u, std::move(value));
             auto tail_off = tail_offset();
+            auto leaf     = node_t::share_leaf(tail, branches<BL>);
             IMMER_TRY {
                 auto new_root =
-                    push_tail(root, shift, tail_off, tail, size - tail_off);
-                tail->inc();
+                    push_tail(root, shift, tail_off, leaf, size - tail_off);
                 return {size + 1, get<0>(new_root), get<1>(new_root), new_tail};
             }
             IMMER_CATCH (...) {
+                dec_leaf(leaf, branches<BL>);
                 node_t::delete_leaf(new_tail, 1u);
                 IMMER_RETHROW;
             }
@@ -770,8 +823,12 @@ struct rrbtree
         }
     }
 
+    // The in place concatenation relies on the ownership alone and
+    // does not keep the reference counts, so it is only used when
+    // there are none.
     constexpr static bool supports_transient_concat =
-        !std::is_empty<edit_t>::value;
+        !std::is_empty<edit_t>::value &&
+        std::is_empty<typename node_t::refs_t>::value;
 
     friend void concat_mut_l(rrbtree& l, edit_t el, const rrbtree& r)
     {
@@ -170,6 +170,11 @@ T* make(Args&&... args)
     }
 }
 
+inline std::size_t hash_combine(std::size_t seed, std::size_t h)
+{
+    return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
 struct not_supported_t
 {};
 struct empty_t
@@ -0,0 +1,45 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace immer {
+
+/*!
+ * Growth policy that multiplies the capacity by `Num / Den` every
+ * time that a container that keeps spare capacity, like an @ref
+ * array, runs out of it.  Use `factor_growth_policy<1>` to never
+ * allocate more than what is needed.
+ *
+ * @tparam Num Numerator of the growth factor.
+ * @tparam Den Denominator of the growth factor.
+ */
+template <std::size_t Num = 2, std::size_t Den = 1>
+struct factor_growth_policy
+{
+    static_assert(Den > 0 && Num >= Den, "the growth factor must be >= 1");
+
+    /*!
+     * Returns the capacity to allocate in order to hold `size`
+     * elements, when the current capacity is `cap`.
+     */
+    static std::size_t grow(std::size_t size, std::size_t cap)
+    {
+        constexpr auto max = std::numeric_limits<std::size_t>::max();
+        return size <= cap        ? cap
+               : cap >= max / Num ? max
+                                  /* otherwise */
+                                  : std::max(cap * Num / Den, size);
+    }
+};
+
+} // namespace immer
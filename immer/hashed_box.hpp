@@ -0,0 +1,222 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/box.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+namespace immer {
+
+namespace detail {
+
+struct hashed_value_tag
+{};
+
+template <typename T, typename Hash>
+struct hashed_value
+{
+    T value;
+    std::size_t hash;
+
+    template <typename... Args>
+    hashed_value(hashed_value_tag, Args&&... args)
+        : value{std::forward<Args>(args)...}
+        , hash{Hash{}(value)}
+    {}
+};
+
+} // namespace detail
+
+/*!
+ * Immutable box for a single value of type `T` that caches its hash.
+ *
+ * It behaves like a @ref box, but the hash of the value is computed
+ * with `Hash` only once, when the value is constructed, and stored
+ * next to it.  This makes it cheap to use as key of a @ref set,
+ * @ref map or @ref table, or any other hash based container, when the
+ * value is expensive to hash, like a long string.  Comparing two
+ * boxes for equality first compares their hashes, such that the
+ * values themselves are only compared when the hashes match.
+ */
+template <typename T,
+          typename Hash         = std::hash<T>,
+          typename MemoryPolicy = default_memory_policy>
+class hashed_box
+{
+    using value_t = detail::hashed_value<T, Hash>;
+    using tag_t   = detail::hashed_value_tag;
+    using impl_t  = box<value_t, MemoryPolicy>;
+
+    impl_t impl_;
+
+public:
+    auto impl() const { return impl_.impl(); }
+
+    using value_type    = T;
+    using hasher        = Hash;
+    using memory_policy = MemoryPolicy;
+
+    /*!
+     * Constructs a box holding `T{}`.
+     */
+    hashed_box()
+        : impl_{tag_t{}}
+    {}
+
+    /*!
+     * Constructs a box holding `T{arg}`
+     */
+    template <typename Arg,
+              typename Enable = std::enable_if_t<
+                  !std::is_same<hashed_box, std::decay_t<Arg>>::value &&
+                  std::is_constructible<T, Arg>::value>>
+    hashed_box(Arg&& arg)
+        : impl_{tag_t{}, std::forward<Arg>(arg)}
+    {}
+
+    /*!
+     * Constructs a box holding `T{arg1, arg2, args...}`
+     */
+    template <typename Arg1, typename Arg2, typename... Args>
+    hashed_box(Arg1&& arg1, Arg2&& arg2, Args&&... args)
+        : impl_{tag_t{},
+                std::forward<Arg1>(arg1),
+                std::forward<Arg2>(arg2),
+                std::forward<Args>(args)...}
+    {}
+
+    friend void swap(hashed_box& a, hashed_box& b)
+    {
+        using std::swap;
+        swap(a.impl_, b.impl_);
+    }
+
+    /*! Query the current value. */
+    IMMER_NODISCARD const T& get() const { return impl_->value; }
+
+    /*! Query the hash of the current value, as computed by `Hash`. */
+    IMMER_NODISCARD std::size_t hash() const { return impl_->hash; }
+
+    /*! Conversion to the boxed type. */
+    operator const T&() const { return get(); }
+
+    /*! Access via dereference */
+    const T& operator*() const { return get(); }
+
+    /*! Access via pointer member access */
+    const T* operator->() const { return &get(); }
+
+    /*!
+     * Returns a new box built by applying the `fn` to the underlying
+     * value.  The hash is computed again for the new value.
+     */
+    template <typename Fn>
+    IMMER_NODISCARD hashed_box update(Fn&& fn) const&
+    {
+        return std::forward<Fn>(fn)(get());
+    }
+    template <typename Fn>
+    IMMER_NODISCARD hashed_box&& update(Fn&& fn) &&
+    {
+        impl_ = std::move(impl_).update([&](auto&& x) {
+            return value_t{tag_t{},
+                           std::forward<Fn>(fn)(std::move(x.value))};
+        });
+        return std::move(*this);
+    }
+};
+
+template <typename T, typename H, typename MP>
+IMMER_NODISCARD bool operator==(const hashed_box<T, H, MP>& a,
+                                const hashed_box<T, H, MP>& b)
+{
+    return a.impl() == b.impl() ||
+           (a.hash() == b.hash() && a.get() == b.get());
+}
+template <typename T, typename H, typename MP>
+IMMER_NODISCARD bool operator!=(const hashed_box<T, H, MP>& a,
+                                const hashed_box<T, H, MP>& b)
+{
+    return a.impl() != b.impl() &&
+           (a.hash() != b.hash() || a.get() != b.get());
+}
+template <typename T, typename H, typename MP>
+IMMER_NODISCARD bool operator<(const hashed_box<T, H, MP>& a,
+                               const hashed_box<T, H, MP>& b)
+{
+    return a.impl() != b.impl() && a.get() < b.get();
+}
+
+template <typename T, typename H, typename MP, typename T2>
+IMMER_NODISCARD auto operator==(const hashed_box<T, H, MP>& a, T2&& b)
+    -> std::enable_if_t<
+        !std::is_same<hashed_box<T, H, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() == b)>
+{
+    return a.get() == b;
+}
+template <typename T, typename H, typename MP, typename T2>
+IMMER_NODISCARD auto operator!=(const hashed_box<T, H, MP>& a, T2&& b)
+    -> std::enable_if_t<
+        !std::is_same<hashed_box<T, H, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() != b)>
+{
+    return a.get() != b;
+}
+template <typename T, typename H, typename MP, typename T2>
+IMMER_NODISCARD auto operator<(const hashed_box<T, H, MP>& a, T2&& b)
+    -> std::enable_if_t<
+        !std::is_same<hashed_box<T, H, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() < b)>
+{
+    return a.get() < b;
+}
+
+template <typename T2, typename T, typename H, typename MP>
+IMMER_NODISCARD auto operator==(T2&& b, const hashed_box<T, H, MP>& a)
+    -> std::enable_if_t<
+        !std::is_same<hashed_box<T, H, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() == b)>
+{
+    return a.get() == b;
+}
+template <typename T2, typename T, typename H, typename MP>
+IMMER_NODISCARD auto operator!=(T2&& b, const hashed_box<T, H, MP>& a)
+    -> std::enable_if_t<
+        !std::is_same<hashed_box<T, H, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() != b)>
+{
+    return a.get() != b;
+}
+template <typename T2, typename T, typename H, typename MP>
+IMMER_NODISCARD auto operator<(T2&& b, const hashed_box<T, H, MP>& a)
+    -> std::enable_if_t<
+        !std::is_same<hashed_box<T, H, MP>, std::decay_t<T2>>::value,
+        decltype(b < a.get())>
+{
+    return b < a.get();
+}
+
+} // namespace immer
+
+namespace std {
+
+template <typename T, typename H, typename MP>
+struct hash<immer::hashed_box<T, H, MP>>
+{
+    std::size_t operator()(const immer::hashed_box<T, H, MP>& x) const
+    {
+        return x.hash();
+    }
+};
+
+} // namespace std
@@ -0,0 +1,191 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace immer {
+
+/*!
+ * Number of size classes tracked by @ref heap_counters.  Allocations
+ * of size class `k` are those with a size in the range @f$(2^{k-1},
+ * 2^k]@f$, the last class also takes all bigger allocations.
+ */
+constexpr std::size_t heap_size_classes = 24;
+
+/*!
+ * Snapshot of the statistics collected by a @ref counting_heap.
+ */
+struct heap_counters
+{
+    std::size_t allocations       = 0;
+    std::size_t deallocations     = 0;
+    std::size_t bytes_allocated   = 0;
+    std::size_t bytes_deallocated = 0;
+    std::size_t peak_bytes        = 0;
+    std::array<std::size_t, heap_size_classes> allocations_by_size = {};
+
+    /*!
+     * Number of bytes that are currently allocated.
+     */
+    std::size_t live_bytes() const
+    {
+        return bytes_allocated - bytes_deallocated;
+    }
+
+    /*!
+     * Number of objects that are currently allocated.
+     */
+    std::size_t live_allocations() const
+    {
+        return allocations - deallocations;
+    }
+
+    /*!
+     * Counts the events that happened between `before` and this
+     * snapshot.  The `peak_bytes` are kept as they are.
+     */
+    heap_counters operator-(const heap_counters& before) const
+    {
+        auto r              = *this;
+        r.allocations       = allocations - before.allocations;
+        r.deallocations     = deallocations - before.deallocations;
+        r.bytes_allocated   = bytes_allocated - before.bytes_allocated;
+        r.bytes_deallocated = bytes_deallocated - before.bytes_deallocated;
+        for (auto i = std::size_t{}; i < heap_size_classes; ++i)
+            r.allocations_by_size[i] =
+                allocations_by_size[i] - before.allocations_by_size[i];
+        return r;
+    }
+};
+
+namespace detail {
+
+inline std::size_t heap_size_class(std::size_t size)
+{
+    auto k = std::size_t{};
+    while (k < heap_size_classes - 1 && (std::size_t{1} << k) < size)
+        ++k;
+    return k;
+}
+
+struct heap_counters_storage
+{
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> deallocations{0};
+    std::atomic<std::size_t> bytes_allocated{0};
+    std::atomic<std::size_t> bytes_deallocated{0};
+    std::atomic<std::size_t> peak_bytes{0};
+    std::array<std::atomic<std::size_t>, heap_size_classes>
+        allocations_by_size = {};
+
+    void on_allocate(std::size_t size)
+    {
+        constexpr auto mo = std::memory_order_relaxed;
+        allocations.fetch_add(1, mo);
+        allocations_by_size[heap_size_class(size)].fetch_add(1, mo);
+        auto live = bytes_allocated.fetch_add(size, mo) + size -
+                    bytes_deallocated.load(mo);
+        auto peak = peak_bytes.load(mo);
+        while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, mo))
+            ;
+    }
+
+    void on_deallocate(std::size_t size)
+    {
+        constexpr auto mo = std::memory_order_relaxed;
+        deallocations.fetch_add(1, mo);
+        bytes_deallocated.fetch_add(size, mo);
+    }
+
+    heap_counters load() const
+    {
+        constexpr auto mo = std::memory_order_relaxed;
+        auto r              = heap_counters{};
+        r.allocations       = allocations.load(mo);
+        r.deallocations     = deallocations.load(mo);
+        r.bytes_allocated   = bytes_allocated.load(mo);
+        r.bytes_deallocated = bytes_deallocated.load(mo);
+        r.peak_bytes        = peak_bytes.load(mo);
+        for (auto i = std::size_t{}; i < heap_size_classes; ++i)
+            r.allocations_by_size[i] = allocations_by_size[i].load(mo);
+        return r;
+    }
+};
+
+template <typename Tag>
+heap_counters_storage& counting_heap_storage()
+{
+    static heap_counters_storage s;
+    return s;
+}
+
+} // namespace detail
+
+/*!
+ * Adaptor that counts the allocations and deallocations that go
+ * through it, the bytes requested by size class, and the peak of live
+ * bytes.  The counters are global and shared by all the
+ * `counting_heap` types with the same `Tag`, whatever their `Base`, so
+ * that the heaps for nodes of different sizes add up.  Use a different
+ * `Tag` to get separate counters.
+ *
+ * Where it is placed in the heap stack determines what it measures:
+ * `heap_policy<counting_heap<cpp_heap>>` sees every node, while
+ * `free_list_heap_policy<counting_heap<cpp_heap>>` only sees the
+ * requests that the free lists could not serve.
+ *
+ * The counters are updated with relaxed atomic operations, so it can
+ * be used in multi-threaded programs, but it is meant for profiling
+ * and benchmarks and not for production use.
+ */
+template <typename Base, typename Tag = void>
+struct counting_heap : Base
+{
+    template <typename... Tags>
+    static void* allocate(std::size_t size, Tags... tags)
+    {
+        auto p = Base::allocate(size, tags...);
+        storage().on_allocate(size);
+        return p;
+    }
+
+    template <typename... Tags>
+    static void deallocate(std::size_t size, void* data, Tags... tags)
+    {
+        storage().on_deallocate(size);
+        Base::deallocate(size, data, tags...);
+    }
+
+    /*!
+     * Returns a snapshot of the counters.  Subtract two snapshots to
+     * get the statistics of the operations made in between.
+     */
+    static heap_counters counters() { return storage().load(); }
+
+    /*!
+     * Sets the peak to the currently live bytes, such that it
+     * measures the peak of the operations that come next.
+     */
+    static void reset_peak()
+    {
+        auto c = counters();
+        storage().peak_bytes.store(c.live_bytes(), std::memory_order_relaxed);
+    }
+
+private:
+    static detail::heap_counters_storage& storage()
+    {
+        return detail::counting_heap_storage<Tag>();
+    }
+};
+
+} // namespace immer
@@ -0,0 +1,292 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace immer {
+
+/*!
+ * Memory used by the versions in a @ref history, as returned by
+ * `history::memory()`.  The sizes are approximate, they count the
+ * bytes requested for the nodes of the containers but not the
+ * overhead of the heap.
+ */
+struct history_memory
+{
+    //! Number of distinct nodes in all the versions.
+    std::size_t nodes = 0;
+    //! Bytes used by the distinct nodes in all the versions.
+    std::size_t bytes = 0;
+    //! Bytes used by nodes that are part of more than one version.
+    std::size_t shared_bytes = 0;
+    //! Bytes used by nodes that are part of only one version.
+    std::size_t unique_bytes = 0;
+    //! Bytes that the versions would use if they shared nothing.
+    std::size_t unshared_bytes = 0;
+};
+
+/*!
+ * Keeps the last versions of a container, for example, to implement
+ * undo and redo.
+ *
+ * @tparam Container The type of the versions, like a `vector`,
+ *         `flex_vector`, `map`, `set`, `table` or `array`.
+ *
+ * @rst
+ *
+ * Versions are identified by consecutive numbers, such that accessing
+ * one by its id is :math:`O(1)`.  When there are more than
+ * ``max_versions()`` versions, the oldest ones are forgotten.
+ *
+ * Dropping a version releases the nodes that are only used by that
+ * version, which may take a while when there are many.  To avoid
+ * pauses, forgotten versions are not released immediately.  Instead,
+ * they are queued and every ``push()`` releases at most
+ * ``release_budget()`` of them, spreading the work over the following
+ * operations.  A ``push()`` releases before forgetting, so the version
+ * that it forgets stays queued at least until the next one.  Note that
+ * each version is still released all at once.
+ *
+ * @endrst
+ */
+template <typename Container>
+class history
+{
+public:
+    using container_type = Container;
+    using version_id     = std::size_t;
+    using size_type      = std::size_t;
+
+    /*!
+     * Creates an empty history that keeps up to `max_versions`
+     * versions and that releases at most `release_budget` forgotten
+     * versions on every push.
+     */
+    explicit history(size_type max_versions, size_type release_budget = 1)
+        : max_versions_{max_versions}
+        , release_budget_{release_budget}
+    {
+        if (max_versions_ == 0)
+            IMMER_THROW(std::invalid_argument{"max_versions must be > 0"});
+    }
+
+    /*!
+     * Adds `version` as the newest version and returns its id.  It
+     * first releases up to `release_budget()` forgotten versions and
+     * then forgets the oldest version when there are too many, such
+     * that the cost of releasing it is paid by a later operation.
+     */
+    version_id push(container_type version)
+    {
+        release(release_budget_);
+        versions_.push_back(std::move(version));
+        trim();
+        return newest();
+    }
+
+    /*!
+     * Returns the version with the given id.  It is undefined when
+     * `!contains(id)`.  Its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD const container_type& operator[](version_id id) const
+    {
+        return versions_[id - first_];
+    }
+
+    /*!
+     * Returns the version with the given id.  It throws an
+     * `std::out_of_range` exception when `!contains(id)`.
+     */
+    const container_type& at(version_id id) const
+    {
+        if (!contains(id))
+            IMMER_THROW(std::out_of_range{"version not in history"});
+        return (*this)[id];
+    }
+
+    /*!
+     * Returns whether the version `id` is still in the history.
+     */
+    IMMER_NODISCARD bool contains(version_id id) const
+    {
+        return id >= first_ && id - first_ < versions_.size();
+    }
+
+    /*!
+     * Returns the id of the oldest version.  Undefined when `empty()`.
+     */
+    IMMER_NODISCARD version_id oldest() const { return first_; }
+
+    /*!
+     * Returns the id of the newest version.  Undefined when `empty()`.
+     */
+    IMMER_NODISCARD version_id newest() const
+    {
+        return first_ + versions_.size() - 1;
+    }
+
+    /*!
+     * Returns the newest version.  Undefined when `empty()`.
+     */
+    IMMER_NODISCARD const container_type& latest() const
+    {
+        return versions_.back();
+    }
+
+    IMMER_NODISCARD size_type size() const { return versions_.size(); }
+    IMMER_NODISCARD bool empty() const { return versions_.empty(); }
+
+    IMMER_NODISCARD size_type max_versions() const { return max_versions_; }
+    IMMER_NODISCARD size_type release_budget() const
+    {
+        return release_budget_;
+    }
+
+    /*!
+     * Changes the number of versions to keep.  When it is smaller
+     * than `size()`, the oldest versions are queued for release.
+     */
+    void set_max_versions(size_type n)
+    {
+        if (n == 0)
+            IMMER_THROW(std::invalid_argument{"max_versions must be > 0"});
+        max_versions_ = n;
+        trim();
+    }
+
+    /*!
+     * Changes the number of forgotten versions released per `push()`.
+     */
+    void set_release_budget(size_type n) { release_budget_ = n; }
+
+    /*!
+     * Forgets the versions newer than `id`, as done when making a new
+     * change after undoing some.  Their ids are given to the versions
+     * pushed afterwards.  The forgotten versions are queued for
+     * release.
+     */
+    void drop_newer(version_id id)
+    {
+        while (!versions_.empty() && newest() > id) {
+            pending_.push_back(std::move(versions_.back()));
+            versions_.pop_back();
+        }
+    }
+
+    /*!
+     * Number of forgotten versions that have not been released yet.
+     */
+    IMMER_NODISCARD size_type pending_release() const
+    {
+        return pending_.size();
+    }
+
+    /*!
+     * Releases up to `n` forgotten versions and returns how many were
+     * released.
+     */
+    size_type release(size_type n)
+    {
+        auto count = std::min(n, pending_.size());
+        for (auto i = size_type{}; i < count; ++i)
+            pending_.pop_front();
+        return count;
+    }
+
+    /*!
+     * Releases all the forgotten versions.
+     */
+    void release_all() { release(pending_.size()); }
+
+    /*!
+     * Returns how much memory the versions in the history use and how
+     * much of it is shared among them, by looking at which nodes are
+     * part of each version.  It does not account for versions that
+     * are queued for release.  Its complexity is linear in the total
+     * number of nodes of all the versions, so it is meant for
+     * diagnostics.
+     */
+    IMMER_NODISCARD history_memory memory() const
+    {
+        struct node_info
+        {
+            std::size_t bytes;
+            std::size_t versions;
+            std::size_t last;
+        };
+        auto r     = history_memory{};
+        auto nodes = std::unordered_map<const void*, node_info>{};
+        for (auto i = size_type{}; i < versions_.size(); ++i) {
+            versions_[i].impl().for_each_node(
+                [&](const void* p, std::size_t bytes) {
+                    r.unshared_bytes += bytes;
+                    auto& n = nodes.emplace(p, node_info{bytes, 0, 0})
+                                  .first->second;
+                    if (n.last != i + 1) {
+                        ++n.versions;
+                        n.last = i + 1;
+                    }
+                });
+        }
+        for (auto& kv : nodes) {
+            auto& n = kv.second;
+            ++r.nodes;
+            r.bytes += n.bytes;
+            (n.versions > 1 ? r.shared_bytes : r.unique_bytes) += n.bytes;
+        }
+        return r;
+    }
+
+    /*!
+     * Returns the bytes used by nodes that are part of version `id`
+     * but of no other version in the history, which is roughly what
+     * forgetting it would release.  Its complexity is linear in the
+     * total number of nodes of all the versions.
+     */
+    IMMER_NODISCARD std::size_t unique_bytes(version_id id) const
+    {
+        auto nodes = std::unordered_map<const void*, std::size_t>{};
+        at(id).impl().for_each_node(
+            [&](const void* p, std::size_t bytes) { nodes.emplace(p, bytes); });
+        for (auto i = first_; i <= newest(); ++i)
+            if (i != id)
+                (*this)[i].impl().for_each_node(
+                    [&](const void* p, std::size_t) { nodes.erase(p); });
+        auto r = std::size_t{};
+        for (auto& kv : nodes)
+            r += kv.second;
+        return r;
+    }
+
+private:
+    void trim()
+    {
+        while (versions_.size() > max_versions_) {
+            pending_.push_back(std::move(versions_.front()));
+            versions_.pop_front();
+            ++first_;
+        }
+    }
+
+    std::deque<container_type> versions_;
+    std::deque<container_type> pending_;
+    version_id first_ = 0;
+    size_type max_versions_;
+    size_type release_budget_;
+};
+
+} // namespace immer
@@ -0,0 +1,322 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/util.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+
+namespace immer {
+
+namespace detail {
+
+inline bool try_inc(refcount_policy& r)
+{
+    auto count = r.refcount.load(std::memory_order_relaxed);
+    while (count != 0)
+        if (r.refcount.compare_exchange_weak(
+                count, count + 1, std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+inline bool try_inc(unsafe_refcount_policy& r)
+{
+    if (r.refcount == 0)
+        return false;
+    ++r.refcount;
+    return true;
+}
+
+template <typename Word, unsigned OwnerBits>
+bool try_inc(basic_compact_refcount_policy<Word, OwnerBits>& r)
+{
+    using policy_t = basic_compact_refcount_policy<Word, OwnerBits>;
+    // Like inc(), this clears the owner, since the object is shared
+    // now, and leaves a saturated count as it is
+    auto word = r.word.load(std::memory_order_relaxed);
+    while (word & policy_t::count_mask)
+        if ((word & policy_t::count_mask) == policy_t::count_mask ||
+            r.word.compare_exchange_weak(word,
+                                         (word + 1) & policy_t::count_mask,
+                                         std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+} // namespace detail
+
+/*!
+ * Immutable box for a single value of type `T` that is *interned*.
+ *
+ * Boxes holding equal values, as determined by `Equal`, share the
+ * same underlying object, even when they were built independently.
+ * This is achieved by keeping a global table, indexed by the `Hash`
+ * of the values, that refers weakly to every live boxed object.  When
+ * a new box is constructed, an equal value is looked up in the table
+ * and reused when found.  When the last reference to a value goes
+ * away, it is removed from the table.
+ *
+ * This reduces the memory used when many equal values are produced by
+ * different sources, and makes comparing boxes a @f$ O(1) @f$ pointer
+ * comparison.  In turn, constructing a box is more expensive, as it
+ * requires hashing the value and accessing the global table, which is
+ * protected with the lock of the `MemoryPolicy`.
+ *
+ * @rst
+ *
+ * .. note:: Only memory policies with reference counting are
+ *    supported, since the table needs to know when values are no
+ *    longer referenced.
+ *
+ * @endrst
+ */
+template <typename T,
+          typename Hash         = std::hash<T>,
+          typename Equal        = std::equal_to<T>,
+          typename MemoryPolicy = default_memory_policy>
+class interned_box
+{
+    static_assert(!std::is_empty<typename MemoryPolicy::refcount>::value,
+                  "interned_box requires a reference counting memory policy");
+
+    struct holder : MemoryPolicy::refcount
+    {
+        std::size_t hash;
+        T value;
+
+        holder(std::size_t h, T&& v)
+            : hash{h}
+            , value{std::move(v)}
+        {}
+    };
+
+    using heap          = typename MemoryPolicy::heap::type;
+    using lock_t        = typename MemoryPolicy::lock;
+    using scoped_lock_t = typename lock_t::scoped_lock;
+
+    struct pool_t
+    {
+        lock_t lock;
+        std::unordered_multimap<std::size_t, holder*> table;
+    };
+
+    // The pool is intentionally leaked, such that boxes with static
+    // storage duration can be safely destroyed at exit.
+    static pool_t& pool()
+    {
+        static auto p = new pool_t{};
+        return *p;
+    }
+
+    static holder* intern(T value)
+    {
+        auto hash = Hash{}(value);
+        auto& p   = pool();
+        scoped_lock_t lock{p.lock};
+        auto r = p.table.equal_range(hash);
+        for (auto it = r.first; it != r.second; ++it) {
+            // A count of zero means that the value is being released
+            // by another thread that is waiting to remove it.
+            if (Equal{}(it->second->value, value) &&
+                detail::try_inc(*it->second))
+                return it->second;
+        }
+        auto h = detail::make<heap, holder>(hash, std::move(value));
+        IMMER_TRY {
+            p.table.emplace(hash, h);
+        }
+        IMMER_CATCH (...) {
+            h->~holder();
+            heap::deallocate(sizeof(holder), h);
+            IMMER_RETHROW;
+        }
+        return h;
+    }
+
+    static void release(holder* h)
+    {
+        if (h && h->dec()) {
+            {
+                auto& p = pool();
+                scoped_lock_t lock{p.lock};
+                auto r = p.table.equal_range(h->hash);
+                for (auto it = r.first; it != r.second; ++it) {
+                    if (it->second == h) {
+                        p.table.erase(it);
+                        break;
+                    }
+                }
+            }
+            h->~holder();
+            heap::deallocate(sizeof(holder), h);
+        }
+    }
+
+    holder* impl_ = nullptr;
+
+public:
+    const holder* impl() const { return impl_; };
+
+    using value_type    = T;
+    using hasher        = Hash;
+    using key_equal     = Equal;
+    using memory_policy = MemoryPolicy;
+
+    /*!
+     * Constructs a box holding `T{}`.
+     */
+    interned_box()
+        : impl_{intern(T{})}
+    {}
+
+    /*!
+     * Constructs a box holding `T{arg}`
+     */
+    template <typename Arg,
+              typename Enable = std::enable_if_t<
+                  !std::is_same<interned_box, std::decay_t<Arg>>::value &&
+                  std::is_constructible<T, Arg>::value>>
+    interned_box(Arg&& arg)
+        : impl_{intern(T{std::forward<Arg>(arg)})}
+    {}
+
+    /*!
+     * Constructs a box holding `T{arg1, arg2, args...}`
+     */
+    template <typename Arg1, typename Arg2, typename... Args>
+    interned_box(Arg1&& arg1, Arg2&& arg2, Args&&... args)
+        : impl_{intern(T{std::forward<Arg1>(arg1),
+                         std::forward<Arg2>(arg2),
+                         std::forward<Args>(args)...})}
+    {}
+
+    friend void swap(interned_box& a, interned_box& b)
+    {
+        using std::swap;
+        swap(a.impl_, b.impl_);
+    }
+
+    interned_box(interned_box&& other) { swap(*this, other); }
+    interned_box(const interned_box& other)
+        : impl_(other.impl_)
+    {
+        impl_->inc();
+    }
+    interned_box& operator=(interned_box&& other)
+    {
+        swap(*this, other);
+        return *this;
+    }
+    interned_box& operator=(const interned_box& other)
+    {
+        auto aux = other;
+        swap(*this, aux);
+        return *this;
+    }
+    ~interned_box() { release(impl_); }
+
+    /*! Query the current value. */
+    IMMER_NODISCARD const T& get() const { return impl_->value; }
+
+    /*! Query the hash of the current value, as computed by `Hash`. */
+    IMMER_NODISCARD std::size_t hash() const { return impl_->hash; }
+
+    /*! Conversion to the boxed type. */
+    operator const T&() const { return get(); }
+
+    /*! Access via dereference */
+    const T& operator*() const { return get(); }
+
+    /*! Access via pointer member access */
+    const T* operator->() const { return &get(); }
+
+    /*!
+     * Returns a new box built by applying the `fn` to the underlying
+     * value.  Note that, since the value may be shared with other
+     * boxes, it is never updated in place.
+     */
+    template <typename Fn>
+    IMMER_NODISCARD interned_box update(Fn&& fn) const
+    {
+        return std::forward<Fn>(fn)(get());
+    }
+};
+
+template <typename T, typename H, typename E, typename MP>
+IMMER_NODISCARD bool operator==(const interned_box<T, H, E, MP>& a,
+                                const interned_box<T, H, E, MP>& b)
+{
+    return a.impl() == b.impl();
+}
+template <typename T, typename H, typename E, typename MP>
+IMMER_NODISCARD bool operator!=(const interned_box<T, H, E, MP>& a,
+                                const interned_box<T, H, E, MP>& b)
+{
+    return a.impl() != b.impl();
+}
+template <typename T, typename H, typename E, typename MP>
+IMMER_NODISCARD bool operator<(const interned_box<T, H, E, MP>& a,
+                               const interned_box<T, H, E, MP>& b)
+{
+    return a.impl() != b.impl() && a.get() < b.get();
+}
+
+template <typename T, typename H, typename E, typename MP, typename T2>
+IMMER_NODISCARD auto operator==(const interned_box<T, H, E, MP>& a, T2&& b)
+    -> std::enable_if_t<
+        !std::is_same<interned_box<T, H, E, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() == b)>
+{
+    return a.get() == b;
+}
+template <typename T, typename H, typename E, typename MP, typename T2>
+IMMER_NODISCARD auto operator!=(const interned_box<T, H, E, MP>& a, T2&& b)
+    -> std::enable_if_t<
+        !std::is_same<interned_box<T, H, E, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() != b)>
+{
+    return a.get() != b;
+}
+
+template <typename T2, typename T, typename H, typename E, typename MP>
+IMMER_NODISCARD auto operator==(T2&& b, const interned_box<T, H, E, MP>& a)
+    -> std::enable_if_t<
+        !std::is_same<interned_box<T, H, E, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() == b)>
+{
+    return a.get() == b;
+}
+template <typename T2, typename T, typename H, typename E, typename MP>
+IMMER_NODISCARD auto operator!=(T2&& b, const interned_box<T, H, E, MP>& a)
+    -> std::enable_if_t<
+        !std::is_same<interned_box<T, H, E, MP>, std::decay_t<T2>>::value,
+        decltype(a.get() != b)>
+{
+    return a.get() != b;
+}
+
+} // namespace immer
+
+namespace std {
+
+template <typename T, typename H, typename E, typename MP>
+struct hash<immer::interned_box<T, H, E, MP>>
+{
+    std::size_t operator()(const immer::interned_box<T, H, E, MP>& x) const
+    {
+        return x.hash();
+    }
+};
+
+} // namespace std
@@ -0,0 +1,49 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/type_traits.hpp>
+
+#include <type_traits>
+
+namespace immer {
+
+/*!
+ * Interning policy that never interns nodes.  The nodes of a
+ * container are only shared with the containers derived from it.
+ */
+struct no_interning_policy
+{
+    static constexpr bool enabled = false;
+};
+
+namespace detail {
+
+template <typename MP, typename Enable = void>
+struct get_interning_policy
+{
+    using type = no_interning_policy;
+};
+
+template <typename MP>
+struct get_interning_policy<MP, void_t<typename MP::interning>>
+{
+    using type = typename MP::interning;
+};
+
+template <typename MP>
+using get_interning_policy_t = typename get_interning_policy<MP>::type;
+
+template <typename MP>
+using interning_enabled_t =
+    std::integral_constant<bool, get_interning_policy_t<MP>::enabled>;
+
+} // namespace detail
+
+} // namespace immer
@@ -0,0 +1,58 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/intern_table.hpp>
+
+namespace immer {
+
+/*!
+ * Interning policy that makes containers share the equal nodes that
+ * they build independently.  A global table, guarded by the lock of
+ * the memory policy, is kept per kind of node, and a new node is
+ * replaced by an equal one from the table whenever there is one:
+ *
+ * - The leaves of a `vector` or `flex_vector` are interned when they
+ *   become part of the tree, once full, by pushing back elements,
+ *   and when they are updated by a persistent `set` or `update`.
+ *
+ * - The arrays of values of the inner nodes of a `map`, `set` or
+ *   `table` are interned when they are produced by a persistent
+ *   update.  Transients, and r-value updates, fill their own arrays
+ *   in place and do not intern them.
+ *
+ * This saves memory when many equal containers, or containers with
+ * big equal parts, are built from different sources.  Also, equal
+ * interned nodes are compared with a single pointer comparison, such
+ * that comparing equal containers mostly skips their elements.  In
+ * turn, the nodes are hashed and looked up when they are built.
+ *
+ * The table holds a reference to every node in it, so interned nodes
+ * are never updated in place.  Nodes that are only referenced by the
+ * table are released once it has doubled its size since the last
+ * time it did so.
+ *
+ * @rst
+ *
+ * .. note:: Only memory policies with reference counting are
+ *    supported.  The elements of vectors need to be hashable with
+ *    ``std::hash``, and the elements of all containers need to be
+ *    comparable with ``==``.
+ *
+ * @endrst
+ */
+struct node_interning_policy
+{
+    static constexpr bool enabled = true;
+
+    template <typename Traits>
+    using table = detail::intern_table<Traits>;
+};
+
+} // namespace immer
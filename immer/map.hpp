@@ -454,6 +454,39 @@ public:
         return erase_move(move_t{}, k);
     }
 
+    /*!
+     * Returns a map with the same keys where every value `v` is
+     * replaced by `fn(v)`, which may be of a different type.  The keys
+     * are not hashed again: the new map has exactly the same structure
+     * as this one.  It allocates memory and its complexity is @f$ O(n)
+     * @f$.
+     */
+    template <typename Fn>
+    IMMER_NODISCARD auto transform_values(Fn&& fn) const
+    {
+        using mapped_t =
+            std::decay_t<decltype(fn(std::declval<const mapped_type&>()))>;
+        using result_t = map<K, mapped_t, Hash, Equal, MemoryPolicy, B>;
+        using result_value_t = typename result_t::value_type;
+        return result_t{
+            impl_.template transform<typename result_t::impl_t>(
+                [&](const value_t& v) {
+                    return result_value_t{v.first, fn(v.second)};
+                })};
+    }
+
+    /*!
+     * Returns a map with only the associations for which `pred(v)` is
+     * true, where `v` is a `value_type`.  The keys are not hashed
+     * again and the subtrees where nothing is removed are shared with
+     * this map.  Its complexity is @f$ O(n) @f$.
+     */
+    template <typename Pred>
+    IMMER_NODISCARD map filter(Pred&& pred) const
+    {
+        return impl_.filter(std::forward<Pred>(pred));
+    }
+
     /*!
      * Returns a @a transient form of this container, an
      * `immer::map_transient`.
@@ -473,6 +506,14 @@ public:
 private:
     friend transient_type;
 
+    template <typename K2,
+              typename T2,
+              typename Hash2,
+              typename Equal2,
+              typename MemoryPolicy2,
+              detail::hamts::bits_t B2>
+    friend class map;
+
     map&& insert_move(std::true_type, value_type value)
     {
         impl_.add_mut({}, std::move(value));
@@ -8,13 +8,18 @@
 
 #pragma once
 
+#include <immer/growth/factor_growth_policy.hpp>
 #include <immer/heap/cpp_heap.hpp>
 #include <immer/heap/heap_policy.hpp>
+#include <immer/interning/no_interning_policy.hpp>
 #include <immer/lock/no_lock_policy.hpp>
 #include <immer/lock/spinlock_policy.hpp>
+#include <immer/reclamation/immediate_reclamation_policy.hpp>
+#include <immer/refcount/compact_refcount_policy.hpp>
 #include <immer/refcount/no_refcount_policy.hpp>
 #include <immer/refcount/refcount_policy.hpp>
 #include <immer/refcount/unsafe_refcount_policy.hpp>
+#include <immer/transience/compact_transience_policy.hpp>
 #include <immer/transience/gc_transience_policy.hpp>
 #include <immer/transience/no_transience_policy.hpp>
 #include <type_traits>
@@ -32,6 +37,13 @@ struct get_transience_policy
                        no_transience_policy>
 {};
 
+template <typename Word, unsigned OwnerBits>
+struct get_transience_policy<basic_compact_refcount_policy<Word, OwnerBits>>
+{
+    using type = compact_transience_policy<
+        basic_compact_refcount_policy<Word, OwnerBits>>;
+};
+
 template <typename T>
 using get_transience_policy_t = typename get_transience_policy<T>::type;
 
@@ -65,6 +77,12 @@ template <typename T>
 constexpr auto get_use_transient_rvalues_v =
     get_use_transient_rvalues<T>::value;
 
+/*!
+ * By default, containers that keep spare capacity double it whenever
+ * they run out of it.
+ */
+using default_growth_policy = factor_growth_policy<2>;
+
 /*!
  * This is a default implementation of a *memory policy*.  A memory
  * policy is just a bag of other policies plus some flags with hints
@@ -82,6 +100,20 @@ constexpr auto get_use_transient_rvalues_v =
  * @tparam UseTransientRValues Boolean flag indicating whether
  *         immutable containers should try to modify contents in-place
  *         when manipulating an r-value reference.
+ * @tparam InlineSmallBoxes Boolean flag indicating whether a @ref box
+ *         of a trivially copyable type that fits in a pointer and
+ *         has no padding should store its value inline, instead of
+ *         allocating a reference counted object in the heap.  Before
+ *         C++17, only scalar types are known to have no padding.
+ * @tparam GrowthPolicy A *growth policy*, for example, @ref
+ *         factor_growth_policy.  It decides how much spare capacity
+ *         an @ref array allocates when it grows in place.
+ * @tparam ReclamationPolicy A *reclamation policy*, for example,
+ *         @ref deferred_reclamation_policy.  It decides when the
+ *         nodes of a tree are freed once it is no longer used.
+ * @tparam InterningPolicy An *interning policy*, for example, @ref
+ *         node_interning_policy.  It decides whether equal nodes that
+ *         are built independently are shared.
  */
 template <typename HeapPolicy,
           typename RefcountPolicy,
@@ -90,19 +122,28 @@ template <typename HeapPolicy,
           bool PreferFewerBiggerObjects =
               get_prefer_fewer_bigger_objects_v<HeapPolicy>,
           bool UseTransientRValues =
-              get_use_transient_rvalues_v<RefcountPolicy>>
+              get_use_transient_rvalues_v<RefcountPolicy>,
+          bool InlineSmallBoxes = false,
+          typename GrowthPolicy = default_growth_policy,
+          typename ReclamationPolicy = immediate_reclamation_policy,
+          typename InterningPolicy = no_interning_policy>
 struct memory_policy
 {
-    using heap       = HeapPolicy;
-    using refcount   = RefcountPolicy;
-    using transience = TransiencePolicy;
-    using lock       = LockPolicy;
+    using heap        = HeapPolicy;
+    using refcount    = RefcountPolicy;
+    using transience  = TransiencePolicy;
+    using lock        = LockPolicy;
+    using growth      = GrowthPolicy;
+    using reclamation = ReclamationPolicy;
+    using interning   = InterningPolicy;
 
     static constexpr bool prefer_fewer_bigger_objects =
         PreferFewerBiggerObjects;
 
     static constexpr bool use_transient_rvalues = UseTransientRValues;
 
+    static constexpr bool inline_small_boxes = InlineSmallBoxes;
+
     using transience_t = typename transience::template apply<heap>::type;
 };
 
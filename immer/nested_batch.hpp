@@ -0,0 +1,148 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+namespace immer {
+
+/*!
+ * Batches many updates to the elements of the containers stored in a
+ * map, like a `map<K, flex_vector<T>>`.
+ *
+ * @tparam Map The type of the map, whose mapped type has to provide
+ *         a transient.  The transient headers of both the map and
+ *         the mapped type have to be included.
+ *
+ * @rst
+ *
+ * Updating ``m[k][i]`` with ``m.update(k, [&](auto v) { return
+ * v.set(i, x); })`` copies the path to ``k`` in the map and the path
+ * to ``i`` in the inner container on every call.  Instead, this class
+ * keeps the map as a transient and opens a transient for every inner
+ * container the first time one of its elements is updated.  The
+ * following updates to the same inner container happen in place.
+ * Calling ``persistent()`` puts the inner containers back into the
+ * map, once per key.
+ *
+ * When the map node that holds an inner container can be mutated, the
+ * container is moved out of the map instead of copied, such that an
+ * inner container that is not shared with anybody else is updated in
+ * place from the start.
+ *
+ * **Example**
+ *   .. code-block:: c++
+ *
+ *      auto batch = immer::nested_batch<book_t>{std::move(book)};
+ *      for (auto&& order : orders)
+ *          batch.set(order.symbol, order.level, order.quantity);
+ *      book = std::move(batch).persistent();
+ *
+ * @endrst
+ */
+template <typename Map>
+class nested_batch
+{
+public:
+    using persistent_type = Map;
+    using key_type        = typename Map::key_type;
+    using mapped_type     = typename Map::mapped_type;
+    using size_type       = typename mapped_type::size_type;
+    using value_type      = typename mapped_type::value_type;
+
+    using map_transient_type   = typename Map::transient_type;
+    using inner_transient_type = typename mapped_type::transient_type;
+
+    /*!
+     * Starts a batch of updates on `m`.
+     */
+    explicit nested_batch(Map m = {})
+        : outer_{std::move(m).transient()}
+    {}
+
+    /*!
+     * Returns the transient of the container associated to `k`,
+     * opening it when this is the first access to that key.  A
+     * default constructed container is used when `k` is not in the
+     * map.  The reference is valid until `persistent()` is called.
+     */
+    inner_transient_type& inner(const key_type& k)
+    {
+        auto it = open_.find(k);
+        if (it != open_.end())
+            return it->second;
+        auto t = inner_transient_type{};
+        outer_.update(k, [&](auto&& v) {
+            t = mapped_type(std::forward<decltype(v)>(v)).transient();
+            return mapped_type{};
+        });
+        return open_.emplace(k, std::move(t)).first->second;
+    }
+
+    /*!
+     * Sets the element at position `i` of the container associated
+     * to `k` to `value`.
+     */
+    void set(const key_type& k, size_type i, value_type value)
+    {
+        inner(k).set(i, std::move(value));
+    }
+
+    /*!
+     * Replaces the element at position `i` of the container
+     * associated to `k` with the result of `fn(element)`.
+     */
+    template <typename Fn>
+    void update(const key_type& k, size_type i, Fn&& fn)
+    {
+        inner(k).update(i, std::forward<Fn>(fn));
+    }
+
+    /*!
+     * Number of inner containers that have been opened.
+     */
+    IMMER_NODISCARD std::size_t open_count() const { return open_.size(); }
+
+    /*!
+     * Puts the updated inner containers back into the map and returns
+     * it.  The batch can still be used afterwards.
+     */
+    IMMER_NODISCARD persistent_type persistent() &
+    {
+        close();
+        return outer_.persistent();
+    }
+    IMMER_NODISCARD persistent_type persistent() &&
+    {
+        close();
+        return std::move(outer_).persistent();
+    }
+
+private:
+    void close()
+    {
+        for (auto& kv : open_)
+            outer_.set(kv.first, std::move(kv.second).persistent());
+        open_.clear();
+    }
+
+    using open_map_t = std::unordered_map<key_type,
+                                          inner_transient_type,
+                                          typename Map::hasher,
+                                          typename Map::key_equal>;
+
+    map_transient_type outer_;
+    open_map_t open_;
+};
+
+} // namespace immer
@@ -0,0 +1,501 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+#include <immer/detail/iterator_facade.hpp>
+#include <immer/map.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace immer {
+namespace detail {
+
+template <typename Patched>
+struct patched_vector_iterator
+    : iterator_facade<patched_vector_iterator<Patched>,
+                      std::random_access_iterator_tag,
+                      typename Patched::value_type,
+                      const typename Patched::value_type&,
+                      std::ptrdiff_t,
+                      const typename Patched::value_type*>
+{
+    using base_iterator = typename Patched::vector_type::iterator;
+    using patch_t       = typename Patched::patch_t;
+    using value_t       = typename Patched::value_type;
+    using size_t        = typename Patched::size_type;
+
+    struct end_t
+    {};
+
+    patched_vector_iterator() = default;
+
+    patched_vector_iterator(const Patched& v)
+        : v_{&v}
+        , i_{0}
+        , it_{v.base().begin()}
+    {
+        seek();
+    }
+
+    patched_vector_iterator(const Patched& v, end_t)
+        : v_{&v}
+        , i_{v.size()}
+        , it_{v.base().end()}
+    {
+        seek();
+    }
+
+private:
+    friend iterator_core_access;
+
+    const Patched* v_;
+    size_t i_;
+    base_iterator it_;
+    const patch_t* first_ = nullptr;
+    const patch_t* p_     = nullptr;
+    const patch_t* last_  = nullptr;
+
+    // Points the iterator to the patches of the chunk containing i_,
+    // this is done only when crossing to another chunk.
+    void seek()
+    {
+        if (auto c = v_->chunks_.find(Patched::chunk_of(i_))) {
+            first_ = c->begin();
+            last_  = c->end();
+            p_     = Patched::lower_bound(*c, i_);
+        } else {
+            first_ = p_ = last_ = nullptr;
+        }
+    }
+
+    void increment()
+    {
+        assert(i_ < v_->size());
+        if (p_ != last_ && p_->index == i_)
+            ++p_;
+        ++i_;
+        ++it_;
+        if (Patched::chunk_of(i_) != Patched::chunk_of(i_ - 1))
+            seek();
+    }
+
+    void decrement()
+    {
+        assert(i_ > 0);
+        --i_;
+        --it_;
+        if (Patched::chunk_of(i_) != Patched::chunk_of(i_ + 1))
+            seek();
+        else if (p_ != first_ && (p_ - 1)->index == i_)
+            --p_;
+    }
+
+    void advance(std::ptrdiff_t n)
+    {
+        assert(n <= 0 || i_ + static_cast<size_t>(n) <= v_->size());
+        assert(n >= 0 || static_cast<size_t>(-n) <= i_);
+        i_ += n;
+        it_ += n;
+        seek();
+    }
+
+    bool equal(const patched_vector_iterator& other) const
+    {
+        return i_ == other.i_;
+    }
+
+    std::ptrdiff_t distance_to(const patched_vector_iterator& other) const
+    {
+        return other.i_ > i_ ? static_cast<std::ptrdiff_t>(other.i_ - i_)
+                             : -static_cast<std::ptrdiff_t>(i_ - other.i_);
+    }
+
+    const value_t& dereference() const
+    {
+        return p_ != last_ && p_->index == i_ ? p_->value : *it_;
+    }
+};
+
+} // namespace detail
+
+/*!
+ * Immutable sequential container that records updates to individual
+ * elements as *patches* on top of a shared `vector` or `flex_vector`,
+ * instead of copying the leaf that contains the element.
+ *
+ * @tparam Vector The underlying container, a `vector` or a
+ *         `flex_vector`.
+ * @tparam MaxPatches Maximum number of patches to keep per leaf.
+ *
+ * @rst
+ *
+ * Updating one element of a vector copies the whole leaf that holds
+ * it, plus the path to it.  When the elements are big or the leaves
+ * are wide, this dominates the cost of sparse updates to a vector
+ * that is shared with older versions.  Here, the patches are grouped
+ * in *chunks* of :math:`2^{BL}` consecutive elements, the size of a
+ * leaf of the underlying vector, which are kept in a persistent map.
+ * ``set()`` and ``update()`` copy only the small sorted array with the
+ * patches of the chunk of the element, plus the path to it in the map.
+ *
+ * Once a chunk has ``MaxPatches`` patches, the next update to it
+ * *compacts* that chunk: its patches are applied to the underlying
+ * vector via a transient, which copies the leaf once, and they are
+ * removed from the map.  The patches of other chunks are kept.  The
+ * ``compact()`` method, that is also used when a transient is
+ * requested, returns the vector with all the patches applied.
+ *
+ * Reading an element is :math:`O(log(MaxPatches))` on top of the cost
+ * of reading the underlying vector and finding its chunk in the map.
+ * Hence, small values for ``MaxPatches`` work best.
+ *
+ * **Example**
+ *   .. code-block:: c++
+ *
+ *      auto records = immer::patched_vector<immer::flex_vector<record>>{
+ *          load_records()};
+ *      auto v2 = records.set(1234, record{...}); // no leaf copy
+ *      auto v3 = v2.compact();                  // flex_vector<record>
+ *
+ * @endrst
+ */
+template <typename Vector, std::size_t MaxPatches = 8>
+class patched_vector
+{
+public:
+    using vector_type     = Vector;
+    using memory_policy   = typename Vector::memory_policy;
+    using value_type      = typename Vector::value_type;
+    using reference       = const value_type&;
+    using size_type       = typename Vector::size_type;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const value_type&;
+
+    using iterator         = detail::patched_vector_iterator<patched_vector>;
+    using const_iterator   = iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    using transient_type = typename Vector::transient_type;
+
+    static constexpr std::size_t max_patches = MaxPatches;
+    static constexpr auto chunk_bits         = Vector::bits_leaf;
+
+    /*!
+     * Default constructor.  It creates a container of `size() == 0`.
+     */
+    patched_vector() = default;
+
+    /*!
+     * Constructs a container with the elements of `v` and no patches.
+     */
+    patched_vector(Vector v)
+        : base_{std::move(v)}
+    {}
+
+    /*!
+     * Returns an iterator pointing at the first element of the
+     * collection.  It does not allocate memory and its complexity is
+     * @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD iterator begin() const { return {*this}; }
+
+    /*!
+     * Returns an iterator pointing just after the last element of the
+     * collection.  It does not allocate and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD iterator end() const
+    {
+        return {*this, typename iterator::end_t{}};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing at the first element of the reversed collection.
+     */
+    IMMER_NODISCARD reverse_iterator rbegin() const
+    {
+        return reverse_iterator{end()};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing after the last element of the reversed collection.
+     */
+    IMMER_NODISCARD reverse_iterator rend() const
+    {
+        return reverse_iterator{begin()};
+    }
+
+    /*!
+     * Returns the number of elements in the container.
+     */
+    IMMER_NODISCARD size_type size() const { return base_.size(); }
+
+    /*!
+     * Returns `true` if there are no elements in the container.
+     */
+    IMMER_NODISCARD bool empty() const { return base_.empty(); }
+
+    /*!
+     * Returns the number of elements that are currently patched.
+     */
+    IMMER_NODISCARD std::size_t patch_count() const { return count_; }
+
+    /*!
+     * Returns the underlying vector, *without* the patches applied.
+     */
+    IMMER_NODISCARD const Vector& base() const { return base_; }
+
+    /*!
+     * Returns a `const` reference to the element at position `index`.
+     * It is undefined when @f$ 0 index \geq size() @f$.
+     */
+    IMMER_NODISCARD reference operator[](size_type index) const
+    {
+        auto p = find_patch(index);
+        return p ? *p : base_[index];
+    }
+
+    /*!
+     * Returns a `const` reference to the element at position
+     * `index`. It throws an `std::out_of_range` exception when @f$
+     * index \geq size() @f$.
+     */
+    reference at(size_type index) const
+    {
+        if (index >= size())
+            IMMER_THROW(std::out_of_range{"index out of range"});
+        return (*this)[index];
+    }
+
+    /*!
+     * Returns a vector with the element at position `index` replaced
+     * by `value`.  It copies the patches of the chunk of `index`, or
+     * it compacts that chunk when it has already `MaxPatches` of them.
+     */
+    IMMER_NODISCARD patched_vector set(size_type index, value_type value) const&
+    {
+        return patched_vector{*this}.set_mut(index, std::move(value));
+    }
+
+    IMMER_NODISCARD decltype(auto) set(size_type index, value_type value) &&
+    {
+        return std::move(set_mut(index, std::move(value)));
+    }
+
+    /*!
+     * Returns a vector with the element at position `index` replaced
+     * by the result of `fn(element)`.
+     */
+    template <typename FnT>
+    IMMER_NODISCARD patched_vector update(size_type index, FnT&& fn) const&
+    {
+        return set(index, std::forward<FnT>(fn)((*this)[index]));
+    }
+
+    template <typename FnT>
+    IMMER_NODISCARD decltype(auto) update(size_type index, FnT&& fn) &&
+    {
+        auto value = std::forward<FnT>(fn)((*this)[index]);
+        return std::move(set_mut(index, std::move(value)));
+    }
+
+    /*!
+     * Returns a vector with `value` inserted at the end.  The patches
+     * are kept.
+     */
+    IMMER_NODISCARD patched_vector push_back(value_type value) const&
+    {
+        return {base_.push_back(std::move(value)), chunks_, count_};
+    }
+
+    IMMER_NODISCARD decltype(auto) push_back(value_type value) &&
+    {
+        base_ = std::move(base_).push_back(std::move(value));
+        return std::move(*this);
+    }
+
+    /*!
+     * Returns a vector with only the first `elems` elements.  The
+     * patches past the end are dropped.
+     */
+    IMMER_NODISCARD patched_vector take(size_type elems) const&
+    {
+        return patched_vector{*this}.take_mut(elems);
+    }
+
+    IMMER_NODISCARD decltype(auto) take(size_type elems) &&
+    {
+        return std::move(take_mut(elems));
+    }
+
+    /*!
+     * Returns the underlying vector with the patches applied.
+     */
+    IMMER_NODISCARD Vector compact() const&
+    {
+        return patched_vector{*this}.compact_mut().base_;
+    }
+
+    IMMER_NODISCARD Vector compact() &&
+    {
+        return std::move(compact_mut().base_);
+    }
+
+    /*!
+     * Returns a transient form of the vector, with the patches
+     * applied.
+     */
+    IMMER_NODISCARD transient_type transient() const&
+    {
+        return compact().transient();
+    }
+
+    IMMER_NODISCARD transient_type transient() &&
+    {
+        return std::move(*this).compact().transient();
+    }
+
+    /*!
+     * Returns `true` if there are the same number of elements in both
+     * and all of them compare equal.
+     */
+    IMMER_NODISCARD bool operator==(const patched_vector& other) const
+    {
+        return size() == other.size() &&
+               std::equal(begin(), end(), other.begin());
+    }
+    IMMER_NODISCARD bool operator!=(const patched_vector& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    friend iterator;
+
+    struct patch_t
+    {
+        size_type index;
+        value_type value;
+    };
+
+    using patches_t = array<patch_t, memory_policy>;
+    using chunks_t  = map<size_type,
+                         patches_t,
+                         std::hash<size_type>,
+                         std::equal_to<size_type>,
+                         memory_policy>;
+
+    patched_vector(Vector base, chunks_t chunks, std::size_t count)
+        : base_{std::move(base)}
+        , chunks_{std::move(chunks)}
+        , count_{count}
+    {}
+
+    static size_type chunk_of(size_type index) { return index >> chunk_bits; }
+
+    static const patch_t* lower_bound(const patches_t& ps, size_type index)
+    {
+        return std::lower_bound(
+            ps.begin(), ps.end(), index, [](const patch_t& p, size_type i) {
+                return p.index < i;
+            });
+    }
+
+    const value_type* find_patch(size_type index) const
+    {
+        if (auto c = chunks_.find(chunk_of(index))) {
+            auto p = lower_bound(*c, index);
+            if (p != c->end() && p->index == index)
+                return &p->value;
+        }
+        return nullptr;
+    }
+
+    patched_vector& set_mut(size_type index, value_type value)
+    {
+        assert(index < size());
+        auto key = chunk_of(index);
+        auto c   = chunks_.find(key);
+        if (!c) {
+            chunks_ = std::move(chunks_).set(
+                key, patches_t{patch_t{index, std::move(value)}});
+            ++count_;
+            return *this;
+        }
+        auto p   = lower_bound(*c, index);
+        auto pos = static_cast<size_type>(p - c->begin());
+        if (p != c->end() && p->index == index) {
+            auto ps = c->set(pos, patch_t{index, std::move(value)});
+            chunks_ = std::move(chunks_).set(key, std::move(ps));
+        } else if (c->size() < MaxPatches) {
+            auto t = typename patches_t::transient_type{};
+            for (auto i = size_type{}; i < pos; ++i)
+                t.push_back((*c)[i]);
+            t.push_back(patch_t{index, std::move(value)});
+            for (auto i = pos; i < c->size(); ++i)
+                t.push_back((*c)[i]);
+            chunks_ = std::move(chunks_).set(key, std::move(t).persistent());
+            ++count_;
+        } else {
+            auto t = std::move(base_).transient();
+            for (auto& x : *c)
+                t.set(x.index, x.value);
+            t.set(index, std::move(value));
+            base_ = std::move(t).persistent();
+            count_ -= c->size();
+            chunks_ = std::move(chunks_).erase(key);
+        }
+        return *this;
+    }
+
+    patched_vector& take_mut(size_type elems)
+    {
+        base_       = std::move(base_).take(elems);
+        auto chunks = chunks_;
+        for (auto& kv : chunks) {
+            auto& ps = kv.second;
+            auto n   = static_cast<size_type>(lower_bound(ps, elems) -
+                                            ps.begin());
+            if (n < ps.size()) {
+                count_ -= ps.size() - n;
+                chunks_ = n ? std::move(chunks_).set(kv.first, ps.take(n))
+                            : std::move(chunks_).erase(kv.first);
+            }
+        }
+        return *this;
+    }
+
+    patched_vector& compact_mut()
+    {
+        if (count_) {
+            auto t = std::move(base_).transient();
+            for (auto& kv : chunks_)
+                for (auto& x : kv.second)
+                    t.set(x.index, x.value);
+            base_   = std::move(t).persistent();
+            chunks_ = {};
+            count_  = 0;
+        }
+        return *this;
+    }
+
+    Vector base_;
+    chunks_t chunks_;
+    std::size_t count_ = 0;
+};
+
+} // namespace immer
@@ -0,0 +1,198 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/heaps/leftist_heap.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <functional>
+
+namespace immer {
+
+template <typename T, typename Compare, typename MemoryPolicy>
+class priority_queue_transient;
+
+/*!
+ * Immutable priority queue, giving access to its greatest element.
+ *
+ * @tparam T The type of the values to be stored in the container.
+ * @tparam Compare The type of a function object defining a strict
+ *         weak ordering of values of type `T`.  Like in
+ *         `std::priority_queue`, the top of the queue is an element
+ *         that is not less than any other.
+ * @tparam MemoryPolicy Memory management policy. See @ref
+ *         memory_policy.
+ *
+ * @rst
+ *
+ * This container is a persistent leftist heap.  Every element lives in
+ * its own fixed size node, allocated through the optimized heap of the
+ * memory policy.  Pushing, popping and merging two queues take
+ * :math:`O(log(n))` in the worst case, and only copy the nodes on the
+ * right spines of the heaps involved.  Unlike amortized heaps, like
+ * pairing heaps, these bounds hold even when the same version of the
+ * queue is popped repeatedly.
+ *
+ * @endrst
+ */
+template <typename T,
+          typename Compare      = std::less<T>,
+          typename MemoryPolicy = default_memory_policy>
+class priority_queue
+{
+    using impl_t = detail::heaps::leftist_heap<T, Compare, MemoryPolicy>;
+
+    using move_t =
+        std::integral_constant<bool, MemoryPolicy::use_transient_rvalues>;
+
+public:
+    using value_type      = T;
+    using size_type       = detail::heaps::size_t;
+    using value_compare   = Compare;
+    using reference       = const T&;
+    using const_reference = const T&;
+
+    using transient_type = priority_queue_transient<T, Compare, MemoryPolicy>;
+
+    using memory_policy_type = MemoryPolicy;
+
+    /*!
+     * Default constructor.  It creates a queue of `size() == 0`.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    priority_queue() = default;
+
+    /*!
+     * Constructs a queue containing the elements in `values`.
+     */
+    priority_queue(std::initializer_list<T> values)
+        : impl_{impl_t::from_initializer_list(values)}
+    {}
+
+    /*!
+     * Constructs a queue containing the elements in the range defined
+     * by the input iterator `first` and range sentinel `last`.
+     */
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<detail::compatible_sentinel_v<Iter, Sent>,
+                               bool> = true>
+    priority_queue(Iter first, Sent last)
+        : impl_{impl_t::from_range(first, last)}
+    {}
+
+    /*!
+     * Returns the number of elements in the container.  It does
+     * not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD size_type size() const { return impl_.size; }
+
+    /*!
+     * Returns `true` if there are no elements in the container.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD bool empty() const { return impl_.size == 0; }
+
+    /*!
+     * Returns a `const` reference to the greatest element in the
+     * queue.  The queue must not be empty.  It does not allocate
+     * memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD const T& top() const { return impl_.top(); }
+
+    /*!
+     * Returns a queue with `value` added to it.  It may allocate
+     * memory and its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD priority_queue push(value_type value) const&
+    {
+        return impl_.push(std::move(value));
+    }
+    IMMER_NODISCARD decltype(auto) push(value_type value) &&
+    {
+        return push_move(move_t{}, std::move(value));
+    }
+
+    /*!
+     * Returns a queue without its greatest element.  The queue must
+     * not be empty.  It may allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD priority_queue pop() const& { return impl_.pop(); }
+    IMMER_NODISCARD decltype(auto) pop() && { return pop_move(move_t{}); }
+
+    /*!
+     * Returns a queue with the elements of both this queue and
+     * `other`.  It may allocate memory and its complexity is @f$
+     * O(log(size) + log(other.size)) @f$.
+     */
+    IMMER_NODISCARD priority_queue merge(const priority_queue& other) const&
+    {
+        return impl_.merge(other.impl_);
+    }
+    IMMER_NODISCARD decltype(auto) merge(const priority_queue& other) &&
+    {
+        return merge_move(move_t{}, other);
+    }
+
+    /*!
+     * Returns an @a transient form of this container, an
+     * `immer::priority_queue_transient`.
+     */
+    IMMER_NODISCARD transient_type transient() const&
+    {
+        return transient_type{impl_};
+    }
+    IMMER_NODISCARD transient_type transient() &&
+    {
+        return transient_type{std::move(impl_)};
+    }
+
+    // Semi-private
+    const impl_t& impl() const { return impl_; }
+
+private:
+    friend transient_type;
+
+    priority_queue&& push_move(std::true_type, value_type value)
+    {
+        impl_.push_mut({}, std::move(value));
+        return std::move(*this);
+    }
+    priority_queue push_move(std::false_type, value_type value)
+    {
+        return impl_.push(std::move(value));
+    }
+
+    priority_queue&& pop_move(std::true_type)
+    {
+        impl_.pop_mut({});
+        return std::move(*this);
+    }
+    priority_queue pop_move(std::false_type) { return impl_.pop(); }
+
+    priority_queue&& merge_move(std::true_type, const priority_queue& other)
+    {
+        impl_.merge_mut({}, other.impl_);
+        return std::move(*this);
+    }
+    priority_queue merge_move(std::false_type, const priority_queue& other)
+    {
+        return impl_.merge(other.impl_);
+    }
+
+    priority_queue(impl_t impl)
+        : impl_(std::move(impl))
+    {}
+
+    impl_t impl_;
+};
+
+} // namespace immer
@@ -0,0 +1,122 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/heaps/leftist_heap.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <functional>
+
+namespace immer {
+
+template <typename T, typename Compare, typename MemoryPolicy>
+class priority_queue;
+
+/*!
+ * Mutable version of `immer::priority_queue`.
+ *
+ * @rst
+ *
+ * Refer to :doc:`transients` to learn more about when and how to use
+ * the mutable versions of immutable containers.
+ *
+ * @endrst
+ */
+template <typename T,
+          typename Compare      = std::less<T>,
+          typename MemoryPolicy = default_memory_policy>
+class priority_queue_transient : MemoryPolicy::transience_t::owner
+{
+    using base_t  = typename MemoryPolicy::transience_t::owner;
+    using owner_t = base_t;
+
+public:
+    using persistent_type = priority_queue<T, Compare, MemoryPolicy>;
+
+    using value_type      = T;
+    using size_type       = detail::heaps::size_t;
+    using value_compare   = Compare;
+    using reference       = const T&;
+    using const_reference = const T&;
+
+    /*!
+     * Default constructor.  It creates a queue of `size() == 0`.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    priority_queue_transient() = default;
+
+    /*!
+     * Returns the number of elements in the container.  It does
+     * not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD size_type size() const { return impl_.size; }
+
+    /*!
+     * Returns `true` if there are no elements in the container.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD bool empty() const { return impl_.size == 0; }
+
+    /*!
+     * Returns a `const` reference to the greatest element in the
+     * queue.  The queue must not be empty.  It does not allocate
+     * memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD const T& top() const { return impl_.top(); }
+
+    /*!
+     * Adds `value` to the queue.  It may allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    void push(value_type value) { impl_.push_mut(*this, std::move(value)); }
+
+    /*!
+     * Removes the greatest element from the queue.  The queue must not
+     * be empty.  It may allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    void pop() { impl_.pop_mut(*this); }
+
+    /*!
+     * Adds the elements of `other` to this queue.  It may allocate
+     * memory and its complexity is @f$ O(log(size) + log(other.size))
+     * @f$.
+     */
+    void merge(const persistent_type& other)
+    {
+        impl_.merge_mut(*this, other.impl());
+    }
+
+    /*!
+     * Returns an @a immutable form of this container, an
+     * `immer::priority_queue`.
+     */
+    IMMER_NODISCARD persistent_type persistent() &
+    {
+        this->owner_t::operator=(owner_t{});
+        return impl_;
+    }
+    IMMER_NODISCARD persistent_type persistent() && { return std::move(impl_); }
+
+private:
+    friend persistent_type;
+    using impl_t = typename persistent_type::impl_t;
+
+    priority_queue_transient(impl_t impl)
+        : impl_(std::move(impl))
+    {}
+
+    impl_t impl_;
+
+public:
+    // Semi-private
+    const impl_t& impl() const { return impl_; }
+};
+
+} // namespace immer
@@ -0,0 +1,178 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace immer {
+
+/*!
+ * Events in the internals of the containers that are reported to the
+ * probes when `IMMER_ENABLE_PROBES` is defined to a non-zero value.
+ */
+enum class probe_event
+{
+    //! An inner node of a vector, flex_vector, map, set or table was
+    //! allocated.
+    inner_alloc,
+    //! A relaxed inner node of a flex_vector was allocated.
+    relaxed_alloc,
+    //! A leaf of a vector or flex_vector, or the buffer of an array,
+    //! was allocated.
+    leaf_alloc,
+    //! The array of values of an inner node of a map, set or table
+    //! was allocated.
+    values_alloc,
+    //! A collision node of a map, set or table was allocated.
+    collision_alloc,
+    //! A node was copied in order to update it, as done along the path
+    //! to the updated element by every persistent update.
+    node_copy,
+    //! A node was updated in place, because it was owned by the
+    //! transient, or because it was not shared with anybody else.
+    mutate_in_place,
+    //! A node could not be updated in place and had to be copied,
+    //! even though the operation is a transient or r-value one.
+    mutate_denied,
+};
+
+/*!
+ * Number of different @ref probe_event values.
+ */
+constexpr std::size_t probe_event_count =
+    static_cast<std::size_t>(probe_event::mutate_denied) + 1;
+
+/*!
+ * Number of times that each @ref probe_event happened, indexed by the
+ * numeric value of the event.
+ */
+using probe_counts = std::array<std::size_t, probe_event_count>;
+
+/*!
+ * Function that is called on every event when probes are enabled.
+ */
+using probe_handler = void (*)(probe_event event, void* context);
+
+/*!
+ * Returns the name of the event, e.g. `"node_copy"`.
+ */
+inline const char* to_string(probe_event ev)
+{
+    switch (ev) {
+    case probe_event::inner_alloc:
+        return "inner_alloc";
+    case probe_event::relaxed_alloc:
+        return "relaxed_alloc";
+    case probe_event::leaf_alloc:
+        return "leaf_alloc";
+    case probe_event::values_alloc:
+        return "values_alloc";
+    case probe_event::collision_alloc:
+        return "collision_alloc";
+    case probe_event::node_copy:
+        return "node_copy";
+    case probe_event::mutate_in_place:
+        return "mutate_in_place";
+    case probe_event::mutate_denied:
+        return "mutate_denied";
+    }
+    return "unknown";
+}
+
+namespace detail {
+
+struct probe_state
+{
+    std::array<std::atomic<std::size_t>, probe_event_count> counts = {};
+    std::atomic<probe_handler> handler{nullptr};
+    std::atomic<void*> context{nullptr};
+};
+
+inline probe_state& probes()
+{
+    static probe_state s;
+    return s;
+}
+
+inline void probe_hit(probe_event ev)
+{
+    auto& s = probes();
+    s.counts[static_cast<std::size_t>(ev)].fetch_add(
+        1, std::memory_order_relaxed);
+    if (auto h = s.handler.load(std::memory_order_relaxed))
+        h(ev, s.context.load(std::memory_order_relaxed));
+}
+
+inline bool probe_mutate(bool can)
+{
+    probe_hit(can ? probe_event::mutate_in_place : probe_event::mutate_denied);
+    return can;
+}
+
+} // namespace detail
+
+/*!
+ * Returns how many times each event has happened so far, in all
+ * threads.  Subtract the counts taken before some code to find out
+ * what it did.  The counts stay at zero unless `IMMER_ENABLE_PROBES`
+ * is enabled.
+ *
+ * @rst
+ *
+ * **Example**
+ *   .. code-block:: c++
+ *
+ *      #define IMMER_ENABLE_PROBES 1
+ *      #include <immer/probe.hpp>
+ *      #include <immer/vector.hpp>
+ *
+ *      auto before = immer::get_probe_counts();
+ *      auto v = std::move(w).push_back(42);
+ *      auto after = immer::get_probe_counts();
+ *      auto copies = after[std::size_t(immer::probe_event::node_copy)] -
+ *                    before[std::size_t(immer::probe_event::node_copy)];
+ *
+ * @endrst
+ */
+inline probe_counts get_probe_counts()
+{
+    auto& s = detail::probes();
+    auto r  = probe_counts{};
+    for (auto i = std::size_t{}; i < probe_event_count; ++i)
+        r[i] = s.counts[i].load(std::memory_order_relaxed);
+    return r;
+}
+
+/*!
+ * Installs a function that is called, in the thread where it
+ * happens, on every event, or removes it when `nullptr` is passed.
+ * It should be installed before containers are used from multiple
+ * threads.
+ */
+inline void set_probe_handler(probe_handler handler, void* context = nullptr)
+{
+    auto& s = detail::probes();
+    s.context.store(context, std::memory_order_relaxed);
+    s.handler.store(handler, std::memory_order_relaxed);
+}
+
+} // namespace immer
+
+#if IMMER_ENABLE_PROBES
+#define IMMER_PROBE(event)                                                     \
+    ::immer::detail::probe_hit(::immer::probe_event::event)
+#define IMMER_PROBE_MUTATE(can) ::immer::detail::probe_mutate(can)
+#else
+#define IMMER_PROBE(event)
+#define IMMER_PROBE_MUTATE(can) (can)
+#endif
@@ -0,0 +1,95 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/reclamation/reclamation_queue.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace immer {
+
+/*!
+ * Reclamation policy that, when the last reference to the root of a
+ * `vector`, `flex_vector`, `map`, `set` or `table` is dropped, defers
+ * freeing its nodes to a @ref reclamation_queue.  Freeing a big
+ * container then takes a bounded amount of time in the thread that
+ * drops it, and the rest of the work is done later, in bounded
+ * slices, by whoever drains the queue.
+ *
+ * @tparam Budget Number of entries of the queue that are processed
+ *         every time a container is dropped.  When zero, the queue
+ *         has to be drained explicitly, for example, with a @ref
+ *         reclamation_thread.
+ *
+ * @tparam Tag Containers whose policies have different tags use
+ *         different queues.
+ *
+ * @rst
+ *
+ * .. warning:: Nodes are freed only when the queue is drained.  With
+ *    a ``Budget`` of zero, memory grows without bounds unless
+ *    something drains the queue.
+ *
+ * @endrst
+ */
+template <std::size_t Budget = 16, typename Tag = void>
+struct deferred_reclamation_policy
+{
+    static constexpr bool deferred       = true;
+    static constexpr std::size_t budget = Budget;
+
+    /*!
+     * Returns the queue shared by all the containers using this
+     * policy.  It is intentionally leaked, such that containers with
+     * static storage duration can be safely destroyed at exit.
+     */
+    static reclamation_queue& queue()
+    {
+        static auto q = new reclamation_queue{};
+        return *q;
+    }
+};
+
+/*!
+ * Thread that drains a @ref reclamation_queue in the background, in
+ * slices of `slice` entries, until it is destroyed.  The queue is
+ * checked every `period` while it is empty.
+ */
+class reclamation_thread
+{
+public:
+    explicit reclamation_thread(
+        reclamation_queue& q,
+        std::size_t slice                = 256,
+        std::chrono::microseconds period = std::chrono::microseconds{500})
+        : thread_{[this, &q, slice, period] {
+            while (!done_.load(std::memory_order_acquire))
+                if (!q.drain(slice))
+                    std::this_thread::sleep_for(period);
+        }}
+    {}
+
+    reclamation_thread(const reclamation_thread&) = delete;
+    reclamation_thread& operator=(const reclamation_thread&) = delete;
+
+    ~reclamation_thread()
+    {
+        done_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+private:
+    std::atomic<bool> done_{false};
+    std::thread thread_;
+};
+
+} // namespace immer
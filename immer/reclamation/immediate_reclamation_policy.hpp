@@ -0,0 +1,44 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/type_traits.hpp>
+
+namespace immer {
+
+/*!
+ * Reclamation policy that frees the nodes of a container as soon as
+ * the last reference to them is dropped, recursively, in the thread
+ * that drops it.
+ */
+struct immediate_reclamation_policy
+{
+    static constexpr bool deferred = false;
+};
+
+namespace detail {
+
+template <typename MP, typename Enable = void>
+struct get_reclamation_policy
+{
+    using type = immediate_reclamation_policy;
+};
+
+template <typename MP>
+struct get_reclamation_policy<MP, void_t<typename MP::reclamation>>
+{
+    using type = typename MP::reclamation;
+};
+
+template <typename MP>
+using get_reclamation_policy_t = typename get_reclamation_policy<MP>::type;
+
+} // namespace detail
+
+} // namespace immer
@@ -0,0 +1,116 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace immer {
+
+/*!
+ * Queue of nodes that are no longer referenced and that still have to
+ * be freed, used by the @ref deferred_reclamation_policy.
+ *
+ * Every entry frees a single node, plus the leaves below it that are
+ * not referenced anymore, and enqueues the inner nodes below it that
+ * are not referenced anymore.  The entries are processed in last in,
+ * first out order, such that the queue stays proportional to the
+ * depth of the trees being freed.  It is safe to use from multiple
+ * threads.
+ *
+ * Room for `initial_capacity` entries is reserved up front.  When the
+ * queue is full and growing it fails, the entry is processed right
+ * away instead, such that releasing a container, which usually
+ * happens in a destructor, never fails.  Entries that are still
+ * pending when the queue is destroyed are leaked.
+ */
+class reclamation_queue
+{
+public:
+    using step_fn =
+        void (*)(reclamation_queue& q, void* node, std::size_t a, std::size_t b);
+
+    static constexpr std::size_t initial_capacity = 1024;
+
+    reclamation_queue() { entries_.reserve(initial_capacity); }
+    reclamation_queue(const reclamation_queue&) = delete;
+    reclamation_queue& operator=(const reclamation_queue&) = delete;
+
+    /*!
+     * Enqueues a call to `fn(*this, node, a, b)`, or does the call
+     * right away when there is no memory left to enqueue it.
+     */
+    void push(step_fn fn, void* node, std::size_t a = 0, std::size_t b = 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            IMMER_TRY {
+                entries_.push_back({fn, node, a, b});
+                return;
+            }
+            IMMER_CATCH (...) {}
+        }
+        fn(*this, node, a, b);
+    }
+
+    /*!
+     * Processes at most `max_steps` entries, and returns how many were
+     * processed.
+     */
+    std::size_t drain(std::size_t max_steps)
+    {
+        auto steps = std::size_t{};
+        for (; steps < max_steps; ++steps) {
+            auto e = entry{};
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (entries_.empty())
+                    break;
+                e = entries_.back();
+                entries_.pop_back();
+            }
+            e.fn(*this, e.node, e.a, e.b);
+        }
+        return steps;
+    }
+
+    /*!
+     * Processes entries until the queue is empty.
+     */
+    void drain_all()
+    {
+        while (drain(64)) {}
+    }
+
+    /*!
+     * Number of entries waiting to be processed.
+     */
+    std::size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return entries_.size();
+    }
+
+private:
+    struct entry
+    {
+        step_fn fn;
+        void* node;
+        std::size_t a;
+        std::size_t b;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<entry> entries_;
+};
+
+} // namespace immer
@@ -0,0 +1,151 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/refcount/no_refcount_policy.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace immer {
+
+/*!
+ * A reference counting policy that packs the count and the id of the
+ * transient that owns the object in a single *atomic* word.  It is
+ * **thread-safe**.
+ *
+ * @tparam Word Unsigned integer type of the word.
+ * @tparam OwnerBits Number of high bits of the word used for the
+ *         owner id.  The rest hold the count.
+ *
+ * @rst
+ *
+ * It is meant to be used together with
+ * :cpp:class:`immer::compact_transience_policy`, which is picked
+ * automatically by :cpp:class:`immer::memory_policy`.  The container
+ * nodes then keep both the reference count and the transient
+ * ownership in a header of ``sizeof(Word)`` bytes, instead of an
+ * ``int`` plus an owner pointer.
+ *
+ * Owner ids are small and thus reused after a while.  This is safe
+ * because sharing an object, which increments its count, also clears
+ * its owner: a transient never mutates an object that was shared
+ * after the transient took it, even if another transient got the
+ * same id in the meantime.
+ *
+ * .. warning:: The count saturates at ``2^(bits(Word) - OwnerBits) -
+ *    1`` references.  An object that reaches it, like the empty root
+ *    shared by millions of small containers, is never freed.
+ *
+ * @endrst
+ */
+template <typename Word, unsigned OwnerBits>
+struct basic_compact_refcount_policy
+{
+    static_assert(std::is_unsigned<Word>::value, "the word must be unsigned");
+    static_assert(OwnerBits > 0 && OwnerBits < sizeof(Word) * 8,
+                  "there must be room for both the owner and the count");
+
+    using word_t = Word;
+
+    static constexpr unsigned owner_bits = OwnerBits;
+    static constexpr unsigned count_bits = sizeof(Word) * 8 - OwnerBits;
+    static constexpr word_t count_mask   = (word_t{1} << count_bits) - 1;
+    static constexpr word_t owner_mask   = ~count_mask;
+    static constexpr word_t max_owner    = owner_mask >> count_bits;
+
+    /*!
+     * Identifies a transient, with `0` meaning none.
+     */
+    struct edit
+    {
+        word_t id;
+        bool operator==(edit x) const { return id == x.id; }
+        bool operator!=(edit x) const { return id != x.id; }
+    };
+
+    mutable std::atomic<word_t> word;
+
+    basic_compact_refcount_policy()
+        : word{1} {};
+    basic_compact_refcount_policy(disowned)
+        : word{0}
+    {}
+
+    // Incrementing also clears the owner.  The count sticks once it
+    // saturates, instead of carrying into the owner bits.
+    void inc()
+    {
+        auto w = word.load(std::memory_order_relaxed);
+        while ((w & count_mask) != count_mask &&
+               !word.compare_exchange_weak(
+                   w, (w + 1) & count_mask, std::memory_order_relaxed))
+            ;
+    }
+
+    bool dec()
+    {
+        auto w = word.load(std::memory_order_relaxed);
+        do {
+            if ((w & count_mask) == count_mask)
+                return false;
+        } while (!word.compare_exchange_weak(w,
+                                             w - 1,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+        return 1 == (w & count_mask);
+    }
+
+    bool saturated() const
+    {
+        return (word.load(std::memory_order_relaxed) & count_mask) ==
+               count_mask;
+    }
+
+    bool unique() { return (word & count_mask) == 1; }
+
+    basic_compact_refcount_policy& operator=(edit e)
+    {
+        assert(e.id <= max_owner);
+        auto count = word.load(std::memory_order_relaxed) & count_mask;
+        word.store(count | (e.id << count_bits), std::memory_order_relaxed);
+        return *this;
+    }
+
+    bool can_mutate(edit e) const
+    {
+        return e.id && owner() == e.id;
+    }
+
+    bool owned() const { return owner() != 0; }
+
+private:
+    word_t owner() const
+    {
+        return word.load(std::memory_order_relaxed) >> count_bits;
+    }
+};
+
+/*!
+ * Compact reference counting with a 32 bit word, that uses 8 bits for
+ * the owner and 24 bits for the count.
+ */
+using compact_refcount_policy =
+    basic_compact_refcount_policy<std::uint32_t, 8>;
+
+/*!
+ * Compact reference counting with a 64 bit word, that uses 16 bits
+ * for the owner and 48 bits for the count.
+ */
+using wide_compact_refcount_policy =
+    basic_compact_refcount_policy<std::uint64_t, 16>;
+
+} // namespace immer
@@ -0,0 +1,379 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/btrees/btree.hpp>
+#include <immer/detail/btrees/btree_iterator.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+namespace immer {
+
+template <typename K,
+          typename T,
+          typename Compare,
+          typename MemoryPolicy,
+          detail::btrees::bits_t B,
+          detail::btrees::bits_t BL>
+class sorted_map_transient;
+
+/*!
+ * Immutable ordered mapping of values from type `K` to type `T`.
+ *
+ * @tparam K    The type of the keys.
+ * @tparam T    The type of the values to be stored in the container.
+ * @tparam Compare The type of a function object defining a strict
+ *              weak ordering of values of type `K`.
+ * @tparam MemoryPolicy Memory management policy. See @ref
+ *              memory_policy.
+ *
+ * @rst
+ *
+ * This container is a persistent B+-tree.  Its inner nodes have up
+ * to :math:`2^B` children and its leaves store up to :math:`2^{BL}`
+ * associations contiguously and in order.  By default ``BL`` is
+ * chosen such that a leaf takes about as much memory as an inner
+ * node.  Compared to ``immer::map``, lookups and updates are
+ * logarithmic instead of *effectively* constant, but iteration
+ * follows the order of the keys and ranges of keys can be found with
+ * ``lower_bound`` and ``upper_bound``.
+ *
+ * @endrst
+ *
+ */
+template <typename K,
+          typename T,
+          typename Compare             = std::less<K>,
+          typename MemoryPolicy        = default_memory_policy,
+          detail::btrees::bits_t B     = default_bits,
+          detail::btrees::bits_t BL    = detail::btrees::
+              derive_bits_leaf<std::pair<K, T>, K, B>>
+class sorted_map
+{
+    using value_t = std::pair<K, T>;
+
+    using move_t =
+        std::integral_constant<bool, MemoryPolicy::use_transient_rvalues>;
+
+    struct key_of
+    {
+        const K& operator()(const value_t& v) const noexcept
+        {
+            return v.first;
+        }
+    };
+
+    struct equal_value
+    {
+        bool operator()(const value_t& a, const value_t& b) const
+        {
+            return !Compare{}(a.first, b.first) &&
+                   !Compare{}(b.first, a.first) && a.second == b.second;
+        }
+    };
+
+    using impl_t = detail::btrees::
+        btree<value_t, K, key_of, Compare, MemoryPolicy, B, BL>;
+
+public:
+    using key_type        = K;
+    using mapped_type     = T;
+    using value_type      = std::pair<K, T>;
+    using size_type       = detail::btrees::size_t;
+    using diference_type  = std::ptrdiff_t;
+    using key_compare     = Compare;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+
+    using iterator = detail::btrees::
+        btree_iterator<value_t, K, key_of, Compare, MemoryPolicy, B, BL>;
+    using const_iterator   = iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    using transient_type =
+        sorted_map_transient<K, T, Compare, MemoryPolicy, B, BL>;
+
+    using memory_policy_type = MemoryPolicy;
+
+    /*!
+     * Constructs a map containing the elements in `values`.
+     */
+    sorted_map(std::initializer_list<value_type> values)
+        : impl_{impl_t::from_initializer_list(values)}
+    {}
+
+    /*!
+     * Constructs a map containing the elements in the range
+     * defined by the input iterator `first` and range sentinel `last`.
+     */
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<detail::compatible_sentinel_v<Iter, Sent>,
+                               bool> = true>
+    sorted_map(Iter first, Sent last)
+        : impl_{impl_t::from_range(first, last)}
+    {}
+
+    /*!
+     * Default constructor.  It creates a map of `size() == 0`.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    sorted_map() = default;
+
+    /*!
+     * Returns an iterator pointing at the association with the
+     * smallest key. It does not allocate memory and its complexity is
+     * @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator begin() const { return {impl_}; }
+
+    /*!
+     * Returns an iterator pointing just after the association with the
+     * biggest key. It does not allocate and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator end() const
+    {
+        return {impl_, typename iterator::end_t{}};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing at the association with the biggest key.
+     */
+    IMMER_NODISCARD reverse_iterator rbegin() const
+    {
+        return reverse_iterator{end()};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing before the association with the smallest key.
+     */
+    IMMER_NODISCARD reverse_iterator rend() const
+    {
+        return reverse_iterator{begin()};
+    }
+
+    /*!
+     * Returns the number of elements in the container.  It does
+     * not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD size_type size() const { return impl_.size; }
+
+    /*!
+     * Returns `true` if there are no elements in the container.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD bool empty() const { return impl_.size == 0; }
+
+    /*!
+     * Returns `1` when the key `k` is contained in the map or `0`
+     * otherwise. It won't allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD size_type count(const K& k) const
+    {
+        return impl_.find(k) ? 1 : 0;
+    }
+
+    /*!
+     * Returns a `const` reference to the values associated to the key
+     * `k`.  If the key is not contained in the map, it returns a
+     * default constructed value.  It does not allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD const T& operator[](const K& k) const
+    {
+        static const T default_value{};
+        auto p = impl_.find(k);
+        return p ? p->second : default_value;
+    }
+
+    /*!
+     * Returns a `const` reference to the values associated to the key
+     * `k`.  If the key is not contained in the map, throws an
+     * `std::out_of_range` error.  It does not allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    const T& at(const K& k) const
+    {
+        auto p = impl_.find(k);
+        if (!p)
+            IMMER_THROW(std::out_of_range{"key not found"});
+        return p->second;
+    }
+
+    /*!
+     * Returns a pointer to the value associated with the key `k`.  If
+     * the key is not contained in the map, a `nullptr` is returned.
+     * It does not allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD const T* find(const K& k) const
+    {
+        auto p = impl_.find(k);
+        return p ? &p->second : nullptr;
+    }
+
+    /*!
+     * Returns an iterator pointing at the first association whose key
+     * is not less than `k`, or `end()` if there is none.  It does not
+     * allocate memory and its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator lower_bound(const K& k) const
+    {
+        return impl_.template bound<false>(k);
+    }
+
+    /*!
+     * Returns an iterator pointing at the first association whose key
+     * is greater than `k`, or `end()` if there is none.  It does not
+     * allocate memory and its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator upper_bound(const K& k) const
+    {
+        return impl_.template bound<true>(k);
+    }
+
+    /*!
+     * Returns whether the maps are equal.  Subtrees that are shared by
+     * both maps are not traversed.
+     */
+    IMMER_NODISCARD bool operator==(const sorted_map& other) const
+    {
+        return impl_.template equals<equal_value>(other.impl_);
+    }
+    IMMER_NODISCARD bool operator!=(const sorted_map& other) const
+    {
+        return !(*this == other);
+    }
+
+    /*!
+     * Returns a map containing the association `value`.  If the key is
+     * already in the map, it replaces its association in the map.
+     * It may allocate memory and its complexity is @f$ O(log(size))
+     * @f$.
+     */
+    IMMER_NODISCARD sorted_map insert(value_type value) const&
+    {
+        return impl_.add(std::move(value));
+    }
+    IMMER_NODISCARD decltype(auto) insert(value_type value) &&
+    {
+        return insert_move(move_t{}, std::move(value));
+    }
+
+    /*!
+     * Returns a map containing the association `(k, v)`.  If the key
+     * is already in the map, it replaces its association in the map.
+     * It may allocate memory and its complexity is @f$ O(log(size))
+     * @f$.
+     */
+    IMMER_NODISCARD sorted_map set(key_type k, mapped_type v) const&
+    {
+        return impl_.add({std::move(k), std::move(v)});
+    }
+    IMMER_NODISCARD decltype(auto) set(key_type k, mapped_type v) &&
+    {
+        return insert_move(move_t{}, {std::move(k), std::move(v)});
+    }
+
+    /*!
+     * Returns a map replacing the association `(k, v)` by the
+     * association new association `(k, fn(v))`, where `v` is the
+     * currently associated value for `k` in the map or a default
+     * constructed value otherwise. It may allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    template <typename Fn>
+    IMMER_NODISCARD sorted_map update(key_type k, Fn&& fn) const&
+    {
+        return impl_.add(updated(std::move(k), std::forward<Fn>(fn)));
+    }
+    template <typename Fn>
+    IMMER_NODISCARD decltype(auto) update(key_type k, Fn&& fn) &&
+    {
+        return insert_move(move_t{},
+                           updated(std::move(k), std::forward<Fn>(fn)));
+    }
+
+    /*!
+     * Returns a map without the key `k`.  If the key is not
+     * associated in the map it returns the same map.  It may allocate
+     * memory and its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD sorted_map erase(const K& k) const&
+    {
+        return impl_.sub(k);
+    }
+    IMMER_NODISCARD decltype(auto) erase(const K& k) &&
+    {
+        return erase_move(move_t{}, k);
+    }
+
+    /*!
+     * Returns a @a transient form of this container, an
+     * `immer::sorted_map_transient`.
+     */
+    IMMER_NODISCARD transient_type transient() const&
+    {
+        return transient_type{impl_};
+    }
+    IMMER_NODISCARD transient_type transient() &&
+    {
+        return transient_type{std::move(impl_)};
+    }
+
+    // Semi-private
+    const impl_t& impl() const { return impl_; }
+
+private:
+    friend transient_type;
+
+    template <typename Fn>
+    value_type updated(key_type k, Fn&& fn) const
+    {
+        auto p = impl_.find(k);
+        auto v = std::forward<Fn>(fn)(p ? p->second : mapped_type{});
+        return {std::move(k), std::move(v)};
+    }
+
+    sorted_map&& insert_move(std::true_type, value_type value)
+    {
+        impl_.insert_mut({}, std::move(value));
+        return std::move(*this);
+    }
+    sorted_map insert_move(std::false_type, value_type value)
+    {
+        return impl_.add(std::move(value));
+    }
+
+    sorted_map&& erase_move(std::true_type, const key_type& k)
+    {
+        impl_.erase_mut({}, k);
+        return std::move(*this);
+    }
+    sorted_map erase_move(std::false_type, const key_type& k)
+    {
+        return impl_.sub(k);
+    }
+
+    sorted_map(impl_t impl)
+        : impl_(std::move(impl))
+    {}
+
+    impl_t impl_;
+};
+
+} // namespace immer
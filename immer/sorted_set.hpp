@@ -0,0 +1,293 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/btrees/btree.hpp>
+#include <immer/detail/btrees/btree_iterator.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <functional>
+#include <iterator>
+
+namespace immer {
+
+template <typename T,
+          typename Compare,
+          typename MemoryPolicy,
+          detail::btrees::bits_t B,
+          detail::btrees::bits_t BL>
+class sorted_set_transient;
+
+/*!
+ * Immutable set of values kept in order.
+ *
+ * @tparam T    The type of the values to be stored in the container.
+ * @tparam Compare The type of a function object defining a strict
+ *              weak ordering of values of type `T`.
+ * @tparam MemoryPolicy Memory management policy. See @ref
+ *              memory_policy.
+ *
+ * @rst
+ *
+ * This container is a persistent B+-tree, like
+ * :cpp:class:`immer::sorted_map`.  Iteration follows the order of the
+ * values and ranges of values can be found with ``lower_bound`` and
+ * ``upper_bound``.
+ *
+ * @endrst
+ *
+ */
+template <typename T,
+          typename Compare          = std::less<T>,
+          typename MemoryPolicy     = default_memory_policy,
+          detail::btrees::bits_t B  = default_bits,
+          detail::btrees::bits_t BL = detail::btrees::derive_bits_leaf<T, T, B>>
+class sorted_set
+{
+    using move_t =
+        std::integral_constant<bool, MemoryPolicy::use_transient_rvalues>;
+
+    struct key_of
+    {
+        const T& operator()(const T& v) const noexcept { return v; }
+    };
+
+    struct equal_value
+    {
+        bool operator()(const T& a, const T& b) const
+        {
+            return !Compare{}(a, b) && !Compare{}(b, a);
+        }
+    };
+
+    using impl_t = detail::btrees::
+        btree<T, T, key_of, Compare, MemoryPolicy, B, BL>;
+
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using size_type       = detail::btrees::size_t;
+    using diference_type  = std::ptrdiff_t;
+    using key_compare     = Compare;
+    using value_compare   = Compare;
+    using reference       = const T&;
+    using const_reference = const T&;
+
+    using iterator = detail::btrees::
+        btree_iterator<T, T, key_of, Compare, MemoryPolicy, B, BL>;
+    using const_iterator   = iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    using transient_type =
+        sorted_set_transient<T, Compare, MemoryPolicy, B, BL>;
+
+    using memory_policy_type = MemoryPolicy;
+
+    /*!
+     * Default constructor.  It creates a set of `size() == 0`.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    sorted_set() = default;
+
+    /*!
+     * Constructs a set containing the elements in `values`.
+     */
+    sorted_set(std::initializer_list<value_type> values)
+        : impl_{impl_t::from_initializer_list(values)}
+    {}
+
+    /*!
+     * Constructs a set containing the elements in the range
+     * defined by the input iterator `first` and range sentinel `last`.
+     */
+    template <typename Iter,
+              typename Sent,
+              std::enable_if_t<detail::compatible_sentinel_v<Iter, Sent>,
+                               bool> = true>
+    sorted_set(Iter first, Sent last)
+        : impl_{impl_t::from_range(first, last)}
+    {}
+
+    /*!
+     * Returns an iterator pointing at the smallest element of the
+     * collection. It does not allocate memory and its complexity is
+     * @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator begin() const { return {impl_}; }
+
+    /*!
+     * Returns an iterator pointing just after the biggest element of
+     * the collection. It does not allocate and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator end() const
+    {
+        return {impl_, typename iterator::end_t{}};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing at the biggest element.
+     */
+    IMMER_NODISCARD reverse_iterator rbegin() const
+    {
+        return reverse_iterator{end()};
+    }
+
+    /*!
+     * Returns an iterator that traverses the collection backwards,
+     * pointing before the smallest element.
+     */
+    IMMER_NODISCARD reverse_iterator rend() const
+    {
+        return reverse_iterator{begin()};
+    }
+
+    /*!
+     * Returns the number of elements in the container.  It does
+     * not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD size_type size() const { return impl_.size; }
+
+    /*!
+     * Returns `true` if there are no elements in the container.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD bool empty() const { return impl_.size == 0; }
+
+    /*!
+     * Returns `1` when `value` is contained in the set or `0`
+     * otherwise. It won't allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD size_type count(const T& value) const
+    {
+        return impl_.find(value) ? 1 : 0;
+    }
+
+    /*!
+     * Returns a pointer to the value if `value` is contained in the
+     * set, or nullptr otherwise.  It does not allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD const T* find(const T& value) const
+    {
+        return impl_.find(value);
+    }
+
+    /*!
+     * Returns an iterator pointing at the first element that is not
+     * less than `value`, or `end()` if there is none.  It does not
+     * allocate memory and its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator lower_bound(const T& value) const
+    {
+        return impl_.template bound<false>(value);
+    }
+
+    /*!
+     * Returns an iterator pointing at the first element that is
+     * greater than `value`, or `end()` if there is none.  It does not
+     * allocate memory and its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator upper_bound(const T& value) const
+    {
+        return impl_.template bound<true>(value);
+    }
+
+    /*!
+     * Returns whether the sets are equal.  Subtrees that are shared by
+     * both sets are not traversed.
+     */
+    IMMER_NODISCARD bool operator==(const sorted_set& other) const
+    {
+        return impl_.template equals<equal_value>(other.impl_);
+    }
+    IMMER_NODISCARD bool operator!=(const sorted_set& other) const
+    {
+        return !(*this == other);
+    }
+
+    /*!
+     * Returns a set containing `value`.  If the `value` is already in
+     * the set, it returns the same set.  It may allocate memory and
+     * its complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD sorted_set insert(T value) const&
+    {
+        return impl_.find(value) ? impl_ : impl_.add(std::move(value));
+    }
+    IMMER_NODISCARD decltype(auto) insert(T value) &&
+    {
+        return insert_move(move_t{}, std::move(value));
+    }
+
+    /*!
+     * Returns a set without `value`.  If the `value` is not in the
+     * set it returns the same set.  It may allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD sorted_set erase(const T& value) const&
+    {
+        return impl_.sub(value);
+    }
+    IMMER_NODISCARD decltype(auto) erase(const T& value) &&
+    {
+        return erase_move(move_t{}, value);
+    }
+
+    /*!
+     * Returns an @a transient form of this container, a
+     * `immer::sorted_set_transient`.
+     */
+    IMMER_NODISCARD transient_type transient() const&
+    {
+        return transient_type{impl_};
+    }
+    IMMER_NODISCARD transient_type transient() &&
+    {
+        return transient_type{std::move(impl_)};
+    }
+
+    // Semi-private
+    const impl_t& impl() const { return impl_; }
+
+private:
+    friend transient_type;
+
+    sorted_set&& insert_move(std::true_type, value_type value)
+    {
+        if (!impl_.find(value))
+            impl_.insert_mut({}, std::move(value));
+        return std::move(*this);
+    }
+    sorted_set insert_move(std::false_type, value_type value)
+    {
+        return impl_.find(value) ? impl_ : impl_.add(std::move(value));
+    }
+
+    sorted_set&& erase_move(std::true_type, const value_type& value)
+    {
+        impl_.erase_mut({}, value);
+        return std::move(*this);
+    }
+    sorted_set erase_move(std::false_type, const value_type& value)
+    {
+        return impl_.sub(value);
+    }
+
+    sorted_set(impl_t impl)
+        : impl_(std::move(impl))
+    {}
+
+    impl_t impl_;
+};
+
+} // namespace immer
@@ -0,0 +1,160 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/detail/btrees/btree.hpp>
+#include <immer/memory_policy.hpp>
+
+#include <functional>
+
+namespace immer {
+
+template <typename T,
+          typename Compare,
+          typename MemoryPolicy,
+          detail::btrees::bits_t B,
+          detail::btrees::bits_t BL>
+class sorted_set;
+
+/*!
+ * Mutable version of `immer::sorted_set`.
+ *
+ * @rst
+ *
+ * Refer to :doc:`transients` to learn more about when and how to use
+ * the mutable versions of immutable containers.
+ *
+ * @endrst
+ */
+template <typename T,
+          typename Compare          = std::less<T>,
+          typename MemoryPolicy     = default_memory_policy,
+          detail::btrees::bits_t B  = default_bits,
+          detail::btrees::bits_t BL = detail::btrees::derive_bits_leaf<T, T, B>>
+class sorted_set_transient : MemoryPolicy::transience_t::owner
+{
+    using base_t  = typename MemoryPolicy::transience_t::owner;
+    using owner_t = base_t;
+
+public:
+    using persistent_type = sorted_set<T, Compare, MemoryPolicy, B, BL>;
+
+    using key_type        = T;
+    using value_type      = T;
+    using size_type       = detail::btrees::size_t;
+    using diference_type  = std::ptrdiff_t;
+    using key_compare     = Compare;
+    using value_compare   = Compare;
+    using reference       = const T&;
+    using const_reference = const T&;
+
+    using iterator         = typename persistent_type::iterator;
+    using const_iterator   = iterator;
+    using reverse_iterator = typename persistent_type::reverse_iterator;
+
+    /*!
+     * Default constructor.  It creates a set of `size() == 0`.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    sorted_set_transient() = default;
+
+    /*!
+     * Returns an iterator pointing at the smallest element of the
+     * collection. It does not allocate memory and its complexity is
+     * @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator begin() const { return {impl_}; }
+
+    /*!
+     * Returns an iterator pointing just after the biggest element of
+     * the collection. It does not allocate and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD iterator end() const
+    {
+        return {impl_, typename iterator::end_t{}};
+    }
+
+    /*!
+     * Returns the number of elements in the container.  It does
+     * not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD size_type size() const { return impl_.size; }
+
+    /*!
+     * Returns `true` if there are no elements in the container.  It
+     * does not allocate memory and its complexity is @f$ O(1) @f$.
+     */
+    IMMER_NODISCARD bool empty() const { return impl_.size == 0; }
+
+    /*!
+     * Returns `1` when `value` is contained in the set or `0`
+     * otherwise. It won't allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    IMMER_NODISCARD size_type count(const T& value) const
+    {
+        return impl_.find(value) ? 1 : 0;
+    }
+
+    /*!
+     * Returns a pointer to the value if `value` is contained in the
+     * set, or nullptr otherwise.  It does not allocate memory and its
+     * complexity is @f$ O(log(size)) @f$.
+     */
+    IMMER_NODISCARD const T* find(const T& value) const
+    {
+        return impl_.find(value);
+    }
+
+    /*!
+     * Inserts `value` in the set.  Does nothing if the value is
+     * already there.  It may allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    void insert(T value)
+    {
+        if (!impl_.find(value))
+            impl_.insert_mut(*this, std::move(value));
+    }
+
+    /*!
+     * Removes `value` from the set.  Does nothing if the value is not
+     * there.  It may allocate memory and its complexity is @f$
+     * O(log(size)) @f$.
+     */
+    void erase(const T& value) { impl_.erase_mut(*this, value); }
+
+    /*!
+     * Returns an @a immutable form of this container, an
+     * `immer::sorted_set`.
+     */
+    IMMER_NODISCARD persistent_type persistent() &
+    {
+        this->owner_t::operator=(owner_t{});
+        return impl_;
+    }
+    IMMER_NODISCARD persistent_type persistent() && { return std::move(impl_); }
+
+private:
+    friend persistent_type;
+    using impl_t = typename persistent_type::impl_t;
+
+    sorted_set_transient(impl_t impl)
+        : impl_(std::move(impl))
+    {}
+
+    impl_t impl_;
+
+public:
+    // Semi-private
+    const impl_t& impl() const { return impl_; }
+};
+
+} // namespace immer
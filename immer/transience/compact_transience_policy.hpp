@@ -0,0 +1,94 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <atomic>
+
+namespace immer {
+
+/*!
+ * Provides transience ownership tracking that is stored in the same
+ * word as the reference count, as provided by a @ref
+ * basic_compact_refcount_policy.
+ *
+ * @rst
+ *
+ * Every transient gets an id out of a global counter, which wraps
+ * around after ``RefcountPolicy::max_owner`` transients.  This is
+ * safe, see :cpp:class:`immer::basic_compact_refcount_policy`.  The
+ * *ownee* is the reference count itself, so the nodes do not need any
+ * extra room for it.
+ *
+ * @endrst
+ */
+template <typename RefcountPolicy>
+struct compact_transience_policy
+{
+    template <typename HeapPolicy>
+    struct apply
+    {
+        struct type
+        {
+            using word_t = typename RefcountPolicy::word_t;
+            using edit   = typename RefcountPolicy::edit;
+            using ownee  = RefcountPolicy;
+
+            struct owner
+            {
+                static word_t make_id_()
+                {
+                    static std::atomic<word_t> next{0};
+                    return next.fetch_add(1, std::memory_order_relaxed) %
+                               RefcountPolicy::max_owner +
+                           1;
+                }
+
+                mutable word_t id_;
+
+                operator edit() const { return {id_}; }
+
+                owner()
+                    : id_{make_id_()}
+                {}
+                explicit owner(word_t id)
+                    : id_{id}
+                {}
+                owner(const owner& o)
+                    : id_{make_id_()}
+                {
+                    o.id_ = make_id_();
+                }
+                owner(owner&& o) noexcept
+                    : id_{o.id_}
+                {}
+                owner& operator=(const owner& o)
+                {
+                    o.id_ = make_id_();
+                    id_   = make_id_();
+                    return *this;
+                }
+                owner& operator=(owner&& o) noexcept
+                {
+                    id_ = o.id_;
+                    return *this;
+                }
+            };
+
+            // Has id `0`, so it never owns anything.
+            static owner noone;
+        };
+    };
+};
+
+template <typename RP>
+template <typename HP>
+typename compact_transience_policy<RP>::template apply<HP>::type::owner
+    compact_transience_policy<RP>::apply<HP>::type::noone{0};
+
+} // namespace immer
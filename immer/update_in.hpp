@@ -0,0 +1,125 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/box.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace immer {
+namespace detail {
+
+template <typename T>
+struct is_box : std::false_type
+{};
+
+template <typename T, typename MP>
+struct is_box<box<T, MP>> : std::true_type
+{};
+
+template <typename T>
+std::decay_t<T> own(T&& x)
+{
+    return std::decay_t<T>(std::forward<T>(x));
+}
+
+template <typename C, typename Fn, typename K, typename... Ks>
+auto update_in_impl(C c, Fn& fn, K&& k, Ks&&... ks)
+    -> std::enable_if_t<is_box<C>::value, C>;
+
+template <typename C, typename Fn, typename K, typename... Ks>
+auto update_in_impl(C c, Fn& fn, K&& k, Ks&&... ks)
+    -> std::enable_if_t<!is_box<C>::value, C>;
+
+template <typename C, typename Fn>
+C update_in_impl(C c, Fn& fn)
+{
+    return fn(std::move(c));
+}
+
+template <typename C, typename Fn, typename K, typename... Ks>
+auto update_in_impl(C c, Fn& fn, K&& k, Ks&&... ks)
+    -> std::enable_if_t<is_box<C>::value, C>
+{
+    return std::move(c).update([&](auto&& v) {
+        return update_in_impl(own(std::forward<decltype(v)>(v)),
+                              fn,
+                              std::forward<K>(k),
+                              std::forward<Ks>(ks)...);
+    });
+}
+
+template <typename C, typename Fn, typename K, typename... Ks>
+auto update_in_impl(C c, Fn& fn, K&& k, Ks&&... ks)
+    -> std::enable_if_t<!is_box<C>::value, C>
+{
+    return std::move(c).update(std::forward<K>(k), [&](auto&& v) {
+        return update_in_impl(
+            own(std::forward<decltype(v)>(v)), fn, std::forward<Ks>(ks)...);
+    });
+}
+
+template <typename C, typename Args, std::size_t... Is>
+C update_in_apply(C c, Args&& args, std::index_sequence<Is...>)
+{
+    constexpr auto last = std::tuple_size<std::decay_t<Args>>::value - 1;
+    return update_in_impl(
+        std::move(c), std::get<last>(args), std::get<Is>(std::move(args))...);
+}
+
+} // namespace detail
+
+/*!
+ * @defgroup update-in
+ * @{
+ */
+
+/*!
+ * Returns `c` with the result of `fn(x)` in place of the value `x`
+ * that is reached by following the `path...` of keys or indices,
+ * which is passed in as all the arguments but the last one.  Every
+ * level has to provide an `update(key, fn)` method, like the maps and
+ * vectors do.  Boxes in the middle of the path are traversed
+ * transparently, without consuming a key.
+ *
+ * The container is taken by value, so passing in an r-value lets
+ * every level that is not shared with anybody else be updated in
+ * place.  The levels that are shared are copied, as any other update
+ * would do.
+ *
+ * @rst
+ *
+ * **Example**
+ *   .. code-block:: c++
+ *
+ *      using users_t = immer::map<std::string,
+ *                                 immer::box<immer::vector<int>>>;
+ *      auto users = users_t{};
+ *      // ...
+ *      users = immer::update_in(std::move(users), "peter", 3,
+ *                               [](int x) { return x + 1; });
+ *
+ * @endrst
+ */
+template <typename C, typename... PathAndFn>
+C update_in(C c, PathAndFn&&... path_and_fn)
+{
+    static_assert(sizeof...(PathAndFn) > 0, "the update function is missing");
+    return detail::update_in_apply(
+        std::move(c),
+        std::forward_as_tuple(std::forward<PathAndFn>(path_and_fn)...),
+        std::make_index_sequence<sizeof...(PathAndFn) - 1>{});
+}
+
+/*! @} */
+
+} // namespace immer
@@ -45,7 +45,9 @@ class vector_transient;
  * so by storing the data in contiguous chunks of :math:`2^{BL}`
  * elements.  By default, when ``sizeof(T) == sizeof(void*)`` then
  * :math:`B=BL=5`, such that data would be stored in contiguous
- * chunks of :math:`32` elements.
+ * chunks of :math:`32` elements.  Use
+ * :cpp:var:`immer::bits_leaf_for_bytes` to derive ``BL`` from a
+ * desired leaf size in bytes instead.
  *
  * You may learn more about the meaning and implications of ``B`` and
  * ``BL`` parameters in the :doc:`implementation` section.
@@ -0,0 +1,291 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#pragma once
+
+#include <immer/config.hpp>
+#include <immer/detail/type_traits.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace immer {
+namespace views {
+
+template <typename Source, typename Stage>
+class view;
+
+namespace detail {
+
+struct chunk_probe_fn
+{
+    template <typename T>
+    bool operator()(const T*, const T*) const
+    {
+        return true;
+    }
+};
+
+template <typename Range, typename = void>
+struct has_chunks : std::false_type
+{};
+
+template <typename Range>
+struct has_chunks<Range,
+                  immer::detail::void_t<decltype(
+                      std::declval<const Range&>().impl().for_each_chunk_p(
+                          chunk_probe_fn{}))>> : std::true_type
+{};
+
+template <typename Source, typename Stage, typename Sink>
+bool for_each_p(const view<Source, Stage>& v, Sink&& sink)
+{
+    return v.for_each_p(sink);
+}
+
+template <typename Range,
+          typename Sink,
+          std::enable_if_t<has_chunks<Range>::value, bool> = true>
+bool for_each_p(const Range& r, Sink&& sink)
+{
+    return r.impl().for_each_chunk_p([&](auto first, auto last) {
+        for (; first != last; ++first)
+            if (!sink(*first))
+                return false;
+        return true;
+    });
+}
+
+template <typename Range,
+          typename Sink,
+          std::enable_if_t<!has_chunks<Range>::value, bool> = true>
+bool for_each_p(const Range& r, Sink&& sink)
+{
+    for (auto&& x : r)
+        if (!sink(x))
+            return false;
+    return true;
+}
+
+template <typename Transient, typename T>
+auto put(Transient& t, T&& x, int)
+    -> decltype(t.push_back(std::forward<T>(x)), void())
+{
+    t.push_back(std::forward<T>(x));
+}
+
+template <typename Transient, typename T>
+void put(Transient& t, T&& x, long)
+{
+    t.insert(std::forward<T>(x));
+}
+
+template <typename Pred>
+struct filter_stage
+{
+    Pred pred;
+
+    template <typename Sink>
+    auto wrap(Sink& sink) const
+    {
+        return [this, &sink](auto&& x) {
+            return !pred(x) || sink(std::forward<decltype(x)>(x));
+        };
+    }
+};
+
+template <typename Fn>
+struct transform_stage
+{
+    Fn fn;
+
+    template <typename Sink>
+    auto wrap(Sink& sink) const
+    {
+        return [this, &sink](auto&& x) {
+            return sink(fn(std::forward<decltype(x)>(x)));
+        };
+    }
+};
+
+template <typename Pred>
+struct take_while_stage
+{
+    Pred pred;
+
+    template <typename Sink>
+    auto wrap(Sink& sink) const
+    {
+        return [this, &sink](auto&& x) {
+            return pred(x) && sink(std::forward<decltype(x)>(x));
+        };
+    }
+};
+
+template <typename Container, typename Range>
+Container into(const Range& r)
+{
+    auto t = Container{}.transient();
+    for_each_p(r, [&](auto&& x) {
+        put(t, std::forward<decltype(x)>(x), 0);
+        return true;
+    });
+    return std::move(t).persistent();
+}
+
+} // namespace detail
+
+/**
+ * @defgroup views
+ * @{
+ */
+
+/*!
+ * A lazy sequence of operations over the elements of a container,
+ * which are only performed when the result is collected with
+ * `into()`.  Views are created with `filter()`, `transform()` and
+ * `take_while()`.
+ *
+ * @rst
+ *
+ * All the stages of a view are fused into a single function that is
+ * called once per element of the source.  When the source is a
+ * ``vector``, ``flex_vector`` or ``array``, the elements are visited
+ * leaf by leaf with ``for_each_chunk_p``, avoiding the cost of the
+ * iterators.  The result is written through a transient of the
+ * destination container, so no intermediate containers are created.
+ *
+ * The source is held by value, which is cheap for immutable
+ * containers.  The functions of the stages must be callable when
+ * ``const``.
+ *
+ * **Example**
+ *   .. code-block:: c++
+ *
+ *      auto v = immer::flex_vector<int>{1, 2, 3, 4, 5, 6};
+ *      auto r = immer::views::filter(v, [](int x) { return x % 2; })
+ *                   .transform([](int x) { return x * 10; })
+ *                   .into<immer::vector<int>>();
+ *      assert(r == immer::vector<int>{10, 30, 50});
+ *
+ * @endrst
+ */
+template <typename Source, typename Stage>
+class view
+{
+public:
+    view(Source source, Stage stage)
+        : source_{std::move(source)}
+        , stage_{std::move(stage)}
+    {}
+
+    /*!
+     * Calls `fn` with every element of the view, in order, until it
+     * returns `false`.  Returns `false` if it was stopped, either by
+     * `fn` or by a `take_while()` stage.
+     */
+    template <typename Fn>
+    bool for_each_p(Fn&& fn) const
+    {
+        auto sink = stage_.wrap(fn);
+        return detail::for_each_p(source_, sink);
+    }
+
+    /*!
+     * Returns a view with only the elements for which `pred` is true.
+     */
+    template <typename Pred>
+    auto filter(Pred pred) const
+    {
+        return view<view, detail::filter_stage<Pred>>{*this,
+                                                      {std::move(pred)}};
+    }
+
+    /*!
+     * Returns a view where every element is replaced by `fn(element)`.
+     */
+    template <typename Fn>
+    auto transform(Fn fn) const
+    {
+        return view<view, detail::transform_stage<Fn>>{*this, {std::move(fn)}};
+    }
+
+    /*!
+     * Returns a view that stops at the first element for which `pred`
+     * is false.
+     */
+    template <typename Pred>
+    auto take_while(Pred pred) const
+    {
+        return view<view, detail::take_while_stage<Pred>>{*this,
+                                                          {std::move(pred)}};
+    }
+
+    /*!
+     * Returns a new `Container` with the elements of the view.
+     * Elements are added with `push_back()` when the container is a
+     * sequence and with `insert()` otherwise.
+     */
+    template <typename Container>
+    IMMER_NODISCARD Container into() const
+    {
+        return detail::into<Container>(*this);
+    }
+
+private:
+    Source source_;
+    Stage stage_;
+};
+
+/*!
+ * Returns a view with only the elements of `r` for which `pred` is
+ * true.
+ */
+template <typename Range, typename Pred>
+auto filter(Range&& r, Pred pred)
+{
+    return view<std::decay_t<Range>, detail::filter_stage<Pred>>{
+        std::forward<Range>(r), {std::move(pred)}};
+}
+
+/*!
+ * Returns a view where every element of `r` is replaced by
+ * `fn(element)`.
+ */
+template <typename Range, typename Fn>
+auto transform(Range&& r, Fn fn)
+{
+    return view<std::decay_t<Range>, detail::transform_stage<Fn>>{
+        std::forward<Range>(r), {std::move(fn)}};
+}
+
+/*!
+ * Returns a view with the elements of `r` up to the first one for
+ * which `pred` is false.
+ */
+template <typename Range, typename Pred>
+auto take_while(Range&& r, Pred pred)
+{
+    return view<std::decay_t<Range>, detail::take_while_stage<Pred>>{
+        std::forward<Range>(r), {std::move(pred)}};
+}
+
+/*!
+ * Returns a new `Container` with the elements of `r`, which may be a
+ * view or a container.
+ */
+template <typename Container, typename Range>
+IMMER_NODISCARD Container into(const Range& r)
+{
+    return detail::into<Container>(r);
+}
+
+/** @} */ // group: views
+
+} // namespace views
+} // namespace immer
@@ -0,0 +1,16 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/adaptive_array.hpp>
+
+template <typename T>
+using test_adaptive_array_t =
+    immer::adaptive_array<T, immer::default_memory_policy, 8, 3, 2>;
+
+#define VECTOR_T test_adaptive_array_t
+#include "../vector/generic.ipp"
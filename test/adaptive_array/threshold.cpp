@@ -0,0 +1,171 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/adaptive_array.hpp>
+#include <immer/algorithm.hpp>
+
+#include <catch.hpp>
+
+#include <numeric>
+#include <vector>
+
+namespace {
+
+template <typename MP>
+using array_t = immer::adaptive_array<unsigned, MP, 16, 2, 2>;
+
+using refcount_memory = immer::default_memory_policy;
+using basic_memory    = immer::memory_policy<immer::default_heap_policy,
+                                          immer::refcount_policy,
+                                          immer::default_lock_policy,
+                                          immer::no_transience_policy,
+                                          false,
+                                          false>;
+
+template <typename V>
+V make(unsigned n)
+{
+    auto v = V{};
+    for (auto i = 0u; i < n; ++i)
+        v = v.push_back(i);
+    return v;
+}
+
+template <typename V>
+void check_contents(const V& v, unsigned n)
+{
+    CHECK(v.size() == n);
+    for (auto i = 0u; i < n; ++i)
+        CHECK(v[i] == i);
+    auto expected = std::vector<unsigned>(n);
+    std::iota(expected.begin(), expected.end(), 0u);
+    CHECK(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    CHECK(immer::accumulate(v, 0u) ==
+          std::accumulate(expected.begin(), expected.end(), 0u));
+}
+
+template <typename V>
+void check_threshold()
+{
+    SECTION("stays flat up to the threshold")
+    {
+        auto v = make<V>(16);
+        CHECK(v.is_flat());
+        CHECK(v.data() != nullptr);
+        CHECK(v.data()[15] == 15u);
+        check_contents(v, 16);
+    }
+
+    SECTION("becomes a tree above the threshold")
+    {
+        auto v = make<V>(17);
+        CHECK(!v.is_flat());
+        CHECK(v.data() == nullptr);
+        check_contents(v, 17);
+
+        auto w = make<V>(100);
+        CHECK(!w.is_flat());
+        check_contents(w, 100);
+    }
+
+    SECTION("construction picks the representation")
+    {
+        auto n = std::vector<unsigned>(100);
+        std::iota(n.begin(), n.end(), 0u);
+        CHECK(V(n.begin(), n.begin() + 16).is_flat());
+        CHECK(!V(n.begin(), n.end()).is_flat());
+        CHECK(!V(17, 0u).is_flat());
+        check_contents(V(n.begin(), n.end()), 100);
+    }
+
+    SECTION("updates in tree mode do not touch the old version")
+    {
+        auto v = make<V>(100);
+        auto w = v.set(50, 0u).update(99, [](auto x) { return x + 1; });
+        CHECK(v[50] == 50u);
+        CHECK(v[99] == 99u);
+        CHECK(w[50] == 0u);
+        CHECK(w[99] == 100u);
+        CHECK(!w.is_flat());
+    }
+
+    SECTION("goes back to flat at half the threshold")
+    {
+        auto v = make<V>(100);
+        auto a = v.take(9);
+        CHECK(!a.is_flat());
+        check_contents(a, 9);
+        auto b = v.take(8);
+        CHECK(b.is_flat());
+        check_contents(b, 8);
+        auto c = a.push_back(9u);
+        CHECK(!c.is_flat());
+        check_contents(c, 10);
+        check_contents(v, 100);
+    }
+
+    SECTION("r-values")
+    {
+        auto v = V{};
+        for (auto i = 0u; i < 100; ++i)
+            v = std::move(v).push_back(i);
+        check_contents(v, 100);
+        v = std::move(v).set(3, 3u).update(4, [](auto x) { return x; });
+        check_contents(v, 100);
+        v = std::move(v).take(20);
+        CHECK(!v.is_flat());
+        check_contents(v, 20);
+        v = std::move(v).take(5);
+        CHECK(v.is_flat());
+        check_contents(v, 5);
+    }
+
+    SECTION("equality across representations")
+    {
+        auto flat = make<V>(8);
+        auto tree = make<V>(100).take(9).take(8);
+        CHECK(flat.is_flat());
+        CHECK(tree.is_flat());
+        auto big = make<V>(100).take(12);
+        auto big_flat =
+            V(make<V>(12).begin(), make<V>(12).end()).push_back(0u).take(12);
+        CHECK(!big.is_flat());
+        CHECK(big_flat.is_flat());
+        CHECK(big == big_flat);
+        CHECK(big_flat == big);
+        CHECK(big != big_flat.set(0, 42u));
+        CHECK(big.set(11, 42u) != big_flat);
+    }
+}
+
+} // namespace
+
+TEST_CASE("crossing the threshold")
+{
+    check_threshold<array_t<refcount_memory>>();
+}
+
+TEST_CASE("crossing the threshold without transient r-values")
+{
+    check_threshold<array_t<basic_memory>>();
+}
+
+TEST_CASE("iterating in tree mode")
+{
+    auto v = make<array_t<refcount_memory>>(100);
+    auto i = v.begin() + 50;
+    CHECK(*i == 50u);
+    CHECK(*(i - 40) == 10u);
+    CHECK(v.end() - v.begin() == 100);
+    CHECK(*v.rbegin() == 99u);
+    auto sum = 0u;
+    immer::for_each_chunk(v.begin() + 10, v.begin() + 20, [&](auto f, auto l) {
+        sum += std::accumulate(f, l, 0u);
+    });
+    CHECK(sum == 145u);
+}
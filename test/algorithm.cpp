@@ -9,6 +9,9 @@
 
 #include <catch.hpp>
 
+#include <numeric>
+#include <string>
+
 struct thing
 {
     int id = 0;
@@ -219,3 +222,79 @@ TEST_CASE("update_if_exists maps move")
     do_check(immer::map<int, int>{});
     do_check(immer::table<thing>{});
 }
+
+TEST_CASE("sum")
+{
+    auto do_check = [](auto v) {
+        using value_t = typename decltype(v)::value_type;
+        for (auto i = 0; i < 666; ++i)
+            v = std::move(v).push_back(value_t(i));
+        CHECK(immer::sum(v) == value_t(665 * 666 / 2));
+        CHECK(immer::sum(v.begin() + 10, v.end() - 10) ==
+              value_t(655 * 656 / 2 - 45));
+        CHECK(immer::sum(v.begin(), v.begin()) == value_t{});
+    };
+
+    do_check(immer::vector<int>{});
+    do_check(immer::flex_vector<long>{});
+    do_check(immer::array<unsigned>{});
+    do_check(immer::flex_vector<double>{});
+}
+
+TEST_CASE("min_max")
+{
+    auto v = immer::flex_vector<int>{};
+    for (auto i = 0; i < 1000; ++i)
+        v = std::move(v).push_back((i * 7919) % 1009 - 500);
+    auto expected = std::minmax_element(v.begin(), v.end());
+    CHECK(immer::min_max(v) ==
+          std::make_pair(*expected.first, *expected.second));
+
+    auto sub          = v.drop(3).take(50);
+    auto expected_sub = std::minmax_element(sub.begin(), sub.end());
+    CHECK(immer::min_max(sub.begin(), sub.end()) ==
+          std::make_pair(*expected_sub.first, *expected_sub.second));
+
+    auto single = immer::vector<int>{42};
+    CHECK(immer::min_max(single) == std::make_pair(42, 42));
+}
+
+TEST_CASE("dot")
+{
+    auto a = immer::flex_vector<int>{};
+    auto b = immer::flex_vector<int>{};
+    for (auto i = 0; i < 500; ++i) {
+        a = std::move(a).push_back(i);
+        b = std::move(b).push_front(i);
+    }
+    // make the chunks of both vectors not be aligned
+    b = b.drop(7) + b.take(7);
+    auto expected = std::inner_product(a.begin(), a.end(), b.begin(), 0);
+    CHECK(immer::dot(a, b) == expected);
+    CHECK(immer::dot(b, a) == expected);
+
+    auto arr = immer::array<int>(a.begin(), a.end());
+    CHECK(immer::dot(arr, b) == expected);
+    CHECK(immer::dot(immer::vector<double>{}, immer::vector<double>{}) == 0);
+}
+
+TEST_CASE("transform_reduce")
+{
+    auto v = immer::flex_vector<int>{};
+    for (auto i = 0; i < 333; ++i)
+        v = std::move(v).push_back(i);
+    auto sq = [](int x) { return x * x; };
+    auto expected =
+        std::accumulate(v.begin(), v.end(), 0, [&](int acc, int x) {
+            return acc + sq(x);
+        });
+    CHECK(immer::transform_reduce(v, 0, std::plus<int>{}, sq) == expected);
+    CHECK(immer::transform_reduce(
+              v.begin() + 1, v.end(), 0, std::plus<int>{}, sq) == expected);
+
+    auto strs = immer::transform_reduce(
+        v.take(20), std::string{}, std::plus<std::string>{}, [](int x) {
+            return std::to_string(x % 10);
+        });
+    CHECK(strs == "01234567890123456789");
+}
@@ -0,0 +1,132 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+
+#include <catch.hpp>
+
+#include <memory>
+#include <string>
+
+namespace {
+
+template <typename Growth>
+using growth_memory = immer::memory_policy<immer::default_heap_policy,
+                                           immer::default_refcount_policy,
+                                           immer::default_lock_policy,
+                                           immer::no_transience_policy,
+                                           false,
+                                           true,
+                                           false,
+                                           Growth>;
+
+} // namespace
+
+TEST_CASE("reserve")
+{
+    auto t = immer::array_transient<int>{};
+    t.reserve(100);
+    CHECK(t.capacity() == 100);
+    auto data = t.data();
+    for (auto i = 0; i < 100; ++i)
+        t.push_back(i);
+    CHECK(t.data() == data);
+    CHECK(t.capacity() == 100);
+
+    SECTION("does not shrink")
+    {
+        t.reserve(10);
+        CHECK(t.capacity() == 100);
+        CHECK(t.data() == data);
+    }
+
+    SECTION("keeps the persistent copies untouched")
+    {
+        auto p = t.persistent();
+        t.reserve(200);
+        CHECK(t.capacity() == 200);
+        CHECK(t.data() != p.data());
+        CHECK(p.size() == 100);
+        CHECK(p[99] == 99);
+        CHECK(t[99] == 99);
+    }
+}
+
+TEST_CASE("shrink to fit")
+{
+    auto t = immer::array_transient<std::string>{};
+    for (auto i = 0; i < 33; ++i)
+        t.push_back(std::to_string(i));
+    CHECK(t.capacity() > t.size());
+
+    t.shrink_to_fit();
+    CHECK(t.capacity() == 33);
+    CHECK(t[32] == "32");
+
+    auto p = t.persistent();
+    CHECK(p.size() == 33);
+    CHECK(p[0] == "0");
+
+    t.take(0);
+    t.shrink_to_fit();
+    CHECK(t.size() == 0);
+    CHECK(p.size() == 33);
+}
+
+TEST_CASE("take destroys the dropped elements")
+{
+    auto x = std::make_shared<int>(42);
+    auto t = immer::array_transient<std::shared_ptr<int>>{};
+    t.push_back(nullptr);
+    t.push_back(x);
+    CHECK(x.use_count() == 2);
+    t.take(1);
+    CHECK(x.use_count() == 1);
+}
+
+TEST_CASE("growth policy")
+{
+    SECTION("exact")
+    {
+        auto t = immer::array_transient<
+            int,
+            growth_memory<immer::factor_growth_policy<1>>>{};
+        for (auto i = 0; i < 10; ++i) {
+            t.push_back(i);
+            CHECK(t.capacity() == t.size());
+        }
+    }
+
+    SECTION("one and a half")
+    {
+        auto t = immer::array_transient<
+            int,
+            growth_memory<immer::factor_growth_policy<3, 2>>>{};
+        t.reserve(10);
+        for (auto i = 0; i < 11; ++i)
+            t.push_back(i);
+        CHECK(t.capacity() == 15);
+    }
+
+    SECTION("r-value push back reuses the capacity")
+    {
+        using array_t =
+            immer::array<int, growth_memory<immer::factor_growth_policy<>>>;
+        auto v    = array_t{};
+        auto data = v.data();
+        auto reallocations = 0;
+        for (auto i = 0; i < 1000; ++i) {
+            v = std::move(v).push_back(i);
+            reallocations += v.data() != data;
+            data = v.data();
+        }
+        CHECK(reallocations == 11);
+        CHECK(v[999] == 999);
+    }
+}
@@ -0,0 +1,24 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/atom.hpp>
+
+using inline_memory = immer::memory_policy<
+    immer::default_heap_policy,
+    immer::default_refcount_policy,
+    immer::default_lock_policy,
+    immer::get_transience_policy_t<immer::default_refcount_policy>,
+    immer::get_prefer_fewer_bigger_objects_v<immer::default_heap_policy>,
+    immer::get_use_transient_rvalues_v<immer::default_refcount_policy>,
+    true>;
+
+template <typename T>
+using test_atom_t = immer::atom<T, inline_memory>;
+
+#define ATOM_T test_atom_t
+#include "generic.ipp"
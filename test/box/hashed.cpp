@@ -0,0 +1,151 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/hashed_box.hpp>
+#include <immer/set.hpp>
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct counting_hash
+{
+    static unsigned count;
+
+    std::size_t operator()(const std::string& x) const
+    {
+        ++count;
+        return std::hash<std::string>{}(x);
+    }
+};
+
+unsigned counting_hash::count = 0;
+
+struct compared
+{
+    static unsigned count;
+
+    int value;
+
+    bool operator==(const compared& other) const
+    {
+        ++count;
+        return value == other.value;
+    }
+    bool operator!=(const compared& other) const
+    {
+        ++count;
+        return value != other.value;
+    }
+};
+
+unsigned compared::count = 0;
+
+struct compared_hash
+{
+    std::size_t operator()(const compared& x) const { return x.value; }
+};
+
+} // namespace
+
+using box_t = immer::hashed_box<std::string, counting_hash>;
+
+TEST_CASE("construction and copy")
+{
+    counting_hash::count = 0;
+
+    auto x = box_t{};
+    CHECK(x == "");
+    CHECK(x.hash() == std::hash<std::string>{}(""));
+
+    auto y = x;
+    CHECK(&x.get() == &y.get());
+
+    auto z = std::move(x);
+    CHECK(&z.get() == &y.get());
+    CHECK(counting_hash::count == 1);
+}
+
+TEST_CASE("hash is cached")
+{
+    counting_hash::count = 0;
+
+    auto x = box_t{"foo"};
+    auto y = box_t{std::string(3, 'a')};
+    CHECK(counting_hash::count == 2);
+    CHECK(std::hash<box_t>{}(x) == std::hash<std::string>{}("foo"));
+    CHECK(std::hash<box_t>{}(x) == std::hash<box_t>{}(x));
+    CHECK(std::hash<box_t>{}(y) == std::hash<std::string>{}("aaa"));
+    CHECK(counting_hash::count == 2);
+}
+
+TEST_CASE("equality")
+{
+    auto x = box_t{"foo"};
+    auto y = x;
+    CHECK(x == "foo");
+    CHECK("foo" == x);
+    CHECK(x == y);
+    CHECK(x == box_t{"foo"});
+    CHECK(x != box_t{"bar"});
+    CHECK(box_t{"bar"} < x);
+    CHECK("bar" < x);
+}
+
+TEST_CASE("equality compares hashes first")
+{
+    using cbox_t = immer::hashed_box<compared, compared_hash>;
+    compared::count = 0;
+
+    auto x = cbox_t{compared{1}};
+    auto y = cbox_t{compared{2}};
+    auto z = cbox_t{compared{1}};
+    CHECK(!(x == y));
+    CHECK(x != y);
+    CHECK(compared::count == 0);
+    CHECK(x == z);
+    CHECK(compared::count == 1);
+}
+
+TEST_CASE("update")
+{
+    auto x = box_t{"foo"};
+    auto y = x.update([](auto v) { return v + "bar"; });
+    CHECK(x == "foo");
+    CHECK(y == "foobar");
+    CHECK(y.hash() == std::hash<std::string>{}("foobar"));
+}
+
+TEST_CASE("update move")
+{
+    auto x    = box_t{"foo"};
+    auto addr = &x.get();
+    auto y    = std::move(x).update([](auto&& v) { return v + "bar"; });
+    CHECK(y == "foobar");
+    CHECK(y.hash() == std::hash<std::string>{}("foobar"));
+    CHECK(&y.get() == addr);
+}
+
+TEST_CASE("keys of a set")
+{
+    counting_hash::count = 0;
+
+    auto keys = std::vector<box_t>{};
+    for (auto i = 0; i < 100; ++i)
+        keys.push_back(std::to_string(i) + std::string(100, 'x'));
+    auto s = immer::set<box_t>{};
+    for (auto& k : keys)
+        s = std::move(s).insert(k);
+    for (auto& k : keys)
+        CHECK(s.count(k));
+    CHECK(s.size() == 100);
+    CHECK(counting_hash::count == 100);
+}
@@ -0,0 +1,104 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/box.hpp>
+#include <immer/map.hpp>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <string>
+
+using inline_memory = immer::memory_policy<
+    immer::default_heap_policy,
+    immer::default_refcount_policy,
+    immer::default_lock_policy,
+    immer::get_transience_policy_t<immer::default_refcount_policy>,
+    immer::get_prefer_fewer_bigger_objects_v<immer::default_heap_policy>,
+    immer::get_use_transient_rvalues_v<immer::default_refcount_policy>,
+    true>;
+
+template <typename T>
+using inline_box_t = immer::box<T, inline_memory>;
+
+static_assert(sizeof(inline_box_t<std::int64_t>) == sizeof(std::int64_t), "");
+static_assert(sizeof(inline_box_t<char>) == sizeof(char), "");
+static_assert(sizeof(inline_box_t<std::string>) == sizeof(void*), "");
+static_assert(sizeof(immer::box<std::int64_t>) == sizeof(void*), "");
+
+namespace {
+
+struct padded
+{
+    char c;
+    short s;
+};
+
+} // namespace
+
+// Padding bytes may differ between equal copies, which would break the
+// bitwise comparison in atom::update(), so these are never inlined
+static_assert(sizeof(padded) < sizeof(void*), "");
+static_assert(sizeof(inline_box_t<padded>) == sizeof(void*), "");
+
+TEST_CASE("construction and copy")
+{
+    auto x = inline_box_t<std::int64_t>{};
+    CHECK(x == 0);
+
+    auto y = x;
+    CHECK(y == 0);
+    CHECK(&x.get() != &y.get());
+
+    auto z = std::move(x);
+    CHECK(z == 0);
+}
+
+TEST_CASE("equality")
+{
+    auto x = inline_box_t<int>{};
+    auto y = x;
+    CHECK(x == 0.0f);
+    CHECK(x == y);
+    CHECK(x == inline_box_t<int>{});
+    CHECK(x != inline_box_t<int>{42});
+    CHECK(x < inline_box_t<int>{42});
+}
+
+TEST_CASE("update")
+{
+    auto x = inline_box_t<int>{};
+    auto y = x.update([](auto v) { return v + 1; });
+    CHECK(x == 0);
+    CHECK(y == 1);
+
+    auto z = std::move(y).update([](auto v) { return v * 42; });
+    CHECK(z == 42);
+}
+
+TEST_CASE("big values are still boxed")
+{
+    auto x = inline_box_t<std::string>{"foo"};
+    auto y = x;
+    CHECK(&x.get() == &y.get());
+    CHECK(std::move(y).update([](auto v) { return v + "bar"; }) == "foobar");
+    CHECK(x == "foo");
+}
+
+TEST_CASE("values in a map")
+{
+    using metric_t = inline_box_t<std::int64_t>;
+    auto m         = immer::map<int, metric_t>{};
+    for (auto i = 0; i < 100; ++i)
+        m = std::move(m).set(i, metric_t{i * 2});
+    for (auto i = 0; i < 100; ++i)
+        m = std::move(m).update(i, [](auto v) { return v.get() + 1; });
+    CHECK(m.size() == 100);
+    for (auto i = 0; i < 100; ++i)
+        CHECK(m[i] == i * 2 + 1);
+}
@@ -0,0 +1,170 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/interned_box.hpp>
+#include <immer/vector.hpp>
+
+#include <catch.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct tracked
+{
+    static int alive;
+
+    int value;
+
+    tracked(int v)
+        : value{v}
+    {
+        ++alive;
+    }
+    tracked(const tracked& other)
+        : value{other.value}
+    {
+        ++alive;
+    }
+    tracked(tracked&& other)
+        : value{other.value}
+    {
+        ++alive;
+    }
+    ~tracked() { --alive; }
+
+    bool operator==(const tracked& other) const { return value == other.value; }
+};
+
+int tracked::alive = 0;
+
+struct tracked_hash
+{
+    std::size_t operator()(const tracked& x) const { return x.value; }
+};
+
+} // namespace
+
+using box_t = immer::interned_box<std::string>;
+
+TEST_CASE("equal values share the same object")
+{
+    auto x = box_t{"foo"};
+    auto y = box_t{std::string{"fo"} + "o"};
+    auto z = box_t{"bar"};
+    CHECK(x == y);
+    CHECK(&x.get() == &y.get());
+    CHECK(x != z);
+    CHECK(&x.get() != &z.get());
+    CHECK(x == "foo");
+    CHECK("bar" == z);
+    CHECK(z < x);
+    CHECK(std::hash<box_t>{}(x) == std::hash<std::string>{}("foo"));
+}
+
+TEST_CASE("values are released when no longer referenced")
+{
+    using tbox_t = immer::interned_box<tracked, tracked_hash>;
+    {
+        auto x = tbox_t{42};
+        auto y = tbox_t{42};
+        auto z = tbox_t{43};
+        CHECK(tracked::alive == 2);
+        CHECK(x == y);
+        CHECK(x != z);
+        {
+            auto w = x;
+            CHECK(w == y);
+        }
+        CHECK(tracked::alive == 2);
+        z = y;
+        CHECK(tracked::alive == 1);
+    }
+    CHECK(tracked::alive == 0);
+    auto x = tbox_t{42};
+    CHECK(x == tbox_t{42});
+    CHECK(tracked::alive == 1);
+}
+
+TEST_CASE("update")
+{
+    auto x = box_t{"foo"};
+    auto y = x.update([](auto v) { return v + "bar"; });
+    CHECK(x == "foo");
+    CHECK(y == "foobar");
+    CHECK(y == box_t{"foobar"});
+}
+
+TEST_CASE("containers of interned boxes")
+{
+    auto v1 = immer::vector<box_t>{};
+    auto v2 = immer::vector<box_t>{};
+    for (auto i = 0; i < 100; ++i) {
+        v1 = std::move(v1).push_back(std::to_string(i % 10));
+        v2 = std::move(v2).push_back(std::to_string(i % 10));
+    }
+    CHECK(v1 == v2);
+    CHECK(&v1[3].get() == &v2[13].get());
+}
+
+TEST_CASE("concurrent interning")
+{
+    constexpr auto n_threads = 4;
+    constexpr auto n_iters   = 10000;
+    auto threads             = std::vector<std::thread>{};
+    auto reference           = box_t{"0"};
+    // Catch assertions are not thread-safe, so every thread counts its
+    // own mismatches and they are checked after joining
+    auto mismatches = std::vector<int>(n_threads, 0);
+    for (auto t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t] {
+            for (auto i = 0; i < n_iters; ++i) {
+                auto x = box_t{std::to_string(i % 3)};
+                auto y = box_t{std::to_string(i % 3)};
+                if (x != y)
+                    ++mismatches[t];
+                if (i % 3 == 0 && x != reference)
+                    ++mismatches[t];
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+    for (auto t = 0; t < n_threads; ++t)
+        CHECK(mismatches[t] == 0);
+}
+
+TEST_CASE("compact refcount")
+{
+    using mp_t   = immer::memory_policy<immer::default_heap_policy,
+                                      immer::compact_refcount_policy,
+                                      immer::default_lock_policy>;
+    using cbox_t = immer::interned_box<std::string,
+                                       std::hash<std::string>,
+                                       std::equal_to<std::string>,
+                                       mp_t>;
+    {
+        auto x = cbox_t{"foo"};
+        auto y = cbox_t{"foo"};
+        auto z = cbox_t{"bar"};
+        CHECK(&x.get() == &y.get());
+        CHECK(x != z);
+    }
+    auto x = cbox_t{"foo"};
+    CHECK(x == cbox_t{"foo"});
+
+    SECTION("try_inc leaves a saturated count as it is")
+    {
+        immer::compact_refcount_policy r{};
+        r.word = immer::compact_refcount_policy::count_mask;
+        CHECK(immer::detail::try_inc(r));
+        CHECK(r.saturated());
+        CHECK(!r.owned());
+    }
+}
@@ -0,0 +1,82 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/box.hpp>
+#include <immer/box_transient.hpp>
+
+#include <catch.hpp>
+
+#include <string>
+
+TEST_CASE("box transient")
+{
+    auto b = immer::box<std::string>{"hello"};
+
+    SECTION("copies a shared value once")
+    {
+        auto t = b.transient();
+        auto& v = t.get_mut();
+        CHECK(&v != &b.get());
+        v += ", world";
+        CHECK(&t.get_mut() == &v);
+        t.update([](auto s) { return s + "!"; });
+        CHECK(*t == "hello, world!");
+        CHECK(*b == "hello");
+        CHECK(t.persistent() == "hello, world!");
+    }
+
+    SECTION("reuses a unique value")
+    {
+        auto p = &b.get();
+        auto t = std::move(b).transient();
+        t.set("bye");
+        CHECK(&t.get() == p);
+        auto c = std::move(t).persistent();
+        CHECK(&c.get() == p);
+        CHECK(c == "bye");
+    }
+
+    SECTION("persistent values are not modified afterwards")
+    {
+        auto t = std::move(b).transient();
+        t.set("a");
+        auto p1 = t.persistent();
+        t.set("b");
+        auto p2 = t.persistent();
+        CHECK(p1 == "a");
+        CHECK(p2 == "b");
+        CHECK(*t == "b");
+    }
+
+    SECTION("copies of transients do not share mutations")
+    {
+        auto t1 = std::move(b).transient();
+        t1.set("a");
+        auto t2 = t1;
+        t1.set("b");
+        t2.set("c");
+        CHECK(*t1 == "b");
+        CHECK(*t2 == "c");
+    }
+}
+
+TEST_CASE("box transient of inline boxes")
+{
+    using memory_t = immer::memory_policy<immer::default_heap_policy,
+                                          immer::default_refcount_policy,
+                                          immer::default_lock_policy,
+                                          immer::no_transience_policy,
+                                          false,
+                                          true,
+                                          true>;
+    auto b = immer::box<int, memory_t>{41};
+    auto t = b.transient();
+    t.update([](int x) { return x + 1; });
+    CHECK(b == 41);
+    CHECK(t.persistent() == 42);
+}
@@ -211,6 +211,17 @@ struct dadaist_wrapper<V<T, MP, B, BL>>
     using type = V<dadaist<T>, dadaist_memory_policy<MP>, B, BL>;
 };
 
+template <template <class, class, std::size_t, rbits_t, rbits_t> class V,
+          typename T,
+          typename MP,
+          std::size_t N,
+          rbits_t B,
+          rbits_t BL>
+struct dadaist_wrapper<V<T, MP, N, B, BL>>
+{
+    using type = V<dadaist<T>, dadaist_memory_policy<MP>, N, B, BL>;
+};
+
 template <template <class, class> class V, typename T, typename MP>
 struct dadaist_wrapper<V<T, MP>>
 {
@@ -0,0 +1,35 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/flex_vector.hpp>
+#include <immer/vector.hpp>
+
+#include <cstdint>
+
+static_assert(immer::bits_leaf_for_bytes<char, 4096> == 12, "");
+static_assert(immer::bits_leaf_for_bytes<std::uint64_t, 1024> == 7, "");
+static_assert(immer::bits_leaf_for_bytes<std::uint64_t, 1000> == 6, "");
+static_assert(immer::bits_leaf_for_bytes<char[96], 256> == 1, "");
+static_assert(immer::bits_leaf_for_bytes<char[96], 64> == 0, "");
+
+template <typename T>
+using test_flex_vector_t =
+    immer::flex_vector<T,
+                       immer::default_memory_policy,
+                       3u,
+                       immer::bits_leaf_for_bytes<T, 64>>;
+
+template <typename T>
+using test_vector_t = immer::vector<T,
+                                    immer::default_memory_policy,
+                                    3u,
+                                    immer::bits_leaf_for_bytes<T, 64>>;
+
+#define FLEX_VECTOR_T test_flex_vector_t
+#define VECTOR_T test_vector_t
+#include "generic.ipp"
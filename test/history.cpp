@@ -0,0 +1,152 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/array.hpp>
+#include <immer/flex_vector.hpp>
+#include <immer/history.hpp>
+#include <immer/map.hpp>
+#include <immer/vector.hpp>
+
+#include <catch.hpp>
+
+#include <memory>
+
+TEST_CASE("versions")
+{
+    auto h = immer::history<immer::vector<int>>{3};
+    CHECK(h.empty());
+
+    auto v = immer::vector<int>{};
+    for (auto i = 0; i < 5; ++i) {
+        v = v.push_back(i);
+        CHECK(h.push(v) == static_cast<std::size_t>(i));
+    }
+
+    CHECK(h.size() == 3);
+    CHECK(h.oldest() == 2);
+    CHECK(h.newest() == 4);
+    CHECK(!h.contains(1));
+    CHECK(h.contains(2));
+    CHECK(h[2].size() == 3);
+    CHECK(h.latest().size() == 5);
+    CHECK_THROWS_AS(h.at(0), std::out_of_range);
+
+    SECTION("drop newer reuses the ids")
+    {
+        h.drop_newer(2);
+        CHECK(h.size() == 1);
+        CHECK(h.push(h.latest().push_back(42)) == 3);
+        CHECK(h[3].back() == 42);
+    }
+
+    SECTION("shrinking")
+    {
+        h.set_max_versions(1);
+        CHECK(h.size() == 1);
+        CHECK(h.oldest() == 4);
+    }
+}
+
+TEST_CASE("incremental release")
+{
+    using ptr_t = std::shared_ptr<int>;
+    auto x      = std::make_shared<int>(42);
+    auto h      = immer::history<immer::vector<ptr_t>>{2, 1};
+
+    h.push(immer::vector<ptr_t>{x});
+    h.push(immer::vector<ptr_t>{x});
+    h.push(immer::vector<ptr_t>{x});
+    CHECK(h.pending_release() == 1);
+    CHECK(x.use_count() == 4);
+
+    h.drop_newer(0);
+    CHECK(h.size() == 0);
+    CHECK(h.pending_release() == 3);
+    CHECK(x.use_count() == 4);
+
+    h.push({});
+    CHECK(h.pending_release() == 2);
+    CHECK(x.use_count() == 3);
+
+    CHECK(h.release(10) == 2);
+    CHECK(x.use_count() == 1);
+}
+
+TEST_CASE("evicted version outlives the push that evicts it")
+{
+    using ptr_t = std::shared_ptr<int>;
+    auto x      = std::make_shared<int>(1);
+    auto y      = std::make_shared<int>(2);
+    auto h      = immer::history<immer::vector<ptr_t>>{1, 1};
+
+    h.push(immer::vector<ptr_t>{x});
+    CHECK(x.use_count() == 2);
+
+    h.push(immer::vector<ptr_t>{y});
+    CHECK(h.size() == 1);
+    CHECK(h.pending_release() == 1);
+    CHECK(x.use_count() == 2);
+
+    h.push({});
+    CHECK(h.pending_release() == 1);
+    CHECK(x.use_count() == 1);
+    CHECK(y.use_count() == 2);
+
+    h.release_all();
+    CHECK(h.pending_release() == 0);
+    CHECK(y.use_count() == 1);
+}
+
+TEST_CASE("memory")
+{
+    SECTION("vector")
+    {
+        auto h = immer::history<immer::flex_vector<int>>{10};
+        auto v = immer::flex_vector<int>(10000, 0);
+        h.push(v);
+        h.push(v.set(5000, 1));
+        h.push(v.push_front(1));
+
+        auto m = h.memory();
+        CHECK(m.bytes > 10000 * sizeof(int));
+        CHECK(m.shared_bytes > m.unique_bytes);
+        CHECK(m.shared_bytes + m.unique_bytes == m.bytes);
+        CHECK(m.unshared_bytes > 2 * m.bytes);
+
+        CHECK(h.unique_bytes(1) > 0);
+        CHECK(h.unique_bytes(1) < 1000);
+        CHECK(h.unique_bytes(0) < h.unique_bytes(2));
+    }
+
+    SECTION("map")
+    {
+        auto h = immer::history<immer::map<int, int>>{10};
+        auto m = immer::map<int, int>{};
+        for (auto i = 0; i < 1000; ++i)
+            m = m.set(i, i);
+        h.push(m);
+        h.push(m.set(0, 1));
+        auto r = h.memory();
+        CHECK(r.shared_bytes > 0);
+        CHECK(r.unique_bytes > 0);
+        CHECK(r.unique_bytes < r.shared_bytes);
+    }
+
+    SECTION("array")
+    {
+        auto h = immer::history<immer::array<int>>{10};
+        auto a = immer::array<int>(100, 0);
+        h.push(a);
+        h.push(a);
+        h.push(a.set(0, 1));
+        auto r = h.memory();
+        CHECK(r.nodes == 2);
+        CHECK(h.unique_bytes(0) == 0);
+        CHECK(h.unique_bytes(2) > 100 * sizeof(int));
+    }
+}
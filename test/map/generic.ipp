@@ -20,6 +20,7 @@
 
 #include <catch.hpp>
 
+#include <numeric>
 #include <random>
 #include <unordered_map>
 #include <unordered_set>
@@ -411,6 +412,95 @@ TEST_CASE("update_if_exists boxed move string")
 }
 #endif
 
+TEST_CASE("transform values")
+{
+    SECTION("same type")
+    {
+        auto v = make_test_map(666u);
+        auto r = v.transform_values([](unsigned x) { return x * 2; });
+        CHECK(r.size() == v.size());
+        for (auto i = 0u; i < 666u; ++i)
+            CHECK(r.at(i) == i * 2);
+    }
+
+    SECTION("other type")
+    {
+        auto v = make_test_map(666u);
+        auto r = v.transform_values([](unsigned x) { return x + 0.5; });
+        static_assert(
+            std::is_same<decltype(r)::mapped_type, double>::value, "");
+        CHECK(r.size() == v.size());
+        for (auto i = 0u; i < 666u; ++i)
+            CHECK(r.at(i) == i + 0.5);
+    }
+
+    SECTION("collisions")
+    {
+        auto vals = make_values_with_collisions(666u);
+        auto v    = make_test_map(vals);
+        auto r    = v.transform_values([](unsigned x) { return x + 1; });
+        auto e    = v;
+        for (auto&& kv : vals)
+            e = e.set(kv.first, kv.second + 1);
+        CHECK(r == e);
+    }
+
+    SECTION("empty")
+    {
+        auto v = MAP_T<unsigned, unsigned>{};
+        auto r = v.transform_values([](unsigned x) { return x; });
+        CHECK(r.size() == 0);
+        CHECK(r == v);
+    }
+}
+
+TEST_CASE("filter")
+{
+    auto check_filter = [](auto v, auto&& keys, unsigned k) {
+        auto r = v.filter([&](auto&& kv) { return kv.second % k != 0; });
+        auto e = v;
+        for (auto&& key : keys)
+            if (v.at(key) % k == 0)
+                e = e.erase(key);
+        CHECK(r.size() == e.size());
+        CHECK(r == e);
+        for (auto&& kv : r)
+            CHECK(kv.second % k != 0);
+    };
+
+    for (auto n : {0u, 1u, 2u, 3u, 16u, 100u, 1500u}) {
+        auto v    = make_test_map(n);
+        auto keys = std::vector<unsigned>(n);
+        std::iota(keys.begin(), keys.end(), 0u);
+        for (auto k : {1u, 2u, 3u, 7u, n + 1})
+            check_filter(v, keys, k);
+
+        if (n < 16)
+            continue;
+        auto vals  = make_values_with_collisions(n);
+        auto cv    = make_test_map(vals);
+        auto ckeys = std::vector<conflictor>{};
+        for (auto&& kv : vals)
+            ckeys.push_back(kv.first);
+        for (auto k : {1u, 2u, 3u, 7u, n + 1})
+            check_filter(cv, ckeys, k);
+    }
+
+    SECTION("keeps a single value")
+    {
+        auto v = make_test_map(1000u);
+        auto r = v.filter([](auto&& kv) { return kv.first == 42; });
+        CHECK(r == MAP_T<unsigned, unsigned>{}.set(42, 42));
+    }
+
+    SECTION("keeping everything shares the tree")
+    {
+        auto v = make_test_map(1000u);
+        auto r = v.filter([](auto&&) { return true; });
+        CHECK(r.impl().root == v.impl().root);
+    }
+}
+
 TEST_CASE("exception safety")
 {
     constexpr auto n = 2666u;
@@ -620,6 +710,53 @@ TEST_CASE("exception safety")
         CHECK(d.happenings == 0);
         IMMER_TRACE_E(d.happenings);
     }
+
+    SECTION("transform values collisions")
+    {
+        auto vals = make_values_with_collisions(n);
+        auto v    = dadaist_conflictor_map_t{};
+        for (auto i = 0u; i < n; ++i)
+            v = v.insert(vals[i]);
+        auto d  = dadaism{};
+        auto fn = [](auto x) { return x + 1; };
+        auto r  = decltype(v.transform_values(fn)){};
+        for (auto done = false; !done;) {
+            try {
+                auto s = d.next();
+                r      = v.transform_values(fn);
+                done = true;
+            } catch (dada_error) {}
+        }
+        for (auto i : test_irange(0u, n)) {
+            CHECK(v.at(vals[i].first) == vals[i].second);
+            CHECK(r.at(vals[i].first) == vals[i].second + 1);
+        }
+        CHECK(d.happenings > 0);
+        IMMER_TRACE_E(d.happenings);
+    }
+
+    SECTION("filter collisions")
+    {
+        auto vals = make_values_with_collisions(n);
+        auto v    = dadaist_conflictor_map_t{};
+        for (auto i = 0u; i < n; ++i)
+            v = v.insert(vals[i]);
+        auto d = dadaism{};
+        auto r = v;
+        for (auto done = false; !done;) {
+            try {
+                auto s = d.next();
+                r = v.filter([](auto&& kv) { return kv.second % 3 != 0; });
+                done = true;
+            } catch (dada_error) {}
+        }
+        CHECK(v.size() == n);
+        CHECK(r.size() == n - (n + 2) / 3);
+        for (auto i : test_irange(0u, n))
+            CHECK(r.count(vals[i].first) == (vals[i].second % 3 != 0));
+        CHECK(d.happenings > 0);
+        IMMER_TRACE_E(d.happenings);
+    }
 }
 
 namespace {
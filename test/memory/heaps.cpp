@@ -6,6 +6,7 @@
 // See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
 //
 
+#include <immer/heap/counting_heap.hpp>
 #include <immer/heap/cpp_heap.hpp>
 #include <immer/heap/free_list_heap.hpp>
 #include <immer/heap/gc_heap.hpp>
@@ -99,3 +100,47 @@ TEST_CASE("unsafe free_list")
     test_free_list_heap<
         immer::unsafe_free_list_heap<42u, 2, immer::malloc_heap>>();
 }
+
+TEST_CASE("counting")
+{
+    struct tag
+    {};
+    using heap = immer::counting_heap<immer::malloc_heap, tag>;
+
+    auto before = heap::counters();
+    auto p      = heap::allocate(42u);
+    auto q      = heap::allocate(100u);
+    do_stuff_to(p, 42u);
+    do_stuff_to(q, 100u);
+
+    auto c = heap::counters() - before;
+    CHECK(c.allocations == 2);
+    CHECK(c.deallocations == 0);
+    CHECK(c.bytes_allocated == 142);
+    CHECK(c.live_bytes() == 142);
+    CHECK(c.peak_bytes == 142);
+    CHECK(c.allocations_by_size[6] == 1);
+    CHECK(c.allocations_by_size[7] == 1);
+
+    heap::deallocate(100u, q);
+    heap::reset_peak();
+    c = heap::counters() - before;
+    CHECK(c.deallocations == 1);
+    CHECK(c.live_bytes() == 42);
+    CHECK(c.live_allocations() == 1);
+    CHECK(c.peak_bytes == 42);
+
+    heap::deallocate(42u, p);
+    c = heap::counters() - before;
+    CHECK(c.live_bytes() == 0);
+    CHECK(c.bytes_deallocated == 142);
+
+    SECTION("heaps with the same tag share the counters")
+    {
+        using other = immer::counting_heap<immer::cpp_heap, tag>;
+        auto r      = other::allocate(10u);
+        CHECK((heap::counters() - before).allocations == 3);
+        other::deallocate(10u, r);
+        CHECK((heap::counters() - before).live_bytes() == 0);
+    }
+}
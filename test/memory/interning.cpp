@@ -0,0 +1,231 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/flex_vector.hpp>
+#include <immer/interning/node_interning_policy.hpp>
+#include <immer/map.hpp>
+#include <immer/set.hpp>
+#include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
+
+#include <catch.hpp>
+
+#include <functional>
+
+namespace {
+
+struct counted
+{
+    static long live;
+    static long compared;
+
+    int value;
+
+    counted(int v = 0)
+        : value{v}
+    {
+        ++live;
+    }
+    counted(const counted& x)
+        : value{x.value}
+    {
+        ++live;
+    }
+    counted& operator=(const counted&) = default;
+    ~counted() { --live; }
+
+    bool operator==(const counted& x) const
+    {
+        ++compared;
+        return value == x.value;
+    }
+    bool operator!=(const counted& x) const { return !(*this == x); }
+};
+
+long counted::live     = 0;
+long counted::compared = 0;
+
+} // namespace
+
+namespace std {
+
+template <>
+struct hash<counted>
+{
+    std::size_t operator()(const counted& x) const { return x.value; }
+};
+
+} // namespace std
+
+namespace {
+
+using interning_memory =
+    immer::memory_policy<immer::default_heap_policy,
+                         immer::default_refcount_policy,
+                         immer::default_lock_policy,
+                         immer::no_transience_policy,
+                         false,
+                         true,
+                         false,
+                         immer::default_growth_policy,
+                         immer::immediate_reclamation_policy,
+                         immer::node_interning_policy>;
+
+template <typename Vector>
+Vector make_vector(int n, int first = 0)
+{
+    auto v = Vector{};
+    for (auto i = 0; i < n; ++i)
+        v = v.push_back(first + i);
+    return v;
+}
+
+template <typename Map>
+Map make_map(int n, bool reverse = false)
+{
+    auto m = Map{};
+    for (auto i = 0; i < n; ++i) {
+        auto k = reverse ? n - 1 - i : i;
+        m      = m.set(k, k);
+    }
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("vectors built independently share their leaves")
+{
+    using vector_t = immer::vector<int, interning_memory, 5, 5>;
+
+    auto v1 = make_vector<vector_t>(1000);
+    auto v2 = make_vector<vector_t>(1000);
+    CHECK(&v1[0] == &v2[0]);
+    CHECK(&v1[500] == &v2[500]);
+    CHECK(v1 == v2);
+
+    SECTION("also when built with transients")
+    {
+        auto t = vector_t{}.transient();
+        for (auto i = 0; i < 1000; ++i)
+            t.push_back(i);
+        auto v3 = t.persistent();
+        CHECK(&v1[500] == &v3[500]);
+    }
+
+    SECTION("updated leaves are interned too")
+    {
+        auto v3 = v1.set(500, 42);
+        auto v4 = v2.set(500, 42);
+        CHECK(&v3[500] != &v1[500]);
+        CHECK(&v3[500] == &v4[500]);
+    }
+}
+
+TEST_CASE("flex_vectors built independently share their leaves")
+{
+    using vector_t = immer::flex_vector<int, interning_memory, 5, 5>;
+
+    auto v1 = make_vector<vector_t>(1000);
+    auto v2 = make_vector<vector_t>(1000);
+    CHECK(&v1[0] == &v2[0]);
+    CHECK(&v1[500] == &v2[500]);
+    CHECK(v1 == v2);
+}
+
+TEST_CASE("comparing equal vectors skips the interned leaves")
+{
+    using vector_t = immer::vector<counted, interning_memory, 5, 5>;
+
+    // The last 32 elements are in the tail, which is not interned
+    auto v1           = make_vector<vector_t>(32 * 10);
+    auto v2           = make_vector<vector_t>(32 * 10);
+    counted::compared = 0;
+    CHECK(v1 == v2);
+    CHECK(counted::compared == 32);
+}
+
+TEST_CASE("interned leaves are never updated in place")
+{
+    using vector_t = immer::vector<int, interning_memory, 5, 5>;
+
+    SECTION("by r-values")
+    {
+        auto v1 = make_vector<vector_t>(100);
+        v1      = std::move(v1).set(1, 42);
+        CHECK(v1[1] == 42);
+        CHECK(make_vector<vector_t>(100)[1] == 1);
+    }
+
+    SECTION("by transients")
+    {
+        auto t = vector_t{}.transient();
+        for (auto i = 0; i < 100; ++i)
+            t.push_back(i);
+        t.set(1, 42);
+        CHECK(t[1] == 42);
+        CHECK(make_vector<vector_t>(100)[1] == 1);
+    }
+}
+
+TEST_CASE("leaves only referenced by the table are released")
+{
+    using vector_t = immer::vector<counted, interning_memory, 5, 5>;
+
+    for (auto i = 0; i < 1000; ++i)
+        make_vector<vector_t>(64, i * 64);
+    // Every vector interned one leaf, and the table is purged once it
+    // holds 256 of them
+    CHECK(counted::live > 0);
+    CHECK(counted::live <= 256 * 32);
+}
+
+TEST_CASE("maps built independently share their values")
+{
+    using map_t = immer::map<int,
+                             int,
+                             std::hash<int>,
+                             std::equal_to<int>,
+                             interning_memory>;
+
+    auto m1 = make_map<map_t>(1000);
+    auto m2 = make_map<map_t>(1000, true);
+    CHECK(m1.find(0) == m2.find(0));
+    CHECK(m1.find(500) == m2.find(500));
+    CHECK(m1 == m2);
+
+    SECTION("interned values are never updated in place")
+    {
+        m1 = std::move(m1).set(1, 42);
+        CHECK(m1[1] == 42);
+        CHECK(m2[1] == 1);
+        CHECK(make_map<map_t>(1000)[1] == 1);
+    }
+
+    SECTION("removing a value interns the rest")
+    {
+        auto m3 = m1.erase(7);
+        auto m4 = m2.erase(7);
+        CHECK(m3.find(7) == nullptr);
+        CHECK(m3.find(500) == m4.find(500));
+    }
+}
+
+TEST_CASE("sets built independently share their values")
+{
+    using set_t =
+        immer::set<int, std::hash<int>, std::equal_to<int>, interning_memory>;
+
+    auto s1 = set_t{};
+    auto s2 = set_t{};
+    for (auto i = 0; i < 1000; ++i) {
+        s1 = s1.insert(i);
+        s2 = s2.insert(999 - i);
+    }
+    CHECK(s1.find(42) == s2.find(42));
+    CHECK(s1 == s2);
+}
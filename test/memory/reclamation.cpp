@@ -0,0 +1,251 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/flex_vector.hpp>
+#include <immer/map.hpp>
+#include <immer/priority_queue.hpp>
+#include <immer/reclamation/deferred_reclamation_policy.hpp>
+#include <immer/sorted_map.hpp>
+#include <immer/vector.hpp>
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+struct counted
+{
+    static std::atomic<long> live;
+
+    int value;
+
+    counted(int v = 0)
+        : value{v}
+    {
+        ++live;
+    }
+    counted(const counted& x)
+        : value{x.value}
+    {
+        ++live;
+    }
+    counted& operator=(const counted&) = default;
+    ~counted() { --live; }
+
+    bool operator==(const counted& x) const { return value == x.value; }
+};
+
+std::atomic<long> counted::live{0};
+
+template <std::size_t Budget, typename Tag>
+using deferred_memory =
+    immer::memory_policy<immer::default_heap_policy,
+                         immer::default_refcount_policy,
+                         immer::default_lock_policy,
+                         immer::no_transience_policy,
+                         false,
+                         true,
+                         false,
+                         immer::default_growth_policy,
+                         immer::deferred_reclamation_policy<Budget, Tag>>;
+
+template <typename Vector>
+Vector make_vector(int n)
+{
+    auto v = Vector{};
+    for (auto i = 0; i < n; ++i)
+        v = std::move(v).push_back(i);
+    return v;
+}
+
+struct static_tag;
+using static_vector_t = immer::vector<int, deferred_memory<16, static_tag>>;
+
+// It is built before the queue of its policy, that is first used by
+// the test below, such that it is destroyed after the queue would be.
+const auto static_vector = make_vector<static_vector_t>(10000);
+
+} // namespace
+
+TEST_CASE("vector nodes are freed when the queue is drained")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    auto& q        = memory_t::reclamation::queue();
+    {
+        auto v = make_vector<immer::vector<counted, memory_t>>(10000);
+        CHECK(counted::live == 10000);
+    }
+    CHECK(q.pending() == 1);
+    CHECK(counted::live > 0);
+
+    SECTION("in bounded slices")
+    {
+        auto last = counted::live.load();
+        while (q.pending()) {
+            CHECK(q.drain(1) == 1);
+            CHECK(counted::live <= last);
+            last = counted::live.load();
+        }
+        CHECK(counted::live == 0);
+    }
+
+    SECTION("all at once")
+    {
+        q.drain_all();
+        CHECK(q.pending() == 0);
+        CHECK(counted::live == 0);
+    }
+}
+
+TEST_CASE("shared nodes are not freed")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    using vector_t = immer::vector<counted, memory_t>;
+    auto& q        = memory_t::reclamation::queue();
+
+    auto v1 = make_vector<vector_t>(10000);
+    {
+        auto v2 = v1.set(5000, 42);
+        auto v3 = v2.push_back(1);
+        CHECK(v3[5000].value == 42);
+    }
+    q.drain_all();
+    CHECK(counted::live == 10000);
+    CHECK(v1[5000].value == 5000);
+
+    v1 = {};
+    q.drain_all();
+    CHECK(counted::live == 0);
+}
+
+TEST_CASE("relaxed flex_vector nodes are freed")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    using vector_t = immer::flex_vector<counted, memory_t>;
+    auto& q        = memory_t::reclamation::queue();
+    {
+        auto v = make_vector<vector_t>(3333);
+        v      = v + make_vector<vector_t>(7777) + v;
+        v      = v.drop(1000).insert(42, counted{7});
+        CHECK(v.size() == 3333 * 2 + 7777 - 1000 + 1);
+    }
+    CHECK(q.pending() > 0);
+    q.drain_all();
+    CHECK(counted::live == 0);
+}
+
+TEST_CASE("map nodes are freed when the queue is drained")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    using map_t    = immer::
+        map<int, counted, std::hash<int>, std::equal_to<int>, memory_t>;
+    auto& q = memory_t::reclamation::queue();
+    {
+        auto m = map_t{};
+        for (auto i = 0; i < 10000; ++i)
+            m = std::move(m).set(i, i);
+        CHECK(counted::live == 10000);
+    }
+    CHECK(q.pending() == 1);
+    auto steps = std::size_t{};
+    while (q.drain(1))
+        ++steps;
+    CHECK(steps > 1);
+    CHECK(counted::live == 0);
+}
+
+TEST_CASE("sorted_map nodes are freed when the queue is drained")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    using map_t    = immer::sorted_map<int, counted, std::less<int>, memory_t>;
+    auto& q        = memory_t::reclamation::queue();
+    {
+        auto m = map_t{};
+        for (auto i = 0; i < 10000; ++i)
+            m = std::move(m).set(i, i);
+        CHECK(counted::live == 10000);
+    }
+    CHECK(q.pending() == 1);
+    auto steps = std::size_t{};
+    while (q.drain(1))
+        ++steps;
+    CHECK(steps > 1);
+    CHECK(counted::live == 0);
+}
+
+TEST_CASE("priority_queue nodes are freed when the queue is drained")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    using queue_t  = immer::priority_queue<int, std::less<int>, memory_t>;
+    auto& q        = memory_t::reclamation::queue();
+    {
+        auto pq = queue_t{};
+        for (auto i = 0; i < 10000; ++i)
+            pq = std::move(pq).push(i % 100);
+    }
+    CHECK(q.pending() == 1);
+    auto steps = std::size_t{};
+    while (q.drain(1))
+        ++steps;
+    CHECK(steps == 10000);
+}
+
+TEST_CASE("budget is drained on every release")
+{
+    struct tag;
+    using memory_t = deferred_memory<4, tag>;
+    using vector_t = immer::vector<counted, memory_t>;
+    auto& q        = memory_t::reclamation::queue();
+
+    make_vector<vector_t>(100000);
+    auto pending = q.pending();
+    CHECK(pending > 0);
+    CHECK(counted::live > 0);
+
+    for (auto i = 0; i < 1000 && counted::live; ++i) {
+        auto v = vector_t{}.push_back(i);
+    }
+    CHECK(q.pending() == 0);
+    CHECK(counted::live == 0);
+}
+
+TEST_CASE("reclamation thread")
+{
+    struct tag;
+    using memory_t = deferred_memory<0, tag>;
+    using vector_t = immer::vector<counted, memory_t>;
+    auto& q        = memory_t::reclamation::queue();
+    {
+        immer::reclamation_thread t{q, 16};
+        for (auto i = 0; i < 10; ++i)
+            make_vector<vector_t>(10000);
+        for (auto i = 0; i < 1000 && q.pending(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    q.drain_all();
+    CHECK(q.pending() == 0);
+    CHECK(counted::live == 0);
+}
+
+TEST_CASE("containers with static storage are released after the queue")
+{
+    auto& q = static_vector_t::memory_policy::reclamation::queue();
+    make_vector<static_vector_t>(10000);
+    q.drain_all();
+    CHECK(q.pending() == 0);
+    CHECK(static_vector.size() == 10000);
+}
@@ -6,6 +6,9 @@
 // See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
 //
 
+#include <immer/detail/combine_standard_layout.hpp>
+#include <immer/memory_policy.hpp>
+#include <immer/refcount/compact_refcount_policy.hpp>
 #include <immer/refcount/no_refcount_policy.hpp>
 #include <immer/refcount/refcount_policy.hpp>
 #include <immer/refcount/unsafe_refcount_policy.hpp>
@@ -50,3 +53,104 @@ TEST_CASE("thread unsafe refcount")
 {
     test_refcount<immer::unsafe_refcount_policy>();
 }
+
+TEST_CASE("compact refcount")
+{
+    test_refcount<immer::compact_refcount_policy>();
+}
+
+TEST_CASE("wide compact refcount")
+{
+    test_refcount<immer::wide_compact_refcount_policy>();
+}
+
+TEST_CASE("compact refcount tracks the owner")
+{
+    using refcount = immer::compact_refcount_policy;
+    using edit     = refcount::edit;
+
+    SECTION("not owned by default")
+    {
+        refcount elem{};
+        CHECK(!elem.owned());
+        CHECK(!elem.can_mutate(edit{0}));
+        CHECK(!elem.can_mutate(edit{1}));
+    }
+
+    SECTION("owned keeps the count")
+    {
+        refcount elem{};
+        elem = edit{42};
+        CHECK(elem.owned());
+        CHECK(elem.unique());
+        CHECK(elem.can_mutate(edit{42}));
+        CHECK(!elem.can_mutate(edit{43}));
+        CHECK(elem.dec());
+    }
+
+    SECTION("sharing drops the owner")
+    {
+        refcount elem{};
+        elem = edit{refcount::max_owner};
+        elem.inc();
+        CHECK(!elem.owned());
+        CHECK(!elem.can_mutate(edit{refcount::max_owner}));
+        CHECK(!elem.dec());
+        CHECK(elem.dec());
+    }
+
+    SECTION("the count saturates instead of reaching the owner")
+    {
+        refcount elem{};
+        elem.word = refcount::count_mask - 1;
+        elem      = edit{1};
+        elem.inc();
+        CHECK(elem.saturated());
+        CHECK(!elem.owned());
+        elem.inc();
+        CHECK(elem.saturated());
+        CHECK(!elem.owned());
+        CHECK(!elem.can_mutate(edit{1}));
+        CHECK(!elem.unique());
+        CHECK(!elem.dec());
+        CHECK(elem.saturated());
+    }
+}
+
+TEST_CASE("compact transience ids")
+{
+    using memory = immer::memory_policy<immer::default_heap_policy,
+                                        immer::compact_refcount_policy,
+                                        immer::default_lock_policy>;
+    using transience = memory::transience_t;
+    using edit       = transience::edit;
+
+    static_assert(
+        std::is_same<transience::ownee, immer::compact_refcount_policy>{},
+        "");
+
+    auto a = transience::owner{};
+    auto b = transience::owner{};
+    CHECK(edit(a) != edit(b));
+    CHECK(edit(a) != edit(transience::noone));
+    CHECK(edit(transience::noone).id == 0);
+}
+
+TEST_CASE("compact refcount shares the header word")
+{
+    using immer::detail::combine_standard_layout_t;
+    using compact   = immer::compact_refcount_policy;
+    using gc_ownee  = immer::gc_transience_policy::apply<
+        immer::default_heap_policy>::type::ownee;
+    using data_t = int;
+
+    static_assert(sizeof(compact) == 4, "");
+    static_assert(sizeof(combine_standard_layout_t<data_t, compact, compact>) ==
+                      2 * sizeof(int),
+                  "");
+    static_assert(
+        sizeof(combine_standard_layout_t<data_t, compact, compact>) <
+            sizeof(
+                combine_standard_layout_t<data_t, immer::refcount_policy, gc_ownee>),
+        "");
+}
@@ -0,0 +1,120 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#define IMMER_ENABLE_PROBES 1
+
+#include <immer/flex_vector.hpp>
+#include <immer/flex_vector_transient.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <immer/nested_batch.hpp>
+#include <immer/probe.hpp>
+
+#include <catch.hpp>
+
+namespace {
+
+using levels_t = immer::flex_vector<int>;
+using book_t   = immer::map<int, levels_t>;
+
+book_t make_book(int keys, int size)
+{
+    auto b = book_t{}.transient();
+    for (auto k = 0; k < keys; ++k)
+        b.set(k, levels_t(size, k));
+    return b.persistent();
+}
+
+std::size_t node_copies()
+{
+    return immer::get_probe_counts()[static_cast<std::size_t>(
+        immer::probe_event::node_copy)];
+}
+
+} // namespace
+
+TEST_CASE("nested batch")
+{
+    auto book = make_book(100, 1000);
+
+    SECTION("applies the updates")
+    {
+        auto batch = immer::nested_batch<book_t>{book};
+        batch.set(3, 10, 42);
+        batch.update(3, 11, [](int x) { return x * 2; });
+        batch.set(7, 999, -1);
+        batch.inner(9).push_back(5);
+        CHECK(batch.open_count() == 3);
+        auto r = std::move(batch).persistent();
+        CHECK(r[3][10] == 42);
+        CHECK(r[3][11] == 6);
+        CHECK(r[7][999] == -1);
+        CHECK(r[9].size() == 1001);
+        CHECK(r[9][1000] == 5);
+        CHECK(r[4] == book[4]);
+        CHECK(book[3][10] == 3);
+        CHECK(book[7][999] == 7);
+        CHECK(book[9].size() == 1000);
+    }
+
+    SECTION("missing keys start empty")
+    {
+        auto batch = immer::nested_batch<book_t>{book};
+        batch.inner(1000).push_back(1);
+        auto r = batch.persistent();
+        CHECK(r.size() == 101);
+        CHECK(r[1000] == levels_t{1});
+    }
+
+    SECTION("can be used after persistent")
+    {
+        auto batch = immer::nested_batch<book_t>{book};
+        batch.set(0, 0, 1);
+        auto r1 = batch.persistent();
+        batch.set(0, 0, 2);
+        auto r2 = batch.persistent();
+        CHECK(r1[0][0] == 1);
+        CHECK(r2[0][0] == 2);
+        CHECK(batch.open_count() == 0);
+    }
+
+    SECTION("copies the paths once per key")
+    {
+        auto one = node_copies();
+        {
+            auto batch = immer::nested_batch<book_t>{book};
+            batch.set(5, 0, 1);
+            auto r = std::move(batch).persistent();
+        }
+        one = node_copies() - one;
+
+        auto many = node_copies();
+        {
+            auto batch = immer::nested_batch<book_t>{book};
+            for (auto i = 0; i < 10; ++i)
+                for (auto j = 0; j < 16; ++j)
+                    batch.set(5, j, i);
+            auto r = std::move(batch).persistent();
+            CHECK(r[5][15] == 9);
+        }
+        many = node_copies() - many;
+
+        CHECK(many == one);
+    }
+
+    SECTION("moves unique inner containers out of the map")
+    {
+        auto unique = make_book(10, 1000);
+        auto before = node_copies();
+        auto batch  = immer::nested_batch<book_t>{std::move(unique)};
+        batch.set(5, 0, 1);
+        unique = std::move(batch).persistent();
+        CHECK(node_copies() == before);
+        CHECK(unique[5][0] == 1);
+    }
+}
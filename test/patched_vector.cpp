@@ -0,0 +1,242 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/flex_vector.hpp>
+#include <immer/flex_vector_transient.hpp>
+#include <immer/heap/counting_heap.hpp>
+#include <immer/heap/cpp_heap.hpp>
+#include <immer/patched_vector.hpp>
+#include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+template <typename V>
+V make_vector(std::size_t n)
+{
+    auto t = typename V::transient_type{};
+    for (auto i = 0u; i < n; ++i)
+        t.push_back(static_cast<typename V::value_type>(i));
+    return t.persistent();
+}
+
+template <typename P>
+std::vector<int> to_std(const P& p)
+{
+    return {p.begin(), p.end()};
+}
+
+} // namespace
+
+TEST_CASE("patches")
+{
+    using pvec_t = immer::patched_vector<immer::vector<int>, 4>;
+    auto base    = make_vector<immer::vector<int>>(1000);
+    auto v       = pvec_t{base};
+    auto expect  = std::vector<int>(1000);
+    std::iota(expect.begin(), expect.end(), 0);
+
+    CHECK(v.size() == 1000);
+    CHECK(v.patch_count() == 0);
+    CHECK(to_std(v) == expect);
+
+    SECTION("set adds patches in order")
+    {
+        auto v2 = v.set(500, -1).set(3, -2).set(999, -3);
+        expect[500] = -1;
+        expect[3]   = -2;
+        expect[999] = -3;
+        CHECK(v2.patch_count() == 3);
+        CHECK(v2[500] == -1);
+        CHECK(v2.at(3) == -2);
+        CHECK(v2[4] == 4);
+        CHECK(to_std(v2) == expect);
+        CHECK(v[500] == 500);
+        CHECK(v2.base() == base);
+    }
+
+    SECTION("set on a patched index replaces the patch")
+    {
+        auto v2 = v.set(10, 1).set(10, 2);
+        CHECK(v2.patch_count() == 1);
+        CHECK(v2[10] == 2);
+    }
+
+    SECTION("update")
+    {
+        auto v2 = v.update(7, [](int x) { return x * 10; });
+        auto v3 = std::move(v2).update(7, [](int x) { return x + 1; });
+        CHECK(v3[7] == 71);
+        CHECK(v3.patch_count() == 1);
+    }
+
+    SECTION("compacts only the chunk that is full")
+    {
+        auto n  = std::size_t{1} << pvec_t::chunk_bits;
+        auto v2 = v.set(n, -100);
+        for (auto i = 0; i < 4; ++i)
+            v2 = v2.set(i, -1 - i);
+        CHECK(v2.patch_count() == 5);
+        CHECK(v2.base() == base);
+
+        auto v3 = v2.set(4, -5);
+        CHECK(v3.patch_count() == 1);
+        CHECK(v3.base() != base);
+        CHECK(v3.base()[n] == static_cast<int>(n));
+        for (auto i = 0; i < 5; ++i)
+            expect[i] = -1 - i;
+        expect[n] = -100;
+        CHECK(to_std(v3) == expect);
+        CHECK(v3.compact() ==
+              immer::vector<int>(expect.begin(), expect.end()));
+    }
+
+    SECTION("compact")
+    {
+        auto v2 = v.set(1, -1).set(2, -2);
+        auto c  = v2.compact();
+        expect[1] = -1;
+        expect[2] = -2;
+        CHECK(c == immer::vector<int>(expect.begin(), expect.end()));
+        CHECK(v2.patch_count() == 2);
+        auto c2 = std::move(v2).compact();
+        CHECK(c2 == c);
+    }
+
+    SECTION("transient")
+    {
+        auto t = v.set(1, -1).transient();
+        t.push_back(1000);
+        auto c = t.persistent();
+        CHECK(c.size() == 1001);
+        CHECK(c[1] == -1);
+    }
+
+    SECTION("push back keeps the patches")
+    {
+        auto v2 = v.set(1, -1).push_back(1000);
+        CHECK(v2.size() == 1001);
+        CHECK(v2.patch_count() == 1);
+        CHECK(v2[1] == -1);
+        CHECK(v2[1000] == 1000);
+    }
+
+    SECTION("take drops the patches past the end")
+    {
+        auto v2 = v.set(1, -1).set(600, -2).set(800, -3);
+        auto v3 = v2.take(700);
+        CHECK(v3.size() == 700);
+        CHECK(v3.patch_count() == 2);
+        CHECK(v3[600] == -2);
+        auto v4 = std::move(v2).take(10);
+        CHECK(v4.patch_count() == 1);
+        CHECK(v4[1] == -1);
+    }
+
+    SECTION("equality")
+    {
+        CHECK(v.set(1, -1) == pvec_t{base.set(1, -1)});
+        CHECK(v.set(1, -1) != v);
+        CHECK(v.set(1, 1) == v);
+    }
+}
+
+TEST_CASE("iterator")
+{
+    using pvec_t = immer::patched_vector<immer::flex_vector<int>>;
+    auto v = pvec_t{make_vector<immer::flex_vector<int>>(100)}
+                 .set(0, -1)
+                 .set(50, -2)
+                 .set(99, -3);
+    auto expect = std::vector<int>(100);
+    std::iota(expect.begin(), expect.end(), 0);
+    expect[0]  = -1;
+    expect[50] = -2;
+    expect[99] = -3;
+
+    CHECK(std::equal(v.begin(), v.end(), expect.begin()));
+    CHECK(std::equal(v.rbegin(), v.rend(), expect.rbegin()));
+    CHECK(v.end() - v.begin() == 100);
+    CHECK(*(v.begin() + 50) == -2);
+    CHECK(*(v.end() - 1) == -3);
+    CHECK((v.begin() + 51)[-1] == -2);
+
+    auto it = v.begin() + 49;
+    CHECK(*it++ == 49);
+    CHECK(*it-- == -2);
+    CHECK(*it == 49);
+    it += 2;
+    CHECK(*it == 51);
+    CHECK(*--it == -2);
+}
+
+TEST_CASE("big elements")
+{
+    using elem_t = std::array<char, 128>;
+    using pvec_t = immer::patched_vector<immer::flex_vector<elem_t>>;
+    auto e       = elem_t{};
+    auto t       = immer::flex_vector<elem_t>{}.transient();
+    for (auto i = 0; i < 200; ++i) {
+        e[0] = static_cast<char>(i);
+        t.push_back(e);
+    }
+    auto v = pvec_t{t.persistent()};
+    e[0]   = 'x';
+    auto v2 = v.set(100, e);
+    CHECK(v2[100][0] == 'x');
+    CHECK(v2[101][0] == 101);
+    CHECK(v[100][0] == 100);
+    CHECK(v2.compact()[100][0] == 'x');
+}
+
+TEST_CASE("sparse updates allocate less than a vector")
+{
+    struct tag
+    {};
+    using heap_t = immer::counting_heap<immer::cpp_heap, tag>;
+    using mp_t   = immer::memory_policy<immer::heap_policy<heap_t>,
+                                      immer::refcount_policy,
+                                      immer::default_lock_policy>;
+    using elem_t = std::array<char, 64>;
+    using vec_t  = immer::vector<elem_t, mp_t, 5, 5>;
+    using pvec_t = immer::patched_vector<vec_t>;
+
+    auto t = vec_t{}.transient();
+    for (auto i = 0; i < 4096; ++i)
+        t.push_back(elem_t{});
+    auto base = t.persistent();
+    auto e    = elem_t{};
+    e[0]      = 'x';
+
+    // all versions are kept alive, as in an undo history, so that
+    // every update has to copy instead of mutating in place
+    auto vs     = std::vector<vec_t>{base};
+    auto before = heap_t::counters();
+    for (auto i = 0u; i < 512; ++i)
+        vs.push_back(vs.back().set((i * 97) % 4096, e));
+    auto vector_bytes = (heap_t::counters() - before).bytes_allocated;
+
+    auto ps = std::vector<pvec_t>{pvec_t{base}};
+    before  = heap_t::counters();
+    for (auto i = 0u; i < 512; ++i)
+        ps.push_back(ps.back().set((i * 97) % 4096, e));
+    auto patched_bytes = (heap_t::counters() - before).bytes_allocated;
+
+    CHECK(ps.back().patch_count() == 512);
+    CHECK(ps.back().base() == base);
+    CHECK(ps.back().compact() == vs.back());
+    CHECK(patched_bytes * 2 < vector_bytes);
+}
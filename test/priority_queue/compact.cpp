@@ -0,0 +1,31 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/memory_policy.hpp>
+#include <immer/priority_queue.hpp>
+#include <immer/priority_queue_transient.hpp>
+
+using compact_memory =
+    immer::memory_policy<immer::default_heap_policy,
+                         immer::compact_refcount_policy,
+                         immer::default_lock_policy>;
+
+template <typename T,
+          typename Compare = std::less<T>,
+          typename MP      = compact_memory>
+using test_queue_t = immer::priority_queue<T, Compare, MP>;
+
+template <typename T,
+          typename Compare = std::less<T>,
+          typename MP      = compact_memory>
+using test_queue_transient_t = immer::priority_queue_transient<T, Compare, MP>;
+
+#define PQ_T test_queue_t
+#define PQ_TRANSIENT_T test_queue_transient_t
+
+#include "generic.ipp"
@@ -0,0 +1,15 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/priority_queue.hpp>
+#include <immer/priority_queue_transient.hpp>
+
+#define PQ_T ::immer::priority_queue
+#define PQ_TRANSIENT_T ::immer::priority_queue_transient
+
+#include "generic.ipp"
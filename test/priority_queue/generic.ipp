@@ -0,0 +1,276 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#ifndef PQ_T
+#error "define the priority queue template to use in PQ_T"
+#endif
+
+#ifndef PQ_TRANSIENT_T
+#error "define the priority queue template to use in PQ_TRANSIENT_T"
+#endif
+
+#include "test/dada.hpp"
+#include "test/util.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Queue>
+auto drain(Queue q)
+{
+    auto result = std::vector<typename Queue::value_type>{};
+    while (!q.empty()) {
+        result.push_back(q.top());
+        q = std::move(q).pop();
+    }
+    return result;
+}
+
+template <typename T, typename Compare>
+auto drain(std::priority_queue<T, std::vector<T>, Compare> q)
+{
+    auto result = std::vector<T>{};
+    while (!q.empty()) {
+        result.push_back(q.top());
+        q.pop();
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("instantiation")
+{
+    auto q = PQ_T<int>{};
+    CHECK(q.size() == 0u);
+    CHECK(q.empty());
+}
+
+TEST_CASE("initializer list and range constructors")
+{
+    auto v  = std::vector<std::string>{"foo", "bar", "baz", "bar"};
+    auto q1 = PQ_T<std::string>{"foo", "bar", "baz", "bar"};
+    auto q2 = PQ_T<std::string>{v.begin(), v.end()};
+    CHECK(q1.size() == 4);
+    CHECK(q1.top() == "foo");
+    CHECK(drain(q1) == drain(q2));
+    CHECK(drain(q1) ==
+          (std::vector<std::string>{"foo", "baz", "bar", "bar"}));
+}
+
+TEST_CASE("push and pop")
+{
+    auto engine   = std::default_random_engine{42};
+    auto expected = std::priority_queue<unsigned>{};
+    auto q        = PQ_T<unsigned>{};
+    auto history  = std::vector<
+        std::pair<PQ_T<unsigned>, std::priority_queue<unsigned>>>{};
+
+    for (auto i = 0u; i < 5000u; ++i) {
+        if (!q.empty() && engine() % 3 == 0) {
+            CHECK(q.top() == expected.top());
+            q = q.pop();
+            expected.pop();
+        } else {
+            auto x = unsigned(engine() % 1000u);
+            q      = q.push(x);
+            expected.push(x);
+        }
+        CHECK(q.size() == expected.size());
+        if (i % 500 == 0)
+            history.emplace_back(q, expected);
+    }
+    CHECK(drain(q) == drain(expected));
+    for (auto&& h : history)
+        CHECK(drain(h.first) == drain(h.second));
+}
+
+TEST_CASE("popping the same version")
+{
+    auto q = PQ_T<int>{};
+    for (auto i = 0; i < 1000; ++i)
+        q = std::move(q).push(i * 7919 % 1000);
+    for (auto i = 0; i < 100; ++i) {
+        auto p = q.pop();
+        CHECK(p.top() == 998);
+        CHECK(p.size() == 999u);
+    }
+    CHECK(q.top() == 999);
+    CHECK(q.size() == 1000u);
+}
+
+TEST_CASE("custom order")
+{
+    auto q = PQ_T<int, std::greater<int>>{5, 3, 8, 1};
+    CHECK(q.top() == 1);
+    CHECK(drain(q) == (std::vector<int>{1, 3, 5, 8}));
+}
+
+TEST_CASE("merge")
+{
+    auto a = PQ_T<int>{};
+    auto b = PQ_T<int>{};
+    for (auto i = 0; i < 500; ++i) {
+        a = a.push(i * 2);
+        b = b.push(i * 2 + 1);
+    }
+    auto c = a.merge(b);
+    CHECK(c.size() == 1000u);
+    CHECK(a.size() == 500u);
+    CHECK(b.size() == 500u);
+
+    auto expected = std::vector<int>{};
+    for (auto i = 999; i >= 0; --i)
+        expected.push_back(i);
+    CHECK(drain(c) == expected);
+    CHECK(drain(c) == drain(b.merge(a)));
+    CHECK(drain(a.merge(a)).size() == 1000u);
+    CHECK(drain(std::move(a).merge(b)) == expected);
+}
+
+TEST_CASE("long spines")
+{
+    // Pushing in increasing order makes every new element the root,
+    // with the rest of the heap as its left child.
+    constexpr auto n = 200000;
+    {
+        auto q = PQ_T<int>{};
+        for (auto i = 0; i < n; ++i)
+            q = std::move(q).push(i);
+        CHECK(q.top() == n - 1);
+        auto old = q;
+        for (auto i = 0; i < 10; ++i)
+            q = std::move(q).pop();
+        CHECK(q.top() == n - 11);
+        CHECK(old.top() == n - 1);
+    }
+    {
+        auto q = PQ_T<int>{};
+        for (auto i = 0; i < n; ++i)
+            q = std::move(q).push(-i);
+        CHECK(q.top() == 0);
+    }
+}
+
+TEST_CASE("transient")
+{
+    auto q = PQ_T<int>{3, 1, 2};
+    auto t = q.transient();
+    t.push(5);
+    t.push(0);
+    CHECK(t.top() == 5);
+    t.pop();
+    t.merge(PQ_T<int>{4, 10});
+    CHECK(t.size() == 6u);
+    CHECK(t.top() == 10);
+
+    auto p = t.persistent();
+    t.pop();
+    t.pop();
+    CHECK(drain(p) == (std::vector<int>{10, 4, 3, 2, 1, 0}));
+    CHECK(drain(t.persistent()) == (std::vector<int>{3, 2, 1, 0}));
+    CHECK(drain(q) == (std::vector<int>{3, 2, 1}));
+
+    SECTION("many")
+    {
+        auto t2 = PQ_TRANSIENT_T<unsigned>{};
+        for (auto i = 0u; i < 10000u; ++i)
+            t2.push(i * 7919u % 10000u);
+        auto snapshot = t2.persistent();
+        for (auto i = 0u; i < 5000u; ++i) {
+            CHECK(t2.top() == 9999u - i);
+            t2.pop();
+        }
+        CHECK(snapshot.size() == 10000u);
+        CHECK(snapshot.top() == 9999u);
+        CHECK(t2.size() == 5000u);
+    }
+}
+
+TEST_CASE("exception safety")
+{
+    constexpr auto n = 666u;
+
+    using memory_policy_t = typename PQ_T<unsigned>::memory_policy_type;
+    using dadaist_queue_t = PQ_T<dadaist<unsigned>,
+                                 std::less<dadaist<unsigned>>,
+                                 dadaist_memory_policy<memory_policy_t>>;
+
+    auto expected = std::vector<unsigned>{};
+    for (auto i = n; i-- > 0;)
+        expected.push_back(i);
+    auto values = [](const dadaist_queue_t& q) {
+        auto s      = dadaism::disable();
+        auto result = std::vector<unsigned>{};
+        for (auto x : drain(q))
+            result.push_back(x.value);
+        return result;
+    };
+
+    SECTION("push")
+    {
+        auto q = dadaist_queue_t{};
+        auto d = dadaism{};
+        for (auto i = 0u; i < n;) {
+            auto s = d.next();
+            try {
+                q = q.push(i * 7919u % n);
+                ++i;
+            } catch (dada_error) {}
+            CHECK(q.size() == i);
+        }
+        CHECK(d.happenings > 0);
+        CHECK(values(q) == expected);
+        IMMER_TRACE_E(d.happenings);
+    }
+
+    SECTION("pop")
+    {
+        auto q = dadaist_queue_t{};
+        for (auto i = 0u; i < n; ++i)
+            q = std::move(q).push(i * 7919u % n);
+        auto d = dadaism{};
+        for (auto i = 0u; i < n;) {
+            auto s = d.next();
+            try {
+                q = q.pop();
+                ++i;
+            } catch (dada_error) {}
+            CHECK(q.size() == n - i);
+        }
+        CHECK(d.happenings > 0);
+        IMMER_TRACE_E(d.happenings);
+    }
+
+    SECTION("merge")
+    {
+        auto a = dadaist_queue_t{};
+        auto b = dadaist_queue_t{};
+        for (auto i = 0u; i < n; ++i)
+            (i % 2 ? a : b) = (i % 2 ? a : b).push(i);
+        auto d = dadaism{};
+        auto r = dadaist_queue_t{};
+        for (auto done = false; !done;) {
+            auto s = d.next();
+            try {
+                r    = a.merge(b);
+                done = true;
+            } catch (dada_error) {}
+        }
+        CHECK(values(r) == expected);
+        CHECK(a.size() + b.size() == n);
+    }
+}
@@ -0,0 +1,138 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#define IMMER_ENABLE_PROBES 1
+
+#include <immer/array.hpp>
+#include <immer/flex_vector.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <immer/probe.hpp>
+#include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
+
+#include <catch.hpp>
+
+#include <string>
+
+namespace {
+
+struct probe_delta
+{
+    immer::probe_counts before = immer::get_probe_counts();
+
+    std::size_t operator[](immer::probe_event ev) const
+    {
+        auto i = static_cast<std::size_t>(ev);
+        return immer::get_probe_counts()[i] - before[i];
+    }
+};
+
+using ev = immer::probe_event;
+
+} // namespace
+
+TEST_CASE("vector push back")
+{
+    auto v = immer::vector<int>{};
+    for (auto i = 0; i < 100; ++i)
+        v = v.push_back(i);
+
+    SECTION("persistent update copies the path")
+    {
+        auto d = probe_delta{};
+        auto w = v.set(0, 42);
+        CHECK(d[ev::node_copy] > 0);
+        CHECK(d[ev::mutate_in_place] == 0);
+        CHECK(w[0] == 42);
+    }
+
+    SECTION("r-value update of a unique vector mutates in place")
+    {
+        auto d = probe_delta{};
+        v      = std::move(v).set(0, 42);
+        CHECK(d[ev::node_copy] == 0);
+        CHECK(d[ev::mutate_in_place] > 0);
+        CHECK(d[ev::mutate_denied] == 0);
+    }
+
+    SECTION("r-value update of a shared vector can not mutate")
+    {
+        auto copy = v;
+        auto d    = probe_delta{};
+        auto w    = std::move(v).set(0, 42);
+        CHECK(d[ev::mutate_denied] > 0);
+        CHECK(d[ev::node_copy] > 0);
+        CHECK(copy[0] == 0);
+        CHECK(w[0] == 42);
+    }
+
+    SECTION("transient reuses its own nodes")
+    {
+        auto t = v.transient();
+        t.set(0, 1);
+        auto d = probe_delta{};
+        t.set(1, 2);
+        CHECK(d[ev::node_copy] == 0);
+        CHECK(d[ev::leaf_alloc] == 0);
+        CHECK(d[ev::mutate_in_place] > 0);
+    }
+}
+
+TEST_CASE("flex vector allocates relaxed nodes")
+{
+    auto v = immer::flex_vector<int>{};
+    for (auto i = 0; i < 100; ++i)
+        v = v.push_back(i);
+    auto d = probe_delta{};
+    auto w = v.push_front(-1);
+    CHECK(d[ev::relaxed_alloc] > 0);
+    CHECK(w.size() == 101);
+}
+
+TEST_CASE("map")
+{
+    auto m = immer::map<int, int>{};
+    auto d = probe_delta{};
+    for (auto i = 0; i < 100; ++i)
+        m = m.set(i, i);
+    CHECK(d[ev::inner_alloc] > 0);
+    CHECK(d[ev::values_alloc] > 0);
+    CHECK(d[ev::node_copy] > 0);
+
+    auto d2 = probe_delta{};
+    auto t  = m.transient();
+    t.set(0, 1);
+    t.set(0, 2);
+    CHECK(d2[ev::mutate_in_place] > 0);
+}
+
+TEST_CASE("array")
+{
+    auto a = immer::array<int>{1, 2, 3};
+    auto d = probe_delta{};
+    auto b = a.set(0, 42);
+    CHECK(d[ev::node_copy] == 1);
+    CHECK(b[0] == 42);
+}
+
+TEST_CASE("handler")
+{
+    auto count   = std::size_t{};
+    auto handler = [](immer::probe_event e, void* ctx) {
+        if (e == immer::probe_event::leaf_alloc)
+            ++*static_cast<std::size_t*>(ctx);
+    };
+    immer::set_probe_handler(handler, &count);
+    auto v = immer::vector<int>{}.push_back(1);
+    immer::set_probe_handler(nullptr);
+    v = v.push_back(2);
+    CHECK(count == 1);
+    CHECK(std::string{immer::to_string(immer::probe_event::node_copy)} ==
+          "node_copy");
+}
@@ -0,0 +1,22 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+// Small nodes, such that trees get deep and nodes are split and merged
+// often, with the invariants of the tree checked after every update.
+#define IMMER_DEBUG_DEEP_CHECK 1
+
+#include <immer/sorted_map.hpp>
+
+template <typename K,
+          typename T,
+          typename Compare = std::less<K>,
+          typename MP      = immer::default_memory_policy>
+using test_map_t = immer::sorted_map<K, T, Compare, MP, 2u, 1u>;
+
+#define MAP_T test_map_t
+#include "generic.ipp"
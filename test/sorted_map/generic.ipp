@@ -0,0 +1,396 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#ifndef MAP_T
+#error "define the map template to use in MAP_T"
+#include <immer/sorted_map.hpp>
+#define MAP_T ::immer::sorted_map
+#endif
+
+#include <immer/sorted_map_transient.hpp>
+#include <immer/algorithm.hpp>
+#include <immer/views.hpp>
+
+#include "test/dada.hpp"
+#include "test/util.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+template <typename T = unsigned>
+auto make_generator()
+{
+    auto engine = std::default_random_engine{42};
+    auto dist   = std::uniform_int_distribution<T>{};
+    return std::bind(dist, engine);
+}
+
+auto make_test_map(unsigned n)
+{
+    auto s = MAP_T<unsigned, unsigned>{};
+    for (auto i = 0u; i < n; ++i)
+        s = std::move(s).insert({i, i});
+    return s;
+}
+
+template <typename Map, typename StdMap>
+void check_same(const Map& m, const StdMap& expected)
+{
+    REQUIRE(m.size() == expected.size());
+    CHECK(std::equal(m.begin(),
+                     m.end(),
+                     expected.begin(),
+                     expected.end(),
+                     [](auto&& a, auto&& b) {
+                         return a.first == b.first && a.second == b.second;
+                     }));
+}
+
+TEST_CASE("instantiation")
+{
+    SECTION("default")
+    {
+        auto v = MAP_T<int, int>{};
+        CHECK(v.size() == 0u);
+        CHECK(v.empty());
+        CHECK(v.begin() == v.end());
+    }
+}
+
+TEST_CASE("basic insertion")
+{
+    auto v1 = MAP_T<int, int>{};
+    CHECK(v1.count(42) == 0);
+
+    auto v2 = v1.insert({42, {}});
+    CHECK(v1.count(42) == 0);
+    CHECK(v2.count(42) == 1);
+
+    auto v3 = v2.insert({42, {}});
+    CHECK(v1.count(42) == 0);
+    CHECK(v2.count(42) == 1);
+    CHECK(v3.count(42) == 1);
+    CHECK(v3.size() == 1);
+}
+
+TEST_CASE("initializer list and range constructors")
+{
+    auto v0 = std::map<std::string, int>{
+        {{"foo", 42}, {"bar", 13}, {"baz", 18}, {"zab", 64}}};
+    auto v1 = MAP_T<std::string, int>{
+        {{"foo", 42}, {"bar", 13}, {"baz", 18}, {"zab", 64}}};
+    auto v2 = MAP_T<std::string, int>{v0.begin(), v0.end()};
+    CHECK(v1.size() == 4);
+    CHECK(v1.count(std::string{"foo"}) == 1);
+    CHECK(v1.at(std::string{"bar"}) == 13);
+    CHECK(v1 == v2);
+    CHECK(v1.begin()->first == "bar");
+}
+
+TEST_CASE("accessor")
+{
+    const auto n = 666u;
+    auto v       = make_test_map(n);
+    CHECK(v[0] == 0);
+    CHECK(v[42] == 42);
+    CHECK(v[665] == 665);
+    CHECK(v[666] == 0);
+    CHECK(v[1234] == 0);
+    CHECK(v.at(42) == 42);
+    CHECK_THROWS_AS(v.at(666), std::out_of_range);
+    CHECK(*v.find(665) == 665);
+    CHECK(v.find(666) == nullptr);
+}
+
+TEST_CASE("iterates in order")
+{
+    auto gen      = make_generator();
+    auto expected = std::map<unsigned, unsigned>{};
+    auto v        = MAP_T<unsigned, unsigned>{};
+    for (auto i = 0u; i < 5000u; ++i) {
+        auto k = gen() % 10000u;
+        expected[k] = i;
+        v           = v.set(k, i);
+    }
+    check_same(v, expected);
+
+    SECTION("backwards")
+    {
+        CHECK(std::equal(v.rbegin(),
+                         v.rend(),
+                         expected.rbegin(),
+                         expected.rend(),
+                         [](auto&& a, auto&& b) {
+                             return a.first == b.first &&
+                                    a.second == b.second;
+                         }));
+    }
+
+    SECTION("chunks")
+    {
+        auto count = std::size_t{};
+        auto prev  = 0u;
+        immer::for_each_chunk(v, [&](auto first, auto last) {
+            for (; first != last; ++first, ++count) {
+                CHECK((count == 0 || prev < first->first));
+                prev = first->first;
+            }
+        });
+        CHECK(count == expected.size());
+    }
+
+    SECTION("views")
+    {
+        auto evens =
+            immer::views::filter(
+                v, [](const std::pair<unsigned, unsigned>& x) {
+                    return x.first % 2 == 0;
+                })
+                .into<MAP_T<unsigned, unsigned>>();
+        auto expected_evens = expected;
+        for (auto it = expected_evens.begin(); it != expected_evens.end();)
+            it = it->first % 2 ? expected_evens.erase(it) : std::next(it);
+        check_same(evens, expected_evens);
+    }
+}
+
+TEST_CASE("lower and upper bound")
+{
+    auto v = MAP_T<unsigned, unsigned>{};
+    for (auto i = 0u; i < 1000u; ++i)
+        v = v.set(i * 2, i);
+
+    CHECK(v.lower_bound(0) == v.begin());
+    CHECK(v.lower_bound(1998)->first == 1998);
+    CHECK(v.lower_bound(1999) == v.end());
+    CHECK(v.upper_bound(1998) == v.end());
+
+    for (auto k = 0u; k < 1999u; ++k) {
+        auto lo = v.lower_bound(k);
+        auto hi = v.upper_bound(k);
+        REQUIRE(lo != v.end());
+        CHECK(lo->first == (k + 1) / 2 * 2);
+        CHECK(std::distance(lo, hi) == (k % 2 ? 0 : 1));
+        if (k > 0)
+            CHECK(std::prev(lo)->first == (k - 1) / 2 * 2);
+    }
+
+    SECTION("range scan")
+    {
+        auto first = v.lower_bound(100);
+        auto last  = v.lower_bound(200);
+        auto sum   = std::accumulate(
+            first, last, 0u, [](auto acc, auto&& x) { return acc + x.second; });
+        CHECK(sum == (50u + 99u) * 50u / 2);
+    }
+}
+
+TEST_CASE("update and erase a lot")
+{
+    auto gen      = make_generator();
+    auto expected = std::map<unsigned, unsigned>{};
+    auto v        = MAP_T<unsigned, unsigned>{};
+    auto history  = std::vector<
+        std::pair<MAP_T<unsigned, unsigned>, std::map<unsigned, unsigned>>>{};
+
+    for (auto i = 0u; i < 3000u; ++i) {
+        auto k = gen() % 2000u;
+        switch (gen() % 3) {
+        case 0:
+            expected.erase(k);
+            v = v.erase(k);
+            break;
+        case 1:
+            expected[k] += 1;
+            v = v.update(k, [](auto x) { return x + 1; });
+            break;
+        default:
+            expected[k] = i;
+            v           = std::move(v).set(k, i);
+            break;
+        }
+        if (i % 100 == 0)
+            history.emplace_back(v, expected);
+    }
+    check_same(v, expected);
+
+    for (auto&& h : history)
+        check_same(h.first, h.second);
+
+    SECTION("until it is empty")
+    {
+        auto keys = std::vector<unsigned>{};
+        for (auto&& x : expected)
+            keys.push_back(x.first);
+        std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+        for (auto k : keys) {
+            auto old = v;
+            v        = v.erase(k);
+            CHECK(old.count(k) == 1);
+            CHECK(v.count(k) == 0);
+            CHECK(v.size() == old.size() - 1);
+        }
+        CHECK(v.empty());
+        CHECK(v == MAP_T<unsigned, unsigned>{});
+    }
+}
+
+TEST_CASE("equals and setting")
+{
+    const auto n = 666u;
+    auto v       = make_test_map(n);
+
+    CHECK(v == v);
+    CHECK(v != v.insert({1234, 42}));
+    CHECK(v != v.erase(32));
+    CHECK(v == v.insert({1234, 42}).erase(1234));
+    CHECK(v == v.erase(32).insert({32, 32}));
+
+    CHECK(v.set(1234, 42) == v.insert({1234, 42}));
+    CHECK(v.update(1234, [](auto&& x) { return x + 42; }) ==
+          v.set(1234, 42));
+    CHECK(v.update(12, [](auto&& x) { return x + 42; }) == v.set(12, 54));
+    CHECK(v.set(12, 13) != v);
+}
+
+TEST_CASE("erase missing key returns the same map")
+{
+    auto v = make_test_map(100);
+    auto w = v.erase(1000);
+    CHECK(w.impl().root == v.impl().root);
+}
+
+TEST_CASE("diff")
+{
+    auto gen = make_generator();
+    auto v   = make_test_map(2000);
+    auto w   = v;
+    auto ew  = std::map<unsigned, unsigned>{};
+    for (auto i = 0u; i < 2000u; ++i)
+        ew[i] = i;
+    for (auto i = 0u; i < 100u; ++i) {
+        auto k = gen() % 4000u;
+        if (gen() % 2) {
+            ew.erase(k);
+            w = w.erase(k);
+        } else {
+            ew[k] = k + 1;
+            w     = w.set(k, k + 1);
+        }
+    }
+
+    auto added   = std::set<unsigned>{};
+    auto removed = std::set<unsigned>{};
+    auto changed = std::set<unsigned>{};
+    for (auto i = 0u; i < 4000u; ++i) {
+        auto it = ew.find(i);
+        if (i < 2000u && it == ew.end())
+            removed.insert(i);
+        else if (i >= 2000u && it != ew.end())
+            added.insert(i);
+        else if (i < 2000u && it->second != i)
+            changed.insert(i);
+    }
+
+    immer::diff(
+        v,
+        w,
+        [&](auto&& x) { CHECK(added.erase(x.first) == 1); },
+        [&](auto&& x) { CHECK(removed.erase(x.first) == 1); },
+        [&](auto&& x, auto&& y) {
+            CHECK(x.first == y.first);
+            CHECK(y.second == x.second + 1);
+            CHECK(changed.erase(x.first) == 1);
+        });
+    CHECK(added.empty());
+    CHECK(removed.empty());
+    CHECK(changed.empty());
+
+    SECTION("identical maps")
+    {
+        auto calls = 0;
+        immer::diff(
+            v, v, [&](auto&&) { ++calls; }, [&](auto&&) { ++calls; });
+        CHECK(calls == 0);
+    }
+}
+
+TEST_CASE("exception safety")
+{
+    constexpr auto n = 2666u;
+
+    using dadaist_map_t =
+        MAP_T<unsigned,
+              dadaist<unsigned>,
+              std::less<unsigned>,
+              dadaist_memory_policy<immer::default_memory_policy>>;
+
+    SECTION("update")
+    {
+        auto v = dadaist_map_t{};
+        auto d = dadaism{};
+        for (auto i = 0u; i < n; ++i)
+            v = std::move(v).set(i, i);
+        for (auto i = 0u; i < v.size();) {
+            try {
+                auto s = d.next();
+                v      = v.update(i, [](auto x) { return x + 1; });
+                ++i;
+            } catch (dada_error) {}
+            for (auto i : test_irange(0u, i))
+                CHECK(v.at(i) == i + 1);
+            for (auto i : test_irange(i, n))
+                CHECK(v.at(i) == i);
+        }
+        CHECK(d.happenings > 0);
+        IMMER_TRACE_E(d.happenings);
+    }
+
+    SECTION("insert")
+    {
+        auto v = dadaist_map_t{};
+        auto d = dadaism{};
+        for (auto i = 0u; i < n;) {
+            try {
+                auto s = d.next();
+                v      = v.set(i * 7919u % n, i);
+                ++i;
+            } catch (dada_error) {}
+            CHECK(v.size() == i);
+        }
+        for (auto i : test_irange(0u, n))
+            CHECK(v.at(i * 7919u % n) == i);
+        CHECK(d.happenings > 0);
+        IMMER_TRACE_E(d.happenings);
+    }
+
+    SECTION("erase")
+    {
+        auto v = dadaist_map_t{};
+        auto d = dadaism{};
+        for (auto i = 0u; i < n; ++i)
+            v = std::move(v).set(i, i);
+        for (auto i = 0u; i < n;) {
+            try {
+                auto s = d.next();
+                v      = v.erase(i * 7919u % n);
+                ++i;
+            } catch (dada_error) {}
+            CHECK(v.size() == n - i);
+        }
+        CHECK(d.happenings > 0);
+        IMMER_TRACE_E(d.happenings);
+    }
+}
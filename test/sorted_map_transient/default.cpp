@@ -0,0 +1,87 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/sorted_map.hpp>
+#include <immer/sorted_map_transient.hpp>
+
+#include <catch.hpp>
+
+#include <map>
+#include <numeric>
+#include <string>
+
+TEST_CASE("instantiate")
+{
+    auto t = immer::sorted_map_transient<std::string, int>{};
+    auto m = immer::sorted_map<std::string, int>{};
+    CHECK(t.persistent() == m);
+    CHECK(t.persistent() == m.transient().persistent());
+}
+
+TEST_CASE("access")
+{
+    auto m = immer::sorted_map<std::string, int>{{"foo", 12}, {"bar", 42}};
+    auto t = m.transient();
+    CHECK(t.size() == 2);
+    CHECK(t.count("foo") == 1);
+    CHECK(t["foo"] == 12);
+    CHECK(t.at("foo") == 12);
+    CHECK(t.find("foo") == m.find("foo"));
+    CHECK(t.begin()->first == "bar");
+    CHECK(std::accumulate(t.begin(), t.end(), 0, [](auto acc, auto&& x) {
+              return acc + x.second;
+          }) == 54);
+}
+
+TEST_CASE("insert and erase")
+{
+    auto expected = std::map<unsigned, unsigned>{};
+    auto t        = immer::sorted_map_transient<unsigned, unsigned>{};
+    for (auto i = 0u; i < 1000u; ++i) {
+        auto k = i * 7919u % 1000u;
+        expected[k] = i;
+        t.set(k, i);
+    }
+    auto p = t.persistent();
+    for (auto i = 0u; i < 1000u; i += 3) {
+        expected.erase(i);
+        t.erase(i);
+    }
+    for (auto i = 0u; i < 1000u; i += 5) {
+        expected[i] += 1;
+        t.update(i, [](auto x) { return x + 1; });
+    }
+    CHECK(p.size() == 1000u);
+    CHECK(t.size() == expected.size());
+    CHECK(std::equal(t.begin(),
+                     t.end(),
+                     expected.begin(),
+                     expected.end(),
+                     [](auto&& a, auto&& b) {
+                         return a.first == b.first && a.second == b.second;
+                     }));
+    CHECK(t.persistent() != p);
+}
+
+TEST_CASE("does not change the persistent map")
+{
+    auto m = immer::sorted_map<unsigned, unsigned>{};
+    for (auto i = 0u; i < 500u; ++i)
+        m = m.set(i, i);
+    auto t = m.transient();
+    for (auto i = 0u; i < 500u; ++i)
+        t.update(i, [](auto x) { return x * 2; });
+    for (auto i = 0u; i < 500u; i += 2)
+        t.erase(i);
+    CHECK(m.size() == 500u);
+    for (auto i = 0u; i < 500u; ++i)
+        CHECK(m[i] == i);
+    CHECK(t.size() == 250u);
+    for (auto i = 1u; i < 500u; i += 2)
+        CHECK(t[i] == i * 2);
+}
@@ -0,0 +1,100 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/algorithm.hpp>
+#include <immer/sorted_set.hpp>
+#include <immer/sorted_set_transient.hpp>
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+
+TEST_CASE("instantiation")
+{
+    auto v = immer::sorted_set<int>{};
+    CHECK(v.size() == 0u);
+    CHECK(v.begin() == v.end());
+}
+
+TEST_CASE("initializer list and range constructors")
+{
+    auto v0 = std::set<std::string>{"foo", "bar", "baz"};
+    auto v1 = immer::sorted_set<std::string>{"foo", "bar", "baz", "bar"};
+    auto v2 = immer::sorted_set<std::string>{v0.begin(), v0.end()};
+    CHECK(v1.size() == 3);
+    CHECK(v1 == v2);
+    CHECK(std::equal(v1.begin(), v1.end(), v0.begin(), v0.end()));
+}
+
+TEST_CASE("insert and erase")
+{
+    auto engine   = std::default_random_engine{42};
+    auto expected = std::set<unsigned>{};
+    auto v        = immer::sorted_set<unsigned>{};
+    for (auto i = 0u; i < 5000u; ++i) {
+        auto x = engine() % 3000u;
+        if (engine() % 3) {
+            expected.insert(x);
+            v = v.insert(x);
+        } else {
+            expected.erase(x);
+            v = v.erase(x);
+        }
+    }
+    CHECK(v.size() == expected.size());
+    CHECK(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    CHECK(std::equal(v.rbegin(), v.rend(), expected.rbegin(), expected.rend()));
+    CHECK(v.insert(*v.begin()).impl().root == v.impl().root);
+}
+
+TEST_CASE("custom order and bounds")
+{
+    auto v = immer::sorted_set<int, std::greater<int>>{};
+    for (auto i = 0; i < 100; ++i)
+        v = std::move(v).insert(i * 10);
+    CHECK(*v.begin() == 990);
+    CHECK(*v.lower_bound(55) == 50);
+    CHECK(*v.upper_bound(50) == 40);
+    CHECK(v.lower_bound(-1) == v.end());
+    CHECK(v.find(30) != nullptr);
+    CHECK(v.count(31) == 0);
+}
+
+TEST_CASE("transient")
+{
+    auto v = immer::sorted_set<int>{1, 2, 3};
+    auto t = v.transient();
+    t.insert(0);
+    t.insert(2);
+    t.erase(3);
+    CHECK(t.size() == 3);
+    CHECK(t.persistent() == immer::sorted_set<int>{0, 1, 2});
+    CHECK(v == immer::sorted_set<int>{1, 2, 3});
+}
+
+TEST_CASE("diff")
+{
+    auto a = immer::sorted_set<int>{};
+    for (auto i = 0; i < 1000; ++i)
+        a = a.insert(i);
+    auto b = a.erase(10).erase(500).insert(1000).insert(-1);
+
+    auto added   = std::set<int>{};
+    auto removed = std::set<int>{};
+    immer::diff(
+        a,
+        b,
+        [&](int x) { added.insert(x); },
+        [&](int x) { removed.insert(x); });
+    CHECK(added == std::set<int>{-1, 1000});
+    CHECK(removed == std::set<int>{10, 500});
+}
@@ -0,0 +1,87 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/box.hpp>
+#include <immer/map.hpp>
+#include <immer/update_in.hpp>
+#include <immer/vector.hpp>
+
+#include <catch.hpp>
+
+#include <string>
+
+namespace {
+
+using items_t = immer::vector<int>;
+using store_t = immer::map<std::string, immer::box<items_t>>;
+
+auto inc = [](int x) { return x + 1; };
+
+store_t make_store()
+{
+    auto s = store_t{};
+    s      = s.set("a", items_t{1, 2, 3});
+    s      = s.set("b", items_t{4, 5, 6});
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("update in")
+{
+    auto s = make_store();
+
+    SECTION("single level")
+    {
+        auto v = immer::update_in(items_t{1, 2, 3}, 1, inc);
+        CHECK(v == items_t{1, 3, 3});
+    }
+
+    SECTION("nested levels through a box")
+    {
+        auto r = immer::update_in(s, "a", 2, inc);
+        CHECK(r["a"].get() == items_t{1, 2, 4});
+        CHECK(r["b"].get() == items_t{4, 5, 6});
+    }
+
+    SECTION("the function can take the box")
+    {
+        auto r = immer::update_in(s, "b", [](immer::box<items_t> b) {
+            return b.update([](items_t v) { return v.push_back(7); });
+        });
+        CHECK(r["b"]->size() == 4u);
+    }
+
+    SECTION("shared levels are copied")
+    {
+        auto copy = s;
+        auto r    = immer::update_in(std::move(s), "a", 0, inc);
+        CHECK(copy["a"].get() == items_t{1, 2, 3});
+        CHECK(r["a"].get() == items_t{2, 2, 3});
+        CHECK(&copy["b"].get() == &r["b"].get());
+    }
+
+    SECTION("unique levels are updated in place")
+    {
+        auto box_addr  = &s["a"].get();
+        auto elem_addr = &s["a"].get()[0];
+        s              = immer::update_in(std::move(s), "a", 0, inc);
+        CHECK(&s["a"].get() == box_addr);
+        CHECK(&s["a"].get()[0] == elem_addr);
+        CHECK(s["a"].get() == items_t{2, 2, 3});
+    }
+
+    SECTION("missing keys are default constructed")
+    {
+        auto r = immer::update_in(s, "c", [](immer::box<items_t> b) {
+            return b.update([](items_t v) { return v.push_back(1); });
+        });
+        CHECK(r["c"].get() == items_t{1});
+        CHECK(r.size() == 3u);
+    }
+}
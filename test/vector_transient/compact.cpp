@@ -0,0 +1,28 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/memory_policy.hpp>
+#include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
+
+using compact_memory =
+    immer::memory_policy<immer::default_heap_policy,
+                         immer::compact_refcount_policy,
+                         immer::default_lock_policy>;
+
+template <typename T>
+using test_vector_t = immer::vector<T, compact_memory, 3u>;
+
+template <typename T>
+using test_vector_transient_t =
+    immer::vector_transient<T, compact_memory, 3u>;
+
+#define VECTOR_T test_vector_t
+#define VECTOR_TRANSIENT_T test_vector_transient_t
+
+#include "generic.ipp"
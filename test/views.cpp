@@ -0,0 +1,137 @@
+//
+// immer: immutable data structures for C++
+// Copyright (C) 2016, 2017, 2018 Juan Pedro Bolivar Puente
+//
+// This software is distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt
+//
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+#include <immer/flex_vector.hpp>
+#include <immer/flex_vector_transient.hpp>
+#include <immer/map.hpp>
+#include <immer/map_transient.hpp>
+#include <immer/set.hpp>
+#include <immer/set_transient.hpp>
+#include <immer/vector.hpp>
+#include <immer/vector_transient.hpp>
+#include <immer/views.hpp>
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+immer::flex_vector<int> make_range(int n)
+{
+    auto t = immer::flex_vector<int>{}.transient();
+    for (auto i = 0; i < n; ++i)
+        t.push_back(i);
+    return t.persistent();
+}
+
+} // namespace
+
+TEST_CASE("filter and transform")
+{
+    auto v = make_range(1000);
+    auto r = immer::views::filter(v, [](int x) { return x % 3 == 0; })
+                 .transform([](int x) { return x * 2; })
+                 .into<immer::vector<int>>();
+
+    auto expected = std::vector<int>{};
+    for (auto i = 0; i < 1000; i += 3)
+        expected.push_back(i * 2);
+    CHECK(r == immer::vector<int>(expected.begin(), expected.end()));
+}
+
+TEST_CASE("transform changes the type")
+{
+    auto v = immer::vector<int>{1, 2, 3};
+    auto r = immer::views::transform(v, [](int x) { return std::to_string(x); })
+                 .into<immer::flex_vector<std::string>>();
+    CHECK(r == immer::flex_vector<std::string>{"1", "2", "3"});
+}
+
+TEST_CASE("take while stops early")
+{
+    auto v     = make_range(100000);
+    auto calls = 0;
+    auto r     = immer::views::take_while(v,
+                                      [&](int x) {
+                                          ++calls;
+                                          return x < 10;
+                                      })
+                 .into<immer::array<int>>();
+    CHECK(r.size() == 10);
+    CHECK(r[9] == 9);
+    CHECK(calls == 11);
+
+    SECTION("after a filter")
+    {
+        auto r2 = immer::views::filter(v, [](int x) { return x % 2; })
+                      .take_while([](int x) { return x < 10; })
+                      .into<immer::vector<int>>();
+        CHECK(r2 == immer::vector<int>{1, 3, 5, 7, 9});
+    }
+}
+
+TEST_CASE("for each")
+{
+    auto v         = make_range(100);
+    auto sum       = 0;
+    auto view      = immer::views::filter(v, [](int x) { return x < 50; });
+    auto completed = view.for_each_p([&](int x) {
+        sum += x;
+        return true;
+    });
+    CHECK(completed);
+    CHECK(sum == 49 * 50 / 2);
+
+    auto stopped = immer::views::transform(v, [](int x) { return x; })
+                       .for_each_p([](int x) { return x < 5; });
+    CHECK(!stopped);
+}
+
+TEST_CASE("into associative containers")
+{
+    auto v = make_range(100);
+
+    SECTION("set")
+    {
+        auto s = immer::views::transform(v, [](int x) { return x % 10; })
+                     .into<immer::set<int>>();
+        CHECK(s.size() == 10);
+        CHECK(s.count(3));
+    }
+
+    SECTION("map")
+    {
+        auto m = immer::views::transform(
+                     v, [](int x) { return std::make_pair(x, x * x); })
+                     .into<immer::map<int, int>>();
+        CHECK(m.size() == 100);
+        CHECK(m[9] == 81);
+    }
+
+    SECTION("from a map")
+    {
+        using kv_t = std::pair<const int, int>;
+        auto m     = immer::map<int, int>{}.set(1, 10).set(2, 20).set(3, 30);
+        auto s = immer::views::filter(
+                     m, [](const kv_t& kv) { return kv.first != 2; })
+                     .transform([](const kv_t& kv) { return kv.second; })
+                     .into<immer::set<int>>();
+        CHECK(s == immer::set<int>{}.insert(10).insert(30));
+    }
+}
+
+TEST_CASE("into without stages")
+{
+    auto v = make_range(10);
+    CHECK(immer::views::into<immer::vector<int>>(v) ==
+          immer::vector<int>(v.begin(), v.end()));
+}